@@ -0,0 +1,41 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<std::size_t> allocations{0};
+
+}
+
+std::size_t allocation_count() noexcept
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+/*
+ * replacements of the global allocation functions - array and nothrow
+ * forms of the standard library forward to these ones
+ */
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* const ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept
+{
+	std::free(ptr);
+}
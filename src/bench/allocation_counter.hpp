@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @file counting of heap allocations
+ *
+ * @details The benchmark replaces global operator new and operator delete
+ * so that every allocation made by the program (including the library)
+ * is counted. Counting is thread-safe.
+ */
+
+// number of heap allocations made by the program so far
+std::size_t allocation_count() noexcept;
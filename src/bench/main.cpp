@@ -0,0 +1,259 @@
+#include "allocation_counter.hpp"
+#include "template_generator.hpp"
+
+#include <fs/parser/parser.hpp>
+#include <fs/compiler/resolve_symbols.hpp>
+#include <fs/compiler/build_filter_blocks.hpp>
+#include <fs/compiler/symbol_references.hpp>
+#include <fs/compiler/print_error.hpp>
+#include <fs/compiler/query_cache.hpp>
+#include <fs/generator/generator.hpp>
+#include <fs/log/console_logger.hpp>
+#include <fs/utility/file.hpp>
+#include <fs/version.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <boost/program_options.hpp>
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+
+using namespace fs;
+using clock_type = std::chrono::steady_clock;
+
+struct phase_result
+{
+	const char* name;
+	// what is counted for throughput
+	const char* unit;
+	double amount = 0;
+	std::vector<double> seconds;
+	std::vector<double> allocations;
+};
+
+double median(std::vector<double> values)
+{
+	std::sort(values.begin(), values.end());
+	const std::size_t middle = values.size() / 2;
+	return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+template <typename F>
+auto measure(phase_result& phase, F f)
+{
+	const std::size_t allocations_before = allocation_count();
+	const auto start = clock_type::now();
+	auto result = f();
+	const auto finish = clock_type::now();
+	phase.seconds.push_back(std::chrono::duration<double>(finish - start).count());
+	// includes allocations of the result, but not its deallocation
+	phase.allocations.push_back(static_cast<double>(allocation_count() - allocations_before));
+	return result;
+}
+
+/*
+ * Runs the whole pipeline (each phase consumes results of the previous one)
+ * and records time of each phase. Returns false on any error.
+ */
+bool run_pipeline(
+	const std::string& input,
+	const lang::item_price_data& item_price_data,
+	unsigned num_threads,
+	std::vector<phase_result>& phases,
+	log::logger& logger)
+{
+	phase_result& parse_phase = phases[0];
+	phase_result& resolve_phase = phases[1];
+	phase_result& build_phase = phases[2];
+	phase_result& assemble_phase = phases[3];
+
+	std::variant<parser::parse_success_data, parser::parse_failure_data> parse_result =
+		measure(parse_phase, [&]() { return parser::parse(input); });
+	if (std::holds_alternative<parser::parse_failure_data>(parse_result)) {
+		parser::print_parse_errors(std::get<parser::parse_failure_data>(parse_result), logger);
+		return false;
+	}
+
+	const auto& parse_data = std::get<parser::parse_success_data>(parse_result);
+	parse_phase.amount = static_cast<double>(input.size());
+
+	compiler::symbol_references references;
+	compiler::query_cache queries;
+	std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = measure(resolve_phase, [&]() {
+		return compiler::resolve_symbols(
+			parse_data.ast.definitions, item_price_data, lang::symbol_table{}, references, num_threads, &queries);
+	});
+	if (std::holds_alternative<compiler::compile_error>(symbols_or_error)) {
+		compiler::print_error(std::get<compiler::compile_error>(symbols_or_error), parse_data.lookup_data, logger);
+		return false;
+	}
+
+	resolve_phase.amount = static_cast<double>(parse_data.ast.definitions.size());
+
+	const auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+	std::variant<std::vector<lang::filter_block>, compiler::compile_error> blocks_or_error =
+		measure(build_phase, [&]() {
+			compiler::resolve_references(parse_data.ast.statements, symbols, references);
+			return compiler::build_filter_blocks(
+				parse_data.ast.statements, symbols, references, item_price_data, num_threads, &queries);
+		});
+	if (std::holds_alternative<compiler::compile_error>(blocks_or_error)) {
+		compiler::print_error(std::get<compiler::compile_error>(blocks_or_error), parse_data.lookup_data, logger);
+		return false;
+	}
+
+	const auto& blocks = std::get<std::vector<lang::filter_block>>(blocks_or_error);
+	build_phase.amount = static_cast<double>(blocks.size());
+
+	const std::string filter = measure(assemble_phase, [&]() { return generator::assemble_blocks_to_raw_filter(blocks, num_threads); });
+	assemble_phase.amount = static_cast<double>(filter.size());
+	return true;
+}
+
+nlohmann::json to_json(const template_parameters& params)
+{
+	return nlohmann::json{
+		{"constants", params.constants},
+		{"top_level_blocks", params.top_level_blocks},
+		{"nesting_depth", params.nesting_depth},
+		{"nested_blocks", params.nested_blocks},
+		{"array_size", params.array_size},
+		{"query_density", params.query_density},
+		{"comment_ratio", params.comment_ratio},
+		{"seed", params.seed}
+	};
+}
+
+void print_json(const template_parameters& params, const std::vector<phase_result>& phases)
+{
+	namespace v = version;
+	nlohmann::json json_phases = nlohmann::json::array();
+	for (const phase_result& phase : phases) {
+		const double median_seconds = median(phase.seconds);
+		json_phases.push_back(nlohmann::json{
+			{"name", phase.name},
+			{"unit", phase.unit},
+			{"amount", phase.amount},
+			{"seconds_median", median_seconds},
+			{"seconds_min", *std::min_element(phase.seconds.begin(), phase.seconds.end())},
+			{"throughput_per_second", phase.amount / median_seconds},
+			{"allocations_median", median(phase.allocations)}
+		});
+	}
+
+	const nlohmann::json result = {
+		{"version", std::to_string(v::major) + "." + std::to_string(v::minor) + "." + std::to_string(v::patch)},
+		{"iterations", phases.front().seconds.size()},
+		{"parameters", to_json(params)},
+		{"phases", std::move(json_phases)}
+	};
+	std::cout << result.dump(4) << '\n';
+}
+
+void print_text(const std::vector<phase_result>& phases)
+{
+	std::cout << std::left << std::setw(24) << "phase" << std::right
+		<< std::setw(14) << "median [ms]" << std::setw(14) << "min [ms]" << std::setw(14) << "allocations" << std::setw(22) << "throughput" << '\n';
+
+	for (const phase_result& phase : phases) {
+		const double median_seconds = median(phase.seconds);
+		const double min_seconds = *std::min_element(phase.seconds.begin(), phase.seconds.end());
+		const double throughput = phase.amount / median_seconds;
+
+		std::cout << std::left << std::setw(24) << phase.name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(14) << median_seconds * 1000 << std::setw(14) << min_seconds * 1000
+			<< std::setw(14) << std::setprecision(0) << median(phase.allocations)
+			<< std::setw(14) << std::setprecision(1);
+
+		if (phase.unit == std::string_view("bytes"))
+			std::cout << throughput / 1e6 << " MB/s\n";
+		else
+			std::cout << throughput << ' ' << phase.unit << "/s\n";
+	}
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	log::console_logger logger;
+
+	try {
+		namespace po = boost::program_options;
+
+		template_parameters params;
+		std::size_t items_per_category = 200;
+		unsigned iterations = 5;
+		unsigned num_threads = 1;
+		bool opt_json = false;
+		boost::optional<std::string> template_output_path;
+		bool opt_help = false;
+
+		po::options_description options("filter_spirit_bench - parser and compiler throughput benchmark");
+		options.add_options()
+			("constants",      po::value(&params.constants)->default_value(params.constants),               "number of constant definitions")
+			("blocks",         po::value(&params.top_level_blocks)->default_value(params.top_level_blocks), "number of top-level blocks")
+			("depth",          po::value(&params.nesting_depth)->default_value(params.nesting_depth),       "maximum nesting depth of blocks")
+			("nested",         po::value(&params.nested_blocks)->default_value(params.nested_blocks),       "nested blocks inside each block")
+			("array-size",     po::value(&params.array_size)->default_value(params.array_size),             "elements in string lists")
+			("query-density",  po::value(&params.query_density)->default_value(params.query_density),       "fraction of string lists that are price queries")
+			("comment-ratio",  po::value(&params.comment_ratio)->default_value(params.comment_ratio),       "comment lines per line of code")
+			("seed",           po::value(&params.seed)->default_value(params.seed),                         "seed of the template generator")
+			("items",          po::value(&items_per_category)->default_value(items_per_category),           "synthetic items per price data category")
+			("iterations,i",   po::value(&iterations)->default_value(iterations),                           "number of measured runs")
+			("jobs,j",         po::value(&num_threads)->default_value(num_threads),                         "threads for compilation phases (0 - all hardware threads)")
+			("json",           po::bool_switch(&opt_json),                                                  "print results as JSON")
+			("save-template",  po::value(&template_output_path),                                            "save generated template to specified file")
+			("help,h",         po::bool_switch(&opt_help),                                                  "print this message")
+		;
+
+		po::variables_map vm;
+		po::store(po::parse_command_line(argc, argv, options), vm);
+		po::notify(vm);
+
+		if (opt_help) {
+			std::cout << options;
+			return EXIT_SUCCESS;
+		}
+
+		const std::string input = generate_template(params);
+		const lang::item_price_data item_price_data = generate_item_price_data(items_per_category, params.seed);
+
+		if (template_output_path && !utility::save_file(*template_output_path, input, logger))
+			return EXIT_FAILURE;
+
+		std::vector<phase_result> phases = {
+			{"parse", "bytes", 0, {}, {}},
+			{"resolve_symbols", "definitions", 0, {}, {}},
+			{"build_filter_blocks", "blocks", 0, {}, {}},
+			{"assemble_raw_filter", "bytes", 0, {}, {}}
+		};
+
+		for (unsigned i = 0; i < std::max(iterations, 1u); ++i)
+			if (!run_pipeline(input, item_price_data, num_threads, phases, logger))
+				return EXIT_FAILURE;
+
+		if (opt_json)
+			print_json(params, phases);
+		else
+			print_text(phases);
+	}
+	catch (const std::exception& e) {
+		logger.error() << e.what();
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,345 @@
+#include "template_generator.hpp"
+
+#include <fs/lang/queries.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <utility>
+
+namespace
+{
+
+namespace lang = fs::lang;
+
+// splitmix64 - unlike standard distributions its results do not depend on the implementation
+class random_engine
+{
+public:
+	explicit random_engine(std::uint64_t seed)
+	: state(seed)
+	{
+	}
+
+	std::uint64_t next() noexcept
+	{
+		std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	// random number in [0, n)
+	std::size_t below(std::size_t n) noexcept
+	{
+		return static_cast<std::size_t>(next() % n);
+	}
+
+	// random number in [min, max]
+	int between(int min, int max) noexcept
+	{
+		return min + static_cast<int>(below(static_cast<std::size_t>(max - min + 1)));
+	}
+
+	bool chance(double probability) noexcept
+	{
+		return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+	}
+
+private:
+	std::uint64_t state;
+};
+
+constexpr std::array<const char*, 10> name_prefixes = {
+	"Leather", "Iron", "Sapphire", "Ruby", "Gold", "Coral", "Amethyst", "Jade", "Onyx", "Vaal"
+};
+
+constexpr std::array<const char*, 10> name_suffixes = {
+	"Belt", "Ring", "Amulet", "Sword", "Axe", "Gloves", "Boots", "Helmet", "Flask", "Orb"
+};
+
+constexpr std::array<const char*, 8> query_names = {
+	lang::queries::divination,
+	lang::queries::essences,
+	lang::queries::fossils,
+	lang::queries::prophecies,
+	lang::queries::resonators,
+	lang::queries::scarabs,
+	lang::queries::incubators,
+	lang::queries::oils
+};
+
+// every nesting level uses a different condition, otherwise nested blocks would redefine them
+constexpr std::array<const char*, 9> range_conditions = {
+	"ItemLevel >=", "Quality >", "DropLevel <", "Height <=", "Width <=",
+	"StackSize >=", "GemLevel >=", "Sockets >=", "LinkedSockets >="
+};
+
+// level 0 uses Class, level 1 BaseType, next levels use range conditions
+constexpr std::size_t max_nesting_depth = range_conditions.size() + 1;
+
+std::string item_name(random_engine& rng)
+{
+	std::string result = name_prefixes[rng.below(name_prefixes.size())];
+	result += ' ';
+	result += name_suffixes[rng.below(name_suffixes.size())];
+	result += ' ';
+	result += std::to_string(rng.below(1000));
+	return result;
+}
+
+class template_writer
+{
+public:
+	explicit template_writer(const template_parameters& params)
+	: params(params), rng(params.seed)
+	{
+	}
+
+	std::string generate() &&
+	{
+		output += "# synthetic filter template - generated for benchmarking\n";
+
+		for (std::size_t i = 0; i < params.constants; ++i)
+			write_constant(i);
+
+		for (std::size_t i = 0; i < params.top_level_blocks; ++i)
+			write_block(0);
+
+		return std::move(output);
+	}
+
+private:
+	void end_line()
+	{
+		output += '\n';
+
+		double comments = params.comment_ratio;
+		for (; comments >= 1.0; comments -= 1.0)
+			write_comment();
+
+		if (rng.chance(comments))
+			write_comment();
+	}
+
+	void write_comment()
+	{
+		// braces and quotes in comments must be ignored by anything that scans the input
+		output += "# comment ";
+		output += std::to_string(rng.below(100000));
+		output += " with { braces } and \"quotes\n";
+	}
+
+	void indent(std::size_t depth)
+	{
+		output.append(depth, '\t');
+	}
+
+	void write_string_list()
+	{
+		output += '[';
+		for (std::size_t i = 0; i < params.array_size; ++i) {
+			if (i != 0)
+				output += ", ";
+
+			output += '"';
+			output += item_name(rng);
+			output += '"';
+		}
+		output += ']';
+	}
+
+	void write_query()
+	{
+		output += '$';
+		output += query_names[rng.below(query_names.size())];
+		output += '(';
+		const int min = rng.between(0, 500);
+		output += std::to_string(min);
+		output += ", ";
+		if (rng.chance(0.5))
+			output += '_';
+		else
+			output += std::to_string(min + rng.between(1, 500));
+		output += ')';
+	}
+
+	void write_color()
+	{
+		output += "RGB(";
+		output += std::to_string(rng.between(0, 255));
+		output += ", ";
+		output += std::to_string(rng.between(0, 255));
+		output += ", ";
+		output += std::to_string(rng.between(0, 255));
+		output += ')';
+	}
+
+	// reference to an existing constant of given kind or a literal if there is none
+	template <typename WriteLiteral>
+	void write_value(const std::vector<std::string>& constants, WriteLiteral write_literal)
+	{
+		if (!constants.empty() && rng.chance(0.75))
+			output += constants[rng.below(constants.size())];
+		else
+			write_literal();
+	}
+
+	void write_integer() { write_value(integers, [&]() { output += std::to_string(rng.between(18, 45)); }); }
+	void write_color_value() { write_value(colors, [&]() { write_color(); }); }
+	void write_strings() { write_value(string_lists, [&]() { write_string_list(); }); }
+
+	void write_action(std::size_t depth)
+	{
+		indent(depth);
+
+		switch (rng.below(5)) {
+			case 0:
+				output += "SetTextColor ";
+				write_color_value();
+				break;
+			case 1:
+				output += "SetBorderColor ";
+				write_color_value();
+				break;
+			case 2:
+				output += "SetBackgroundColor ";
+				write_color_value();
+				break;
+			case 3:
+				output += "SetFontSize ";
+				write_integer();
+				break;
+			default:
+				if (action_sets.empty()) {
+					output += "SetFontSize ";
+					write_integer();
+				}
+				else {
+					output += "Set ";
+					output += action_sets[rng.below(action_sets.size())];
+				}
+				break;
+		}
+
+		end_line();
+	}
+
+	void write_constant(std::size_t index)
+	{
+		std::string name = "c" + std::to_string(index);
+		output += name;
+		output += " = ";
+
+		switch (rng.below(4)) {
+			case 0:
+				output += std::to_string(rng.between(18, 45));
+				integers.push_back(std::move(name));
+				break;
+			case 1:
+				write_color();
+				colors.push_back(std::move(name));
+				break;
+			case 2:
+				if (rng.chance(params.query_density))
+					write_query();
+				else
+					write_string_list();
+
+				string_lists.push_back(std::move(name));
+				break;
+			default:
+				output += "{ SetTextColor ";
+				write_color_value();
+				output += " SetFontSize ";
+				write_integer();
+				output += " }";
+				action_sets.push_back(std::move(name));
+				break;
+		}
+
+		end_line();
+	}
+
+	void write_condition(std::size_t depth)
+	{
+		if (depth == 0) {
+			output += "Class ";
+			write_strings();
+		}
+		else if (depth == 1) {
+			output += "BaseType ";
+			write_strings();
+		}
+		else {
+			output += range_conditions[depth - 2];
+			output += ' ';
+			output += std::to_string(rng.between(1, 80));
+		}
+	}
+
+	void write_block(std::size_t depth)
+	{
+		indent(depth);
+		write_condition(depth);
+		output += " {";
+		end_line();
+
+		const std::size_t num_actions = rng.below(3);
+		for (std::size_t i = 0; i < num_actions; ++i)
+			write_action(depth + 1);
+
+		if (depth < std::min(params.nesting_depth, max_nesting_depth))
+			for (std::size_t i = 0; i < params.nested_blocks; ++i)
+				write_block(depth + 1);
+
+		indent(depth + 1);
+		output += rng.chance(0.8) ? "Show" : "Hide";
+		end_line();
+
+		indent(depth);
+		output += '}';
+		end_line();
+	}
+
+	const template_parameters& params;
+	random_engine rng;
+	std::string output;
+
+	// names of already defined constants, by type
+	std::vector<std::string> integers;
+	std::vector<std::string> colors;
+	std::vector<std::string> string_lists;
+	std::vector<std::string> action_sets;
+};
+
+}
+
+std::string generate_template(const template_parameters& params)
+{
+	return template_writer(params).generate();
+}
+
+lang::item_price_data generate_item_price_data(std::size_t items_per_category, std::uint64_t seed)
+{
+	random_engine rng(seed);
+	const auto make_item = [&]() {
+		return lang::elementary_item{
+			lang::price_data{static_cast<double>(rng.below(100000)) / 100.0, rng.chance(0.1)},
+			item_name(rng)};
+	};
+
+	lang::item_price_data result;
+	for (std::size_t i = 0; i < items_per_category; ++i) {
+		result.divination_cards.emplace_back(make_item(), rng.between(1, 10));
+		result.essences.push_back(make_item());
+		result.fossils.push_back(make_item());
+		result.prophecies.push_back(make_item());
+		result.resonators.push_back(make_item());
+		result.scarabs.push_back(make_item());
+		result.incubators.push_back(make_item());
+		result.oils.push_back(make_item());
+	}
+
+	return result;
+}
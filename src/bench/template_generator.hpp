@@ -0,0 +1,38 @@
+#pragma once
+
+#include <fs/lang/item_price_data.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @file synthetic filter templates for benchmarking
+ *
+ * @details Output depends only on the parameters (including the seed) - the same
+ * parameters produce byte-identical templates on every platform so that results
+ * of different program versions can be compared.
+ */
+
+struct template_parameters
+{
+	std::size_t constants = 1000;
+	std::size_t top_level_blocks = 200;
+	// maximum depth of nested blocks, 0 means no nesting
+	std::size_t nesting_depth = 3;
+	// nested blocks inside each block (except the deepest ones)
+	std::size_t nested_blocks = 2;
+	std::size_t array_size = 20;
+	// fraction [0, 1] of string list constants which are price queries
+	double query_density = 0.1;
+	// comment lines per line of code
+	double comment_ratio = 0.2;
+	std::uint64_t seed = 1;
+};
+
+[[nodiscard]]
+std::string generate_template(const template_parameters& params);
+
+// item price data with items for all queries used by generated templates
+[[nodiscard]]
+fs::lang::item_price_data generate_item_price_data(std::size_t items_per_category, std::uint64_t seed);
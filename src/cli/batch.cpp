@@ -0,0 +1,144 @@
+#include "batch.hpp"
+
+#include <fs/generator/batch_manifest.hpp>
+#include <fs/log/logger.hpp>
+#include <fs/log/buffered_logger.hpp>
+#include <fs/utility/file.hpp>
+#include <fs/utility/parallel.hpp>
+
+#include <chrono>
+#include <exception>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace fs;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+struct job_result
+{
+	output_status status = output_status::failed;
+	std::chrono::milliseconds time{0};
+	std::string log;
+};
+
+std::optional<item_data> load_data_source(const generator::batch_data_source& source, log::logger& logger)
+{
+	if (source.empty)
+		return empty_item_data();
+
+	return obtain_item_data(
+		source.download_league_name_ninja,
+		source.download_league_name_watch,
+		source.data_read_dir,
+		boost::none,
+		logger);
+}
+
+job_result run_job(
+	const generator::batch_job& j,
+	const std::optional<item_data>& data,
+	const std::optional<std::string>& source,
+	generator::options options,
+	generator::write_policy policy)
+{
+	const auto start = std::chrono::steady_clock::now();
+	log::buffered_logger logger;
+	job_result result;
+
+	try {
+		if (!data)
+			logger.error() << "no item price data from " << j.data_name;
+		else if (!source)
+			logger.error() << "failed to load " << j.template_path.generic_string();
+		else {
+			options.import_directory = j.template_path.parent_path().generic_string();
+			result.status = generate_filter_to_file(*source, *data, j.output_path, options, policy, logger);
+		}
+	}
+	catch (const std::exception& e) {
+		logger.error() << e.what();
+	}
+
+	result.time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	result.log = logger.flush_out();
+	return result;
+}
+
+} // namespace
+
+output_status run_batch(
+	const bfs::path& manifest_path,
+	generator::options options,
+	generator::write_policy policy,
+	log::logger& logger)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	const std::optional<std::string> manifest_content = utility::load_file(manifest_path, logger);
+	if (!manifest_content)
+		return output_status::failed;
+
+	const std::optional<generator::batch_manifest> m = generator::parse_batch_manifest(*manifest_content, manifest_path.parent_path(), logger);
+	if (!m)
+		return output_status::failed;
+
+	// shared inputs: each data source and template only once, only if used by any job
+	std::map<std::string, std::optional<item_data>> data;
+	std::map<bfs::path, std::optional<std::string>> sources;
+	for (const generator::batch_job& j : m->jobs) {
+		if (data.count(j.data_name) == 0) {
+			logger.info() << "obtaining item price data: " << j.data_name;
+			data.emplace(j.data_name, load_data_source(m->data_sources.at(j.data_name), logger));
+		}
+
+		if (sources.count(j.template_path) == 0)
+			sources.emplace(j.template_path, utility::load_file(j.template_path, logger));
+	}
+
+	// parallelism is over jobs, each job runs on 1 thread
+	const unsigned num_threads = utility::resolve_thread_count(options.num_threads);
+	options.num_threads = 1;
+
+	std::vector<job_result> results(m->jobs.size());
+	utility::parallel_for(m->jobs.size(), num_threads, [&](std::size_t i) {
+		const generator::batch_job& j = m->jobs[i];
+		results[i] = run_job(j, data.at(j.data_name), sources.at(j.template_path), options, policy);
+	});
+
+	// no jobs - nothing written
+	output_status status = output_status::unchanged;
+	int succeeded = 0;
+	int unchanged = 0;
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const generator::batch_job& j = m->jobs[i];
+		const job_result& result = results[i];
+		status = combine(status, result.status);
+		const std::string description = j.template_path.generic_string()
+			+ " with " + j.data_name + " -> " + j.output_path.generic_string();
+
+		if (result.status != output_status::failed) {
+			++succeeded;
+			if (result.status == output_status::unchanged)
+				++unchanged;
+
+			logger.info() << "job " << static_cast<int>(i + 1) << " (" << description << ") done in "
+				<< static_cast<int>(result.time.count()) << " ms\n" << result.log;
+		}
+		else {
+			logger.error() << "job " << static_cast<int>(i + 1) << " (" << description << ") failed after "
+				<< static_cast<int>(result.time.count()) << " ms\n" << result.log;
+		}
+	}
+
+	const auto total_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+	logger.info() << "batch finished: " << succeeded << " of " << static_cast<int>(results.size())
+		<< " jobs succeeded (" << unchanged << " unchanged) in " << static_cast<int>(total_time.count()) << " ms";
+
+	return status;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core.hpp"
+
+#include <fs/log/logger_fwd.hpp>
+#include <fs/generator/options.hpp>
+#include <fs/generator/output_sink.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+/**
+ * @brief generate many filters in one process, as described by a manifest
+ *
+ * @details See fs::generator::parse_batch_manifest for the format of
+ * the manifest. Paths are relative to the directory of the manifest. Each data source
+ * used by any job is downloaded or loaded once and each template is read
+ * once. Jobs are generated concurrently (options.num_threads of them at
+ * once), a failed job does not stop other jobs. Timing and the log of
+ * every job is reported in order of jobs.
+ *
+ * @return failed if any job failed, unchanged if no output was written
+ */
+[[nodiscard]] output_status
+run_batch(
+	const boost::filesystem::path& manifest_path,
+	fs::generator::options options,
+	fs::generator::write_policy policy,
+	fs::log::logger& logger);
@@ -1,6 +1,7 @@
 #include "core.hpp"
 
 #include <fs/generator/generate_filter.hpp>
+#include <fs/generator/output_sink.hpp>
 #include <fs/network/poe_ninja/download_data.hpp>
 #include <fs/network/poe_ninja/parse_data.hpp>
 #include <fs/network/poe_watch/download_data.hpp>
@@ -8,6 +9,12 @@
 #include <fs/utility/file.hpp>
 #include <fs/log/logger.hpp>
 
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace fs;
 
 namespace
@@ -37,33 +44,143 @@ void save_data(
 	logger.info() << "item price data successfully saved";
 }
 
-bool generate_item_filter_impl(
+output_status generate_item_filter_impl(
 	const item_data& item_data,
 	const boost::filesystem::path& source_filepath,
 	const boost::filesystem::path& output_filepath,
-	bool print_ast,
+	generator::options options,
+	generator::write_policy policy,
 	log::logger& logger)
 {
 	std::optional<std::string> source_file_content = utility::load_file(source_filepath, logger);
 
 	if (!source_file_content)
-		return false;
+		return output_status::failed;
+
+	// imports in the template are relative to its location
+	options.import_directory = source_filepath.parent_path().generic_string();
+	return generate_filter_to_file(*source_file_content, item_data, output_filepath, options, policy, logger);
+}
+
+// reports errors and untouched files, finish() must not have been called yet
+output_status finish_output(generator::file_sink& output, const boost::filesystem::path& output_filepath, log::logger& logger)
+{
+	if (const std::error_code ec = output.finish(); ec) {
+		logger.error() << "failed to save file " << output_filepath.generic_string() << ": " << ec.message();
+		return output_status::failed;
+	}
+
+	if (output.unchanged()) {
+		logger.info() << "filter unchanged, not rewriting " << output_filepath.generic_string();
+		return output_status::unchanged;
+	}
+
+	return output_status::written;
+}
+
+// OUTPUT-NAME.ext in the same directory as output
+boost::filesystem::path variant_output_path(const boost::filesystem::path& output_filepath, const std::string& name)
+{
+	return output_filepath.parent_path() / (output_filepath.stem().generic_string() + "-" + name + output_filepath.extension().generic_string());
+}
+
+output_status generate_item_filter_variants_impl(
+	const item_data& item_data,
+	const boost::filesystem::path& source_filepath,
+	const boost::filesystem::path& output_filepath,
+	const std::vector<std::string>& variant_specs,
+	generator::options options,
+	generator::write_policy policy,
+	log::logger& logger)
+{
+	std::optional<std::string> source_file_content = utility::load_file(source_filepath, logger);
+
+	if (!source_file_content)
+		return output_status::failed;
+
+	options.import_directory = source_filepath.parent_path().generic_string();
+
+	std::vector<generator::filter_variant> variants;
+	std::vector<boost::filesystem::path> output_paths;
+	for (const std::string& spec : variant_specs) {
+		const auto separator = spec.find('=');
+		generator::filter_variant variant;
+		variant.name = spec.substr(0, separator);
+
+		if (separator != std::string::npos) {
+			std::optional<std::string> overrides = utility::load_file(spec.substr(separator + 1), logger);
+			if (!overrides)
+				return output_status::failed;
 
-	std::optional<std::string> filter_content = generator::generate_filter(
+			variant.overrides = std::move(*overrides);
+		}
+
+		variants.push_back(std::move(variant));
+		output_paths.push_back(variant_output_path(output_filepath, variants.back().name));
+	}
+
+	std::vector<std::unique_ptr<generator::file_sink>> outputs;
+	for (std::size_t i = 0; i < variants.size(); ++i) {
+		outputs.push_back(std::make_unique<generator::file_sink>(output_paths[i], policy));
+		variants[i].output = outputs.back().get();
+	}
+
+	const std::vector<bool> generated = generator::generate_filter_variants(
 		*source_file_content,
 		item_data.item_price_data,
 		item_data.item_price_metadata,
-		generator::options{print_ast},
+		options,
+		variants,
 		logger);
 
-	if (!filter_content)
-		return false;
+	std::optional<output_status> status;
+	for (std::size_t i = 0; i < outputs.size(); ++i) {
+		// failed variants do not create or truncate their files
+		const output_status variant_status = generated[i]
+			? finish_output(*outputs[i], output_paths[i], logger)
+			: output_status::failed;
 
-	return utility::save_file(output_filepath, *filter_content, logger);
+		status = status ? combine(*status, variant_status) : variant_status;
+	}
+
+	return status.value_or(output_status::failed);
 }
 
 } // namespace
 
+output_status generate_filter_to_file(
+	std::string_view source,
+	const item_data& item_data,
+	const boost::filesystem::path& output_filepath,
+	const generator::options& options,
+	generator::write_policy policy,
+	log::logger& logger)
+{
+	// the filter is written while it is generated, the file is not touched if compilation fails
+	generator::file_sink output(output_filepath, policy);
+	const bool success = generator::generate_filter(
+		source,
+		item_data.item_price_data,
+		item_data.item_price_metadata,
+		options,
+		output,
+		logger);
+
+	if (!success)
+		return output_status::failed;
+
+	return finish_output(output, output_filepath, logger);
+}
+
+item_data empty_item_data()
+{
+	item_data data;
+	data.item_price_metadata.data_source = lang::data_source_type::none;
+	data.item_price_metadata.league_name = "(none)";
+	data.item_price_metadata.download_date = boost::posix_time::ptime(boost::posix_time::not_a_date_time);
+	return data;
+}
+
 void list_leagues(log::logger& logger)
 {
 	std::future<network::poe_watch::api_league_data> leagues_future = network::poe_watch::async_download_leagues(logger);
@@ -142,28 +259,33 @@ obtain_item_data(
 	return data;
 }
 
-[[nodiscard]] bool
+[[nodiscard]] output_status
 generate_item_filter(
 	const std::optional<item_data>& item_data,
 	const boost::optional<std::string>& input_path,
 	const boost::optional<std::string>& output_path,
-	bool print_ast,
+	const std::vector<std::string>& variants,
+	generator::options options,
+	generator::write_policy policy,
 	fs::log::logger& logger)
 {
 	if (!item_data) {
 		logger.error() << "no item price data, giving up on filter generation";
-		return false;
+		return output_status::failed;
 	}
 
 	if (!input_path) {
 		logger.error() << "no input path given";
-		return false;
+		return output_status::failed;
 	}
 
 	if (!output_path) {
 		logger.error() << "no output path given";
-		return false;
+		return output_status::failed;
 	}
 
-	return generate_item_filter_impl(*item_data, *input_path, *output_path, print_ast, logger);
+	if (!variants.empty())
+		return generate_item_filter_variants_impl(*item_data, *input_path, *output_path, variants, options, policy, logger);
+
+	return generate_item_filter_impl(*item_data, *input_path, *output_path, options, policy, logger);
 }
@@ -3,11 +3,17 @@
 #include <fs/log/logger_fwd.hpp>
 #include <fs/lang/item_price_data.hpp>
 #include <fs/lang/item_price_metadata.hpp>
+#include <fs/generator/options.hpp>
+#include <fs/generator/output_sink.hpp>
 
 #include <boost/optional.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <string>
+#include <string_view>
+#include <vector>
+
+using fs::generator::output_status;
 
 void list_leagues(fs::log::logger& logger);
 
@@ -17,6 +23,9 @@ struct item_data
 	fs::lang::item_price_metadata item_price_metadata;
 };
 
+// no prices, for filters which do not use price queries
+[[nodiscard]] item_data empty_item_data();
+
 [[nodiscard]] std::optional<item_data>
 obtain_item_data(
 	const boost::optional<std::string>& download_league_name_ninja,
@@ -25,10 +34,23 @@ obtain_item_data(
 	const boost::optional<std::string>& data_save_dir,
 	fs::log::logger& logger);
 
-[[nodiscard]] bool
+[[nodiscard]] output_status
 generate_item_filter(
 	const std::optional<item_data>& item_data,
 	const boost::optional<std::string>& source_filepath,
 	const boost::optional<std::string>& output_filepath,
-	bool print_ast,
+	// NAME[=FILE] specifications of variants, empty to generate only the template
+	const std::vector<std::string>& variants,
+	fs::generator::options options,
+	fs::generator::write_policy policy,
+	fs::log::logger& logger);
+
+// imports of the source are resolved against options.import_directory
+[[nodiscard]] output_status
+generate_filter_to_file(
+	std::string_view source,
+	const item_data& item_data,
+	const boost::filesystem::path& output_filepath,
+	const fs::generator::options& options,
+	fs::generator::write_policy policy,
 	fs::log::logger& logger);
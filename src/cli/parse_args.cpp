@@ -1,23 +1,32 @@
 #include "parse_args.hpp"
 #include "core.hpp"
+#include "batch.hpp"
 
 #include <fs/version.hpp>
 #include <fs/log/console_logger.hpp>
 #include <fs/lang/item_price_data.hpp>
 #include <fs/lang/item_price_metadata.hpp>
+#include <fs/compiler/module_cache.hpp>
+#include <fs/generator/filter_cache.hpp>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/program_options.hpp>
 #include <boost/optional.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <cstdlib>
 #include <iostream>
 #include <exception>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace
 {
 
+// for schedulers: generation succeeded but no output file had to be written
+constexpr int exit_unchanged = 2;
+
 void print_help(const boost::program_options::options_description& options)
 {
 	std::cout <<
@@ -72,10 +81,32 @@ int run(int argc, char* argv[])
 
 		bool opt_generate = false;
 		bool opt_print_ast = false;
+		bool opt_strict = false;
+		bool opt_warn_unused = false;
+		bool opt_remove_unreachable = false;
+		bool opt_merge_blocks = false;
+		bool opt_minimize_lists = false;
+		std::vector<std::string> variants;
+		boost::optional<std::string> batch_manifest;
+		bool opt_skip_unchanged = false;
+		unsigned num_threads = 0;
+		boost::optional<std::string> module_cache_dir;
+		boost::optional<std::string> filter_cache_dir;
 		po::options_description generation_options("generation options");
 		generation_options.add_options()
 			("generate,g",  po::bool_switch(&opt_generate),  "generate an item filter")
 			("print-ast,a", po::bool_switch(&opt_print_ast), "print abstract syntax tree (for debug purposes)")
+			("strict",      po::bool_switch(&opt_strict),    "evaluate also constants not used by any block and report their errors (by default they are skipped)")
+			("warn-unused", po::bool_switch(&opt_warn_unused), "warn about constants which are never used")
+			("remove-unreachable", po::bool_switch(&opt_remove_unreachable), "leave out blocks which can never match any item")
+			("merge-blocks", po::bool_switch(&opt_merge_blocks), "join consecutive blocks which differ only in one list of strings")
+			("minimize-lists", po::bool_switch(&opt_minimize_lists), "remove redundant strings from lists of non-exact conditions (eg BaseType)")
+			("variant",     po::value(&variants)->composing(), "generate a variant instead: NAME[=FILE], FILE has definitions replacing these of the template, output goes to OUTPUT-NAME.ext (can be repeated)")
+			("batch",       po::value(&batch_manifest), "generate filters described by a JSON manifest (templates, data sources and outputs), ignores data obtaining options")
+			("skip-unchanged", po::bool_switch(&opt_skip_unchanged), "do not rewrite output files which already have the same filter (generation info is ignored), exit with code 2 if nothing was written")
+			("jobs,j",      po::value(&num_threads),         "number of threads to use (default: 0 - all hardware threads)")
+			("module-cache-dir", po::value(&module_cache_dir), "directory where to store evaluated imported files for future runs")
+			("filter-cache-dir", po::value(&filter_cache_dir), "directory where to store generated filters, reused when template, imported files, price data and options did not change")
 		;
 
 		boost::optional<std::string> input_path;
@@ -133,25 +164,66 @@ int run(int argc, char* argv[])
 			return EXIT_SUCCESS;
 		}
 
+		fs::generator::options options;
+		options.print_ast = opt_print_ast;
+		options.strict = opt_strict;
+		options.warn_unused_definitions = opt_warn_unused;
+		options.remove_unreachable_blocks = opt_remove_unreachable;
+		options.merge_blocks = opt_merge_blocks;
+		options.minimize_string_lists = opt_minimize_lists;
+		options.num_threads = num_threads;
+
+		std::optional<fs::compiler::module_cache> module_cache;
+		if (module_cache_dir) {
+			boost::filesystem::create_directories(*module_cache_dir);
+			module_cache.emplace(*module_cache_dir);
+		}
+		else {
+			module_cache.emplace();
+		}
+		options.module_cache = &*module_cache;
+
+		std::optional<fs::generator::filter_cache> filter_cache;
+		if (filter_cache_dir) {
+			boost::filesystem::create_directories(*filter_cache_dir);
+			filter_cache.emplace(*filter_cache_dir);
+			options.filter_cache = &*filter_cache;
+		}
+
+		const fs::generator::write_policy policy = opt_skip_unchanged
+			? fs::generator::write_policy::if_changed
+			: fs::generator::write_policy::always;
+
+		if (batch_manifest) {
+			// data sources and outputs are specified by the manifest
+			const output_status status = run_batch(*batch_manifest, options, policy, logger);
+			if (status == output_status::failed) {
+				logger.info() << "batch generation failed";
+				return EXIT_FAILURE;
+			}
+
+			return status == output_status::unchanged ? exit_unchanged : EXIT_SUCCESS;
+		}
+
 		std::optional<item_data> data;
 
 		if (opt_empty_data) {
 			// user explicitly stated to use empty data, some find it useful to write SSF filters where price queries are not used
-			data = item_data();
-			item_data& d = *data;
-			d.item_price_metadata.data_source = fs::lang::data_source_type::none;
-			d.item_price_metadata.league_name = "(none)";
-			d.item_price_metadata.download_date = boost::posix_time::ptime(boost::posix_time::not_a_date_time);
+			data = empty_item_data();
 		}
 		else {
 			data = obtain_item_data(download_league_name_ninja, download_league_name_watch, data_read_dir, data_save_dir, logger);
 		}
 
 		if (opt_generate) {
-			if (!generate_item_filter(data, input_path, output_path, opt_print_ast, logger)) {
+			const output_status status = generate_item_filter(data, input_path, output_path, variants, options, policy, logger);
+			if (status == output_status::failed) {
 				logger.info() << "filter generation failed";
 				return EXIT_FAILURE;
 			}
+
+			if (status == output_status::unchanged)
+				return exit_unchanged;
 		}
 	}
 	catch (const std::exception& e) {
@@ -4,10 +4,19 @@
 #include <fs/lang/action_set.hpp>
 #include <fs/lang/condition_set.hpp>
 #include <fs/lang/queries.hpp>
+#include <fs/utility/copy_on_write.hpp>
+#include <fs/utility/intern_pool.hpp>
+#include <fs/utility/parallel.hpp>
 
+#include <boost/functional/hash.hpp>
 #include <boost/spirit/home/x3/support/utility/lambda_visitor.hpp>
 
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace
 {
@@ -19,40 +28,63 @@ namespace x3 = boost::spirit::x3;
 using fs::compiler::compile_error;
 using fs::compiler::detail::add_action;
 using fs::compiler::detail::add_conditions;
+using fs::compiler::detail::evaluation_context;
 
 std::optional<compile_error> apply_statements_recursively(
-	lang::condition_set parent_conditions,
-	lang::action_set parent_actions,
+	fs::utility::copy_on_write<lang::condition_set> parent_conditions,
+	fs::utility::copy_on_write<lang::action_set> parent_actions,
 	const std::vector<ast::statement>& statements,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
+	const lang::item_price_data& item_price_data,
+	std::vector<lang::filter_block>& blocks);
+
+std::optional<compile_error> apply_rule_block(
+	fs::utility::copy_on_write<lang::condition_set> parent_conditions,
+	fs::utility::copy_on_write<lang::action_set> parent_actions,
+	const ast::rule_block& rule_block,
+	const evaluation_context& context,
+	const lang::item_price_data& item_price_data,
+	std::vector<lang::filter_block>& blocks)
+{
+	// nested blocks share parent sets until they modify them - the parent
+	// instance on the call stack stays intact and emitted blocks keep
+	// referencing whichever version was current at the point of emission
+	if (!rule_block.conditions.empty()) {
+		std::optional<compile_error> error = add_conditions(
+			rule_block.conditions, context, item_price_data, parent_conditions.edit());
+		if (error)
+			return error;
+	}
+
+	return apply_statements_recursively(
+		std::move(parent_conditions),
+		std::move(parent_actions),
+		rule_block.statements,
+		context,
+		item_price_data,
+		blocks);
+}
+
+std::optional<compile_error> apply_statements_recursively(
+	fs::utility::copy_on_write<lang::condition_set> parent_conditions,
+	fs::utility::copy_on_write<lang::action_set> parent_actions,
+	const std::vector<ast::statement>& statements,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	std::vector<lang::filter_block>& blocks)
 {
 	for (const ast::statement& statement : statements) {
 		auto error = statement.apply_visitor(x3::make_lambda_visitor<std::optional<compile_error>>(
 			[&](const ast::action& action) {
-				return add_action(action, symbols, item_price_data, parent_actions);
+				return add_action(action, context, item_price_data, parent_actions.edit());
 			},
 			[&](const ast::visibility_statement& vs) {
-				blocks.push_back(lang::filter_block{vs.show, parent_conditions, parent_actions});
+				blocks.push_back(lang::filter_block{vs.show, parent_conditions, parent_actions, fs::parser::get_position_info(vs)});
 				return std::nullopt;
 			},
 			[&](const ast::rule_block& nested_block) {
-				// explicitly make a copy of parent conditions - the call stack will preserve
-				// old instance while nested blocks can add additional conditions that have limited lifetime
-				lang::condition_set nested_conditions(parent_conditions);
-				std::optional<compile_error> error = add_conditions(
-					nested_block.conditions, symbols, item_price_data, nested_conditions);
-				if (error)
-					return error;
-
-				return apply_statements_recursively(
-					std::move(nested_conditions),
-					parent_actions,
-					nested_block.statements,
-					symbols,
-					item_price_data,
-					blocks);
+				return apply_rule_block(
+					parent_conditions, parent_actions, nested_block, context, item_price_data, blocks);
 			}));
 
 		if (error)
@@ -62,6 +94,105 @@ std::optional<compile_error> apply_statements_recursively(
 	return std::nullopt;
 }
 
+/*
+ * Top-level rule blocks do not depend on each other - only on top-level
+ * actions that precede them. These are applied serially and each rule block
+ * gets a snapshot of them, then rule blocks can be compiled independently.
+ */
+struct top_level_subtree
+{
+	const ast::rule_block* rule_block = nullptr; // null for blocks emitted directly at top level
+	fs::utility::copy_on_write<lang::action_set> actions;
+	std::vector<lang::filter_block> blocks;
+	std::optional<compile_error> error;
+};
+
+// stops at the first error of a top-level action - any later error would be later in source order
+std::vector<top_level_subtree> split_top_level_statements(
+	const std::vector<ast::statement>& statements,
+	const evaluation_context& context,
+	const lang::item_price_data& item_price_data,
+	std::optional<compile_error>& action_error)
+{
+	std::vector<top_level_subtree> subtrees;
+	fs::utility::copy_on_write<lang::action_set> actions;
+
+	for (const ast::statement& statement : statements) {
+		action_error = statement.apply_visitor(x3::make_lambda_visitor<std::optional<compile_error>>(
+			[&](const ast::action& action) {
+				return add_action(action, context, item_price_data, actions.edit());
+			},
+			[&](const ast::visibility_statement& vs) {
+				if (subtrees.empty() || subtrees.back().rule_block != nullptr)
+					subtrees.emplace_back();
+
+				subtrees.back().blocks.push_back(lang::filter_block{vs.show, {}, actions, fs::parser::get_position_info(vs)});
+				return std::nullopt;
+			},
+			[&](const ast::rule_block& rule_block) {
+				subtrees.push_back(top_level_subtree{&rule_block, actions, {}, std::nullopt});
+				return std::nullopt;
+			}));
+
+		if (action_error)
+			break;
+	}
+
+	return subtrees;
+}
+
+/*
+ * hash-consing: blocks with identical actions or string lists (common with
+ * shared styles) end up with the same instance of them - memory scales with
+ * the number of distinct values and equal values have the same address
+ */
+void intern_values(std::vector<lang::filter_block>& blocks)
+{
+	using fs::utility::copy_on_write;
+	using fs::utility::intern_pool;
+	using string_list = std::vector<std::string>;
+
+	intern_pool<copy_on_write<lang::action_set>, boost::hash<lang::action_set>> action_sets;
+	intern_pool<std::shared_ptr<string_list>, boost::hash<string_list>> string_lists;
+
+	constexpr lang::strings_condition lang::condition_set::* string_conditions[] = {
+		&lang::condition_set::class_,
+		&lang::condition_set::base_type,
+		&lang::condition_set::has_explicit_mod,
+		&lang::condition_set::has_enchantment,
+		&lang::condition_set::prophecy
+	};
+
+	// condition sets are shared by blocks from the same scope - intern each only once
+	// (the original is kept so that its address can not be reused while in the map)
+	using interned_pair = std::pair<copy_on_write<lang::condition_set>, copy_on_write<lang::condition_set>>;
+	std::unordered_map<const lang::condition_set*, interned_pair> condition_sets;
+
+	for (lang::filter_block& block : blocks) {
+		block.actions = action_sets.intern(block.actions);
+
+		const lang::condition_set* const original = &*block.conditions;
+		if (const auto it = condition_sets.find(original); it != condition_sets.end()) {
+			block.conditions = it->second.second;
+			continue;
+		}
+
+		copy_on_write<lang::condition_set> interned = block.conditions;
+		for (auto member : string_conditions) {
+			const std::shared_ptr<string_list>& strings = ((*interned).*member).strings;
+			if (strings == nullptr)
+				continue;
+
+			std::shared_ptr<string_list> canonical = string_lists.intern(strings);
+			if (canonical != strings)
+				(interned.edit().*member).strings = std::move(canonical);
+		}
+
+		condition_sets.emplace(original, interned_pair{block.conditions, interned});
+		block.conditions = std::move(interned);
+	}
+}
+
 } // namespace
 
 namespace fs::compiler {
@@ -71,12 +202,51 @@ std::variant<std::vector<lang::filter_block>, compile_error> build_filter_blocks
 	const lang::symbol_table& symbols,
 	const lang::item_price_data& item_price_data)
 {
+	symbol_references references;
+	resolve_references(top_level_statements, symbols, references);
+	return build_filter_blocks(top_level_statements, symbols, references, item_price_data);
+}
+
+std::variant<std::vector<lang::filter_block>, compile_error> build_filter_blocks(
+	const std::vector<parser::ast::statement>& top_level_statements,
+	const lang::symbol_table& symbols,
+	const symbol_references& references,
+	const lang::item_price_data& item_price_data,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	const evaluation_context context{symbols, references, queries};
+	std::optional<compile_error> action_error;
+	std::vector<top_level_subtree> subtrees =
+		split_top_level_statements(top_level_statements, context, item_price_data, action_error);
+
+	// all threads only read symbols, references and item price data, each works only
+	// on its own subtree (copy_on_write instances must not be used by 2 threads at once)
+	utility::parallel_for(subtrees.size(), utility::resolve_thread_count(num_threads), [&](std::size_t i) {
+		top_level_subtree& subtree = subtrees[i];
+		if (subtree.rule_block != nullptr)
+			subtree.error = apply_rule_block(
+				{}, std::move(subtree.actions), *subtree.rule_block, context, item_price_data, subtree.blocks);
+	});
+
+	std::size_t num_blocks = 0;
+	for (top_level_subtree& subtree : subtrees) {
+		// report the first error in source order, regardless of which thread found it first
+		if (subtree.error)
+			return *std::move(subtree.error);
+
+		num_blocks += subtree.blocks.size();
+	}
+
+	if (action_error)
+		return *std::move(action_error);
+
 	std::vector<lang::filter_block> blocks;
-	std::optional<compile_error> error = apply_statements_recursively(
-		{}, {}, top_level_statements, symbols, item_price_data, blocks);
-	if (error)
-		return *std::move(error);
+	blocks.reserve(num_blocks);
+	for (top_level_subtree& subtree : subtrees)
+		std::move(subtree.blocks.begin(), subtree.blocks.end(), std::back_inserter(blocks));
 
+	intern_values(blocks);
 	return blocks;
 }
 
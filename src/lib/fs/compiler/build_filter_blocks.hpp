@@ -1,6 +1,8 @@
 #pragma once
 #include <fs/parser/ast.hpp>
 #include <fs/compiler/error.hpp>
+#include <fs/compiler/query_cache.hpp>
+#include <fs/compiler/symbol_references.hpp>
 #include <fs/lang/symbol_table.hpp>
 #include <fs/lang/filter_block.hpp>
 #include <fs/lang/item_price_data.hpp>
@@ -17,4 +19,23 @@ build_filter_blocks(
 	const lang::symbol_table& symbols,
 	const lang::item_price_data& item_price_data);
 
+/*
+ * as above, but references of statements are already resolved
+ *
+ * Top-level rule blocks are compiled concurrently using up to num_threads
+ * threads (0 means all hardware threads). Blocks are always in source order
+ * and if there are multiple errors, the first one in source order is returned.
+ * If queries is not null, results of price queries are cached there.
+ * Equal action sets and string lists of returned blocks are one shared
+ * instance, so they can be compared by address.
+ */
+[[nodiscard]] std::variant<std::vector<lang::filter_block>, compile_error>
+build_filter_blocks(
+	const std::vector<parser::ast::statement>& top_level_statements,
+	const lang::symbol_table& symbols,
+	const symbol_references& references,
+	const lang::item_price_data& item_price_data,
+	unsigned num_threads = 1,
+	query_cache* queries = nullptr);
+
 }
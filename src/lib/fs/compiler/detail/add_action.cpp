@@ -13,11 +13,12 @@ namespace
 
 using namespace fs;
 using namespace fs::compiler;
+using fs::compiler::detail::evaluation_context;
 
 [[nodiscard]] std::optional<compile_error>
 add_unary_action(
 	const ast::unary_action& action,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::action_set& action_set)
 {
@@ -25,7 +26,7 @@ add_unary_action(
 	{
 		case lang::unary_action_type::set_border_color:
 		{
-			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, symbols, item_price_data);
+			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(color_or_error))
 				return std::get<compile_error>(std::move(color_or_error));
 
@@ -34,7 +35,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_text_color:
 		{
-			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, symbols, item_price_data);
+			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(color_or_error))
 				return std::get<compile_error>(std::move(color_or_error));
 
@@ -43,7 +44,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_background_color:
 		{
-			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, symbols, item_price_data);
+			std::variant<lang::color, compile_error> color_or_error = detail::evaluate_as<lang::color>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(color_or_error))
 				return std::get<compile_error>(std::move(color_or_error));
 
@@ -52,7 +53,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_font_size:
 		{
-			std::variant<lang::font_size, compile_error> font_size_or_error = detail::evaluate_as<lang::font_size>(action.value, symbols, item_price_data);
+			std::variant<lang::font_size, compile_error> font_size_or_error = detail::evaluate_as<lang::font_size>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(font_size_or_error))
 				return std::get<compile_error>(std::move(font_size_or_error));
 
@@ -61,7 +62,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_alert_sound:
 		{
-			std::variant<lang::alert_sound, compile_error> alert_or_error = detail::evaluate_as<lang::alert_sound>(action.value, symbols, item_price_data);
+			std::variant<lang::alert_sound, compile_error> alert_or_error = detail::evaluate_as<lang::alert_sound>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(alert_or_error))
 				return std::get<compile_error>(std::move(alert_or_error));
 
@@ -70,7 +71,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::play_default_drop_sound:
 		{
-			std::variant<lang::boolean, compile_error> bool_or_error = detail::evaluate_as<lang::boolean>(action.value, symbols, item_price_data);
+			std::variant<lang::boolean, compile_error> bool_or_error = detail::evaluate_as<lang::boolean>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(bool_or_error))
 				return std::get<compile_error>(std::move(bool_or_error));
 
@@ -80,7 +81,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_minimap_icon:
 		{
-			std::variant<lang::minimap_icon, compile_error> icon_or_error = detail::evaluate_as<lang::minimap_icon>(action.value, symbols, item_price_data);
+			std::variant<lang::minimap_icon, compile_error> icon_or_error = detail::evaluate_as<lang::minimap_icon>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(icon_or_error))
 				return std::get<compile_error>(std::move(icon_or_error));
 
@@ -89,7 +90,7 @@ add_unary_action(
 		}
 		case lang::unary_action_type::set_beam:
 		{
-			std::variant<lang::beam_effect, compile_error> beam_or_error = detail::evaluate_as<lang::beam_effect>(action.value, symbols, item_price_data);
+			std::variant<lang::beam_effect, compile_error> beam_or_error = detail::evaluate_as<lang::beam_effect>(action.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(beam_or_error))
 				return std::get<compile_error>(std::move(beam_or_error));
 
@@ -106,18 +107,18 @@ add_unary_action(
 [[nodiscard]] std::optional<compile_error>
 add_compound_action(
 	const ast::compound_action& ca,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::action_set& action_set)
 {
-	std::variant<lang::action_set, compile_error> actions_or_error =
-		detail::evaluate_as<lang::action_set>(ca.value, symbols, item_price_data);
+	std::variant<lang::action_set_object, compile_error> actions_or_error =
+		detail::evaluate_as<lang::action_set_object>(ca.value, context, item_price_data);
 
 	if (std::holds_alternative<compile_error>(actions_or_error)) {
 		return std::get<compile_error>(std::move(actions_or_error));
 	}
 
-	action_set.override_with(std::get<lang::action_set>(std::move(actions_or_error)));
+	action_set.override_with(*std::get<lang::action_set_object>(actions_or_error));
 	return std::nullopt;
 }
 
@@ -129,16 +130,16 @@ namespace fs::compiler::detail
 std::optional<compile_error>
 add_action(
 	const ast::action& action,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::action_set& action_set)
 {
 	return action.apply_visitor(x3::make_lambda_visitor<std::optional<compile_error>>(
 		[&](const ast::unary_action& ua) {
-			return add_unary_action(ua, symbols, item_price_data, action_set);
+			return add_unary_action(ua, context, item_price_data, action_set);
 		},
 		[&](const ast::compound_action& ca) {
-			return add_compound_action(ca, symbols, item_price_data, action_set);
+			return add_compound_action(ca, context, item_price_data, action_set);
 		}
 	));
 }
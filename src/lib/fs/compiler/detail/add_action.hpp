@@ -2,7 +2,7 @@
 
 #include <fs/parser/ast.hpp>
 #include <fs/compiler/error.hpp>
-#include <fs/lang/symbol_table.hpp>
+#include <fs/compiler/detail/evaluation_context.hpp>
 #include <fs/lang/action_set.hpp>
 #include <fs/lang/item_price_data.hpp>
 
@@ -15,7 +15,7 @@ namespace fs::compiler::detail
 std::optional<compile_error>
 add_action(
 	const parser::ast::action& action,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::action_set& action_set);
 
@@ -11,6 +11,7 @@ namespace
 
 using namespace fs;
 using namespace fs::compiler;
+using fs::compiler::detail::evaluation_context;
 namespace ast = fs::parser::ast;
 
 template <typename T>
@@ -76,7 +77,7 @@ add_range_condition(
 [[nodiscard]] std::optional<compile_error>
 add_comparison_condition(
 	const ast::comparison_condition& condition,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set)
 {
@@ -88,7 +89,7 @@ add_comparison_condition(
 
 		case lang::comparison_condition_property::item_level:
 		{
-			std::variant<lang::level, compile_error> level_or_error = evaluate_as<lang::level>(condition.value, symbols, item_price_data);
+			std::variant<lang::level, compile_error> level_or_error = evaluate_as<lang::level>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(level_or_error))
 				return std::get<compile_error>(std::move(level_or_error));
 
@@ -97,7 +98,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::drop_level:
 		{
-			std::variant<lang::level, compile_error> level_or_error = evaluate_as<lang::level>(condition.value, symbols, item_price_data);
+			std::variant<lang::level, compile_error> level_or_error = evaluate_as<lang::level>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(level_or_error))
 				return std::get<compile_error>(std::move(level_or_error));
 
@@ -106,7 +107,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::quality:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -115,7 +116,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::rarity:
 		{
-			std::variant<lang::rarity, compile_error> rarity_or_error = evaluate_as<lang::rarity>(condition.value, symbols, item_price_data);
+			std::variant<lang::rarity, compile_error> rarity_or_error = evaluate_as<lang::rarity>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(rarity_or_error))
 				return std::get<compile_error>(std::move(rarity_or_error));
 
@@ -124,7 +125,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::sockets:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -133,7 +134,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::links:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -142,7 +143,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::height:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -151,7 +152,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::width:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -160,7 +161,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::stack_size:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -169,7 +170,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::gem_level:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -178,7 +179,7 @@ add_comparison_condition(
 		}
 		case lang::comparison_condition_property::map_tier:
 		{
-			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, symbols, item_price_data);
+			std::variant<lang::integer, compile_error> integer_or_error = evaluate_as<lang::integer>(condition.value, context, item_price_data);
 			if (std::holds_alternative<compile_error>(integer_or_error))
 				return std::get<compile_error>(std::move(integer_or_error));
 
@@ -192,20 +193,31 @@ add_comparison_condition(
 	}
 }
 
+// elements of price query results have no origins of their own
+[[nodiscard]] lang::position_tag
+origin_of_element(const lang::object& element, lang::position_tag array_origin)
+{
+	if (element.value_origin.id_first < 0)
+		return array_origin;
+
+	return element.value_origin;
+}
+
 [[nodiscard]] std::variant<std::vector<std::string>, compile_error>
 array_to_strings(
-	lang::array_object array)
+	const lang::array_object& array,
+	lang::position_tag array_origin)
 {
 	std::vector<std::string> result;
-	for (lang::object& obj : array) {
+	result.reserve(array.size());
+	for (const lang::object& obj : array) {
 		if (!std::holds_alternative<lang::string>(obj.value))
 			return errors::type_mismatch{
 				lang::object_type::string,
 				obj.type(),
-				obj.value_origin};
+				origin_of_element(obj, array_origin)};
 
-		auto& string = std::get<lang::string>(obj.value);
-		result.push_back(std::move(string.value));
+		result.push_back(std::get<lang::string>(obj.value).value);
 	}
 
 	return result;
@@ -213,15 +225,17 @@ array_to_strings(
 
 [[nodiscard]] std::variant<std::vector<lang::influence>, compile_error>
 array_to_influences(
-	lang::array_object array)
+	const lang::array_object& array,
+	lang::position_tag array_origin)
 {
 	std::vector<lang::influence> result;
-	for (lang::object& obj : array) {
+	result.reserve(array.size());
+	for (const lang::object& obj : array) {
 		if (!std::holds_alternative<lang::influence>(obj.value))
 			return errors::type_mismatch{
 				lang::object_type::influence,
 				obj.type(),
-				obj.value_origin};
+				origin_of_element(obj, array_origin)};
 
 		result.push_back(std::get<lang::influence>(obj.value));
 	}
@@ -264,21 +278,22 @@ add_influence_condition_impl(
 [[nodiscard]] std::optional<compile_error>
 add_array_condition(
 	const parser::ast::array_condition& condition,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set)
 {
-	std::variant<lang::array_object, compile_error> array_or_error = detail::evaluate_as<lang::array_object>(condition.value, symbols, item_price_data);
+	std::variant<lang::array_object, compile_error> array_or_error = detail::evaluate_as<lang::array_object>(condition.value, context, item_price_data);
 	if (std::holds_alternative<compile_error>(array_or_error))
 		return std::get<compile_error>(std::move(array_or_error));
 
 	const bool is_exact_match = condition.exact_match.required;
 	const lang::position_tag condition_origin = parser::get_position_info(condition);
+	const lang::position_tag array_origin = parser::get_position_info(condition.value);
 
 	// all conditions except "HasInfluence" expect an array of strings, which expects an array of influences
 	// handle influence first and then just expect an array of string for every other condition
 	if (condition.property == lang::array_condition_property::has_influence) {
-		auto influences_or_error = array_to_influences(std::move(std::get<lang::array_object>(array_or_error)));
+		auto influences_or_error = array_to_influences(std::get<lang::array_object>(array_or_error), array_origin);
 		if (std::holds_alternative<compile_error>(influences_or_error))
 			return std::get<compile_error>(std::move(influences_or_error));
 
@@ -286,7 +301,7 @@ add_array_condition(
 		return add_influence_condition_impl(std::move(influences), is_exact_match, condition_origin, condition_set.has_influence);
 	}
 
-	auto strings_or_error = array_to_strings(std::move(std::get<lang::array_object>(array_or_error)));
+	auto strings_or_error = array_to_strings(std::get<lang::array_object>(array_or_error), array_origin);
 	if (std::holds_alternative<compile_error>(strings_or_error))
 		return std::get<compile_error>(std::move(strings_or_error));
 
@@ -331,11 +346,11 @@ add_boolean_condition_impl(
 [[nodiscard]] std::optional<compile_error>
 add_boolean_condition(
 	const parser::ast::boolean_condition& condition,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set)
 {
-	std::variant<lang::boolean, compile_error> boolean_or_error = detail::evaluate_as<lang::boolean>(condition.value, symbols, item_price_data);
+	std::variant<lang::boolean, compile_error> boolean_or_error = detail::evaluate_as<lang::boolean>(condition.value, context, item_price_data);
 	if (std::holds_alternative<compile_error>(boolean_or_error))
 		return std::get<compile_error>(std::move(boolean_or_error));
 
@@ -395,11 +410,11 @@ add_socket_group_condition_impl(
 [[nodiscard]] std::optional<compile_error>
 add_socket_group_condition(
 	const parser::ast::socket_group_condition& condition,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set)
 {
-	std::variant<lang::socket_group, compile_error> socket_group_or_error = detail::evaluate_as<lang::socket_group>(condition.value, symbols, item_price_data);
+	std::variant<lang::socket_group, compile_error> socket_group_or_error = detail::evaluate_as<lang::socket_group>(condition.value, context, item_price_data);
 	if (std::holds_alternative<compile_error>(socket_group_or_error))
 		return std::get<compile_error>(std::move(socket_group_or_error));
 
@@ -418,23 +433,23 @@ namespace x3 = boost::spirit::x3;
 
 std::optional<compile_error> add_conditions(
 	const std::vector<ast::condition>& conditions,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set)
 {
 	for (const ast::condition& condition : conditions) {
 		auto error = condition.apply_visitor(x3::make_lambda_visitor<std::optional<compile_error>>(
 			[&](const ast::comparison_condition& comparison_condition) {
-				return add_comparison_condition(comparison_condition, symbols, item_price_data, condition_set);
+				return add_comparison_condition(comparison_condition, context, item_price_data, condition_set);
 			},
 			[&](const ast::array_condition& string_condition) {
-				return add_array_condition(string_condition, symbols, item_price_data, condition_set);
+				return add_array_condition(string_condition, context, item_price_data, condition_set);
 			},
 			[&](const ast::boolean_condition& boolean_condition) {
-				return add_boolean_condition(boolean_condition, symbols, item_price_data, condition_set);
+				return add_boolean_condition(boolean_condition, context, item_price_data, condition_set);
 			},
 			[&](const ast::socket_group_condition& socket_group_condition) {
-				return add_socket_group_condition(socket_group_condition, symbols, item_price_data, condition_set);
+				return add_socket_group_condition(socket_group_condition, context, item_price_data, condition_set);
 			}));
 
 		if (error)
@@ -2,7 +2,7 @@
 
 #include <fs/parser/ast.hpp>
 #include <fs/compiler/error.hpp>
-#include <fs/lang/symbol_table.hpp>
+#include <fs/compiler/detail/evaluation_context.hpp>
 #include <fs/lang/condition_set.hpp>
 #include <fs/lang/item_price_data.hpp>
 
@@ -14,7 +14,7 @@ namespace fs::compiler::detail
 [[nodiscard]] std::optional<compile_error>
 add_conditions(
 	const std::vector<parser::ast::condition>& conditions,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data,
 	lang::condition_set& condition_set);
 
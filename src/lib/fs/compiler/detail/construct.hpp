@@ -2,7 +2,7 @@
 
 #include <fs/parser/ast.hpp>
 #include <fs/lang/object.hpp>
-#include <fs/lang/symbol_table.hpp>
+#include <fs/compiler/detail/evaluation_context.hpp>
 #include <fs/lang/position_tag.hpp>
 #include <fs/lang/item_price_data.hpp>
 #include <fs/lang/traits/promotions.hpp>
@@ -45,7 +45,7 @@ namespace impl
 	template <typename T, typename... Args> [[nodiscard]]
 	std::variant<T, compile_error> unpack_args_and_call_constructor(
 		const parser::ast::value_expression_list& arguments,
-		const lang::symbol_table& /* symbols */,
+		const evaluation_context& /* context */,
 		const lang::item_price_data& /* item_price_data */,
 		lang::traits::constructor_argument_list<>,
 		Args&&... args)
@@ -67,21 +67,21 @@ namespace impl
 	> [[nodiscard]]
 	std::variant<T, compile_error> unpack_args_and_call_constructor(
 		const parser::ast::value_expression_list& arguments,
-		const lang::symbol_table& symbols,
+		const evaluation_context& context,
 		const lang::item_price_data& item_price_data,
 		lang::traits::constructor_argument_list<ConstructorArgType, OtherConstructorArgTypes...>,
 		Args&&... args)
 	{
 		constexpr auto index = sizeof...(Args);
 		std::variant<ConstructorArgType, compile_error> arg_or_error =
-			evaluate_as<ConstructorArgType>(arguments[index], symbols, item_price_data);
+			evaluate_as<ConstructorArgType>(arguments[index], context, item_price_data);
 
 		if (std::holds_alternative<compile_error>(arg_or_error))
 			return std::get<compile_error>(std::move(arg_or_error));
 
 		return unpack_args_and_call_constructor<T>(
 			arguments,
-			symbols,
+			context,
 			item_price_data,
 			lang::traits::constructor_argument_list<OtherConstructorArgTypes...>{},
 			std::forward<Args>(args)...,
@@ -94,7 +94,7 @@ namespace impl
 	template <typename T, typename... ConstructorArgTypes> [[nodiscard]]
 	std::variant<T, compile_error> construct_check_arguments_amount(
 		const parser::ast::value_expression_list& arguments,
-		const lang::symbol_table& symbols,
+		const evaluation_context& context,
 		const lang::item_price_data& item_price_data,
 		lang::traits::constructor_argument_list<ConstructorArgTypes...>)
 	{
@@ -110,7 +110,7 @@ namespace impl
 
 		return unpack_args_and_call_constructor<T>(
 			arguments,
-			symbols,
+			context,
 			item_price_data,
 			lang::traits::constructor_argument_list<ConstructorArgTypes...>{});
 	}
@@ -163,7 +163,7 @@ namespace impl
 	template <typename T, typename... FailedConstructors, typename... Errors> [[nodiscard]]
 	std::variant<T, compile_error> construct_attempt(
 		const parser::ast::function_call& function_call,
-		const lang::symbol_table& symbols,
+		const evaluation_context& context,
 		const lang::item_price_data& item_price_data,
 		lang::traits::constructor_list<> /* ctors_to_attempt */,
 		lang::traits::constructor_list<FailedConstructors...> /* failed_constructors */,
@@ -198,7 +198,7 @@ namespace impl
 
 			return errors::no_matching_constructor_found{
 				lang::type_to_enum<T>(),
-				determine_types_of(function_call.arguments, symbols, item_price_data),
+				determine_types_of(function_call.arguments, context, item_price_data),
 				parser::get_position_info(function_call),
 				std::move(errors)};
 		}
@@ -215,20 +215,20 @@ namespace impl
 	> [[nodiscard]]
 	std::variant<T, compile_error> construct_attempt(
 		const parser::ast::function_call& function_call,
-		const lang::symbol_table& symbols,
+		const evaluation_context& context,
 		const lang::item_price_data& item_price_data,
 		lang::traits::constructor_list<ConstructorArgumentList, OtherConstructorArgumentLists...> /* ctors_to_attempt */,
 		lang::traits::constructor_list<FailedConstructors...> /* failed_constructors */,
 		Errors&&... errors_so_far)
 	{
 		std::variant<T, compile_error> result = construct_check_arguments_amount<T>(
-			function_call.arguments, symbols, item_price_data, ConstructorArgumentList{});
+			function_call.arguments, context, item_price_data, ConstructorArgumentList{});
 
 		if (std::holds_alternative<compile_error>(result))
 		{
 			return construct_attempt<T>(
 				function_call,
-				symbols,
+				context,
 				item_price_data,
 				lang::traits::constructor_list<OtherConstructorArgumentLists...>{},
 				lang::traits::constructor_list<FailedConstructors..., ConstructorArgumentList>{},
@@ -244,11 +244,11 @@ namespace impl
 template <typename T> [[nodiscard]]
 std::variant<T, compile_error> construct(
 	const parser::ast::function_call& function_call,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	using constructors = typename lang::traits::type_traits<T>::allowed_constructors;
-	return impl::construct_attempt<T>(function_call, symbols, item_price_data, constructors{}, lang::traits::constructor_list<>{});
+	return impl::construct_attempt<T>(function_call, context, item_price_data, constructors{}, lang::traits::constructor_list<>{});
 }
 
 }
@@ -8,7 +8,7 @@ namespace fs::compiler::detail
 
 std::vector<std::optional<lang::object_type>> determine_types_of(
 	const parser::ast::value_expression_list& expressions,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	std::vector<std::optional<lang::object_type>> result;
@@ -16,7 +16,7 @@ std::vector<std::optional<lang::object_type>> determine_types_of(
 
 	for (const parser::ast::value_expression& expression : expressions) {
 		std::variant<lang::object, compile_error> object_or_error =
-			evaluate_value_expression(expression, symbols, item_price_data);
+			evaluate_value_expression(expression, context, item_price_data);
 
 		if (std::holds_alternative<lang::object>(object_or_error)) {
 			const auto& object = std::get<lang::object>(object_or_error);
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <fs/parser/ast.hpp>
-#include <fs/lang/symbol_table.hpp>
+#include <fs/compiler/detail/evaluation_context.hpp>
 #include <fs/lang/item_price_data.hpp>
 
 #include <vector>
@@ -18,7 +18,7 @@ namespace fs::compiler::detail
 [[nodiscard]] std::vector<std::optional<lang::object_type>>
 determine_types_of(
 	const parser::ast::value_expression_list& expressions,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data);
 
 }
@@ -8,9 +8,15 @@
 #include <fs/lang/queries.hpp>
 #include <fs/lang/price_range.hpp>
 #include <fs/lang/position_tag.hpp>
+#include <fs/utility/name_table.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <optional>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include <boost/spirit/home/x3/support/utility/lambda_visitor.hpp>
 
@@ -18,6 +24,7 @@ namespace x3 = boost::spirit::x3;
 
 using namespace fs;
 using namespace fs::compiler;
+using fs::compiler::detail::evaluation_context;
 namespace ast = fs::parser::ast;
 
 namespace
@@ -64,7 +71,7 @@ evaluate_literal(
 
 [[nodiscard]] std::optional<errors::non_homogeneous_array>
 verify_array_homogeneity(
-	const lang::array_object& array)
+	const lang::array_object::container_type& array)
 {
 	if (array.empty())
 		return std::nullopt;
@@ -88,15 +95,15 @@ verify_array_homogeneity(
 [[nodiscard]] std::variant<lang::object, compile_error>
 evaluate_array(
 	const ast::array_expression& expression,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	// note: the entire function should work also in case of empty array
-	lang::array_object array;
+	lang::array_object::container_type array;
 	for (const ast::value_expression& value_expression : expression.elements)
 	{
 		std::variant<lang::object, compile_error> object_or_error =
-			compiler::detail::evaluate_value_expression(value_expression, symbols, item_price_data);
+			compiler::detail::evaluate_value_expression(value_expression, context, item_price_data);
 		if (std::holds_alternative<compile_error>(object_or_error))
 			return std::get<compile_error>(std::move(object_or_error));
 
@@ -113,7 +120,7 @@ evaluate_array(
 		return *homogenity_error;
 
 	return lang::object{
-		std::move(array),
+		lang::array_object(std::move(array)),
 		parser::get_position_info(expression)};
 }
 
@@ -156,20 +163,20 @@ subscript_index_to_array_index(int n, int array_size)
 evaluate_subscript(
 	const lang::object& obj,
 	const ast::subscript& subscript,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
-	std::variant<lang::array_object, compile_error> array_or_error =
-		fs::compiler::detail::get_value_as<lang::array_object, false>(obj);
-	if (std::holds_alternative<compile_error>(array_or_error))
-		return std::get<compile_error>(std::move(array_or_error));
+	// do not use get_value_as here, it would copy the array just to take 1 element
+	const auto* const array_ptr = std::get_if<lang::array_object>(&obj.value);
+	if (array_ptr == nullptr)
+		return errors::type_mismatch{lang::object_type::array, obj.type(), obj.value_origin};
 
 	std::variant<lang::integer, compile_error> subscript_or_error =
-		fs::compiler::detail::evaluate_as<lang::integer, false>(subscript.expr, symbols, item_price_data);
+		fs::compiler::detail::evaluate_as<lang::integer, false>(subscript.expr, context, item_price_data);
 	if (std::holds_alternative<compile_error>(subscript_or_error))
 		return std::get<compile_error>(std::move(subscript_or_error));
 
-	auto& array = std::get<lang::array_object>(array_or_error);
+	const lang::array_object& array = *array_ptr;
 	auto& subscript_index = std::get<lang::integer>(subscript_or_error);
 
 	const int array_size = array.size();
@@ -179,278 +186,241 @@ evaluate_subscript(
 		return errors::index_out_of_range{parser::get_position_info(subscript), subscript_index.value, array_size};
 	}
 
-	return lang::object{std::move(array[*index].value), parser::get_position_info(subscript)};
+	return lang::object{array[*index].value, parser::get_position_info(subscript)};
 }
 
+using function_handler = std::variant<lang::object, compile_error> (*)(
+	const ast::function_call&, const evaluation_context&, const lang::item_price_data&);
+
+template <typename T>
 [[nodiscard]] std::variant<lang::object, compile_error>
-evaluate_function_call(
+evaluate_constructor_call(
 	const ast::function_call& function_call,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
-	/*
-	 * right now there is no support for user-defined functions
-	 * so just compare function name against built-in functions
-	 *
-	 * if there is a need to support user-defined functions,
-	 * they can be stored in the symbol_table
-	 */
-	const ast::identifier& function_name = function_call.name;
-	/*
-	 * note: this is O(n) but relying on small string optimization
-	 * and much better memory layout makes it to run faster than a
-	 * tree-based or hash-based map. We can also optimize order of
-	 * comparisons.
-	 */
-	using compiler::detail::construct;
-	if (function_name.value == lang::functions::rgb)
-	{
-		std::variant<lang::color, compile_error> color_or_error = construct<lang::color>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(color_or_error))
-			return std::get<compile_error>(std::move(color_or_error));
+	std::variant<T, compile_error> value_or_error = compiler::detail::construct<T>(function_call, context, item_price_data);
+	if (std::holds_alternative<compile_error>(value_or_error))
+		return std::get<compile_error>(std::move(value_or_error));
 
-		return lang::object{
-			std::get<lang::color>(color_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::level)
-	{
-		std::variant<lang::level, compile_error> level_or_error = construct<lang::level>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(level_or_error))
-			return std::get<compile_error>(std::move(level_or_error));
-
-		return lang::object{
-			std::get<lang::level>(level_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::font_size)
-	{
-		std::variant<lang::font_size, compile_error> font_size_or_error = construct<lang::font_size>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(font_size_or_error))
-			return std::get<compile_error>(std::move(font_size_or_error));
+	return lang::object{
+		std::get<T>(std::move(value_or_error)),
+		parser::get_position_info(function_call)};
+}
 
-		return lang::object{
-			std::get<lang::font_size>(font_size_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::sound_id)
-	{
-		std::variant<lang::sound_id, compile_error> sound_id_or_error = construct<lang::sound_id>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(sound_id_or_error))
-			return std::get<compile_error>(std::move(sound_id_or_error));
+/*
+ * right now there is no support for user-defined functions
+ * so just look up function name in built-in functions
+ *
+ * if there is a need to support user-defined functions,
+ * they can be stored in the symbol_table
+ */
+constexpr utility::name_table<function_handler, 10> built_in_functions(std::array<std::pair<std::string_view, function_handler>, 10>{{
+	{lang::functions::rgb,          &evaluate_constructor_call<lang::color>},
+	{lang::functions::level,        &evaluate_constructor_call<lang::level>},
+	{lang::functions::font_size,    &evaluate_constructor_call<lang::font_size>},
+	{lang::functions::sound_id,     &evaluate_constructor_call<lang::sound_id>},
+	{lang::functions::volume,       &evaluate_constructor_call<lang::volume>},
+	{lang::functions::group,        &evaluate_constructor_call<lang::socket_group>},
+	{lang::functions::minimap_icon, &evaluate_constructor_call<lang::minimap_icon>},
+	{lang::functions::beam_effect,  &evaluate_constructor_call<lang::beam_effect>},
+	{lang::functions::path,         &evaluate_constructor_call<lang::path>},
+	{lang::functions::alert_sound,  &evaluate_constructor_call<lang::alert_sound>}
+}});
 
-		return lang::object{
-			std::get<lang::sound_id>(sound_id_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::volume)
-	{
-		std::variant<lang::volume, compile_error> volume_or_error = construct<lang::volume>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(volume_or_error))
-			return std::get<compile_error>(std::move(volume_or_error));
+[[nodiscard]] std::variant<lang::object, compile_error>
+evaluate_function_call(
+	const ast::function_call& function_call,
+	const evaluation_context& context,
+	const lang::item_price_data& item_price_data)
+{
+	const ast::identifier& function_name = function_call.name;
+	if (const function_handler* const handler = built_in_functions.find(function_name.value); handler != nullptr)
+		return (*handler)(function_call, context, item_price_data);
 
-		return lang::object{
-			std::get<lang::volume>(volume_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::group)
-	{
-		std::variant<lang::socket_group, compile_error> socket_group_or_error = construct<lang::socket_group>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(socket_group_or_error))
-			return std::get<compile_error>(std::move(socket_group_or_error));
+	return errors::no_such_function{parser::get_position_info(function_name)};
+}
 
-		return lang::object{
-			std::get<lang::socket_group>(socket_group_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::minimap_icon)
-	{
-		std::variant<lang::minimap_icon, compile_error> icon_or_error = construct<lang::minimap_icon>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(icon_or_error))
-			return std::get<compile_error>(std::move(icon_or_error));
+using query_handler = lang::object (*)(lang::price_range, lang::position_tag, const lang::item_price_data&);
 
-		return lang::object{
-			std::get<lang::minimap_icon>(icon_or_error),
-			parser::get_position_info(function_call)};
+// TODO this is too complex - move the code to item_price_data when the interface of it
+// is decided upon (think what to do with is_low_confidence). Right now there are no
+// invariants in item_price_data so we do a lot of find/for-each algorithms.
+template <typename Items, typename PriceFunc, typename NameFunc>
+[[nodiscard]] lang::object
+run_price_range_query(
+	const Items& items,
+	lang::price_range price_range,
+	lang::position_tag position_of_query,
+	PriceFunc price_func,
+	NameFunc name_func)
+{
+	// elements have no origins of their own - results are shared by all places
+	// which run the same query (see query_cache), only the array has an origin
+	lang::array_object::container_type array;
+	for (auto it = items.begin(); it != items.end(); ++it) {
+		if (price_range.contains(price_func(it))) {
+			array.push_back(lang::object{lang::string{name_func(it)}, lang::position_tag{}});
+		}
 	}
-	else if (function_name.value == lang::functions::beam_effect)
-	{
-		std::variant<lang::beam_effect, compile_error> beam_effect_or_error = construct<lang::beam_effect>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(beam_effect_or_error))
-			return std::get<compile_error>(std::move(beam_effect_or_error));
+	return lang::object{lang::array_object(std::move(array)), position_of_query};
+}
 
-		return lang::object{
-			std::get<lang::beam_effect>(beam_effect_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::path)
-	{
-		std::variant<lang::path, compile_error> path_or_error = construct<lang::path>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(path_or_error))
-			return std::get<compile_error>(std::move(path_or_error));
+template <std::vector<lang::elementary_item> lang::item_price_data::*Items>
+[[nodiscard]] lang::object
+query_elementary_items(
+	lang::price_range price_range,
+	lang::position_tag position_of_query,
+	const lang::item_price_data& item_price_data)
+{
+	return run_price_range_query(
+		item_price_data.*Items,
+		price_range,
+		position_of_query,
+		[](auto it) { return it->price.chaos_value; },
+		[](auto it) { return it->name; });
+}
 
-		return lang::object{
-			std::get<lang::path>(path_or_error),
-			parser::get_position_info(function_call)};
-	}
-	else if (function_name.value == lang::functions::alert_sound)
-	{
-		std::variant<lang::alert_sound, compile_error> alert_sound_or_error = construct<lang::alert_sound>(function_call, symbols, item_price_data);
-		if (std::holds_alternative<compile_error>(alert_sound_or_error))
-			return std::get<compile_error>(std::move(alert_sound_or_error));
+[[nodiscard]] lang::object
+query_divination_cards(
+	lang::price_range price_range,
+	lang::position_tag position_of_query,
+	const lang::item_price_data& item_price_data)
+{
+	return run_price_range_query( // TODO use complex query later
+		item_price_data.divination_cards,
+		price_range,
+		position_of_query,
+		[](auto it) { return it->price.chaos_value; },
+		[](auto it) { return it->name; });
+}
 
-		return lang::object{
-			std::get<lang::alert_sound>(alert_sound_or_error),
-			parser::get_position_info(function_call)};
-	}
+template <lang::unique_item_price_data lang::item_price_data::*Uniques>
+[[nodiscard]] lang::object
+query_unambiguous_unique_items(
+	lang::price_range price_range,
+	lang::position_tag position_of_query,
+	const lang::item_price_data& item_price_data)
+{
+	return run_price_range_query(
+		(item_price_data.*Uniques).unambiguous,
+		price_range,
+		position_of_query,
+		[](auto it) { return it->second.price.chaos_value; },
+		[](auto it) { return it->first; });
+}
 
-	return errors::no_such_function{parser::get_position_info(function_name)};
+template <lang::unique_item_price_data lang::item_price_data::*Uniques>
+[[nodiscard]] lang::object
+query_ambiguous_unique_items(
+	lang::price_range price_range,
+	lang::position_tag position_of_query,
+	const lang::item_price_data& item_price_data)
+{
+	return run_price_range_query(
+		(item_price_data.*Uniques).ambiguous,
+		price_range,
+		position_of_query,
+		[](auto it) {
+			auto& items = it->second;
+			return std::max_element(
+				items.begin(),
+				items.end(),
+				[](const auto& lhs, const auto& rhs) {
+					return lhs.price.chaos_value < rhs.price.chaos_value;
+				})->price.chaos_value;
+		},
+		[](auto it) { return it->first; });
 }
 
+constexpr utility::name_table<query_handler, 17> price_range_queries(std::array<std::pair<std::string_view, query_handler>, 17>{{
+	{lang::queries::divination,                &query_divination_cards},
+	{lang::queries::oils,                      &query_elementary_items<&lang::item_price_data::oils>},
+	{lang::queries::incubators,                &query_elementary_items<&lang::item_price_data::incubators>},
+	{lang::queries::essences,                  &query_elementary_items<&lang::item_price_data::essences>},
+	{lang::queries::fossils,                   &query_elementary_items<&lang::item_price_data::fossils>},
+	{lang::queries::prophecies,                &query_elementary_items<&lang::item_price_data::prophecies>},
+	{lang::queries::resonators,                &query_elementary_items<&lang::item_price_data::resonators>},
+	{lang::queries::scarabs,                   &query_elementary_items<&lang::item_price_data::scarabs>},
+	{lang::queries::helmet_enchants,           &query_elementary_items<&lang::item_price_data::helmet_enchants>},
+	{lang::queries::uniques_eq_ambiguous,      &query_ambiguous_unique_items<&lang::item_price_data::unique_eq>},
+	{lang::queries::uniques_eq_unambiguous,    &query_unambiguous_unique_items<&lang::item_price_data::unique_eq>},
+	{lang::queries::uniques_flask_ambiguous,   &query_ambiguous_unique_items<&lang::item_price_data::unique_flasks>},
+	{lang::queries::uniques_flask_unambiguous, &query_unambiguous_unique_items<&lang::item_price_data::unique_flasks>},
+	{lang::queries::uniques_jewel_ambiguous,   &query_ambiguous_unique_items<&lang::item_price_data::unique_jewels>},
+	{lang::queries::uniques_jewel_unambiguous, &query_unambiguous_unique_items<&lang::item_price_data::unique_jewels>},
+	{lang::queries::uniques_map_ambiguous,     &query_ambiguous_unique_items<&lang::item_price_data::unique_maps>},
+	{lang::queries::uniques_map_unambiguous,   &query_unambiguous_unique_items<&lang::item_price_data::unique_maps>}
+}});
+
 [[nodiscard]] std::variant<lang::object, compile_error>
 evaluate_price_range_query(
 	const ast::price_range_query& price_range_query,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	std::variant<lang::price_range, compile_error> range_or_error =
-		compiler::detail::construct_price_range(price_range_query.arguments, symbols, item_price_data);
+		compiler::detail::construct_price_range(price_range_query.arguments, context, item_price_data);
 	if (std::holds_alternative<compile_error>(range_or_error))
 		return std::get<compile_error>(std::move(range_or_error));
 
 	const auto& price_range = std::get<lang::price_range>(range_or_error);
 	const lang::position_tag position_of_query = parser::get_position_info(price_range_query);
-
-	// TODO this is too complex - move the code to item_price_data when the interface of it
-	// is decided upon (think what to do with is_low_confidence). Right now there are no
-	// invariants in item_price_data so we do a lot of find/for-each algorithms.
-	const auto eval_query = [&](const auto& items, auto price_func, auto name_func) {
-		lang::array_object array;
-		for (auto it = items.begin(); it != items.end(); ++it) {
-			if (price_range.contains(price_func(it))) {
-				array.push_back(lang::object{lang::string{name_func(it)}, position_of_query});
-			}
-		}
-		return lang::object{std::move(array), position_of_query};
-	};
-	const auto eval_query_elementary_items = [&](const auto& items) {
-		return eval_query(items, [](auto it) { return it->price.chaos_value; }, [](auto it) { return it->name; });
-	};
-	const auto eval_query_unamb_unique_items = [&](const auto& items) {
-		return eval_query(items, [](auto it) { return it->second.price.chaos_value; }, [](auto it) { return it->first; });
-	};
-	const auto eval_query_amb_unique_items = [&](const auto& items) {
-		return eval_query(
-			items,
-			[](auto it) {
-				auto& items = it->second;
-				return std::max_element(
-					items.begin(),
-					items.end(),
-					[](const auto& lhs, const auto& rhs) {
-						return lhs.price.chaos_value < rhs.price.chaos_value;
-					})->price.chaos_value;
-			},
-			[](auto it) { return it->first; });
-	};
-	/*
-	 * note: this is O(n) but relying on small string optimization
-	 * and much better memory layout makes it to run faster than a
-	 * tree-based or hash-based map. We can also optimize order of
-	 * comparisons.
-	 */
 	const ast::identifier& query_name = price_range_query.name;
-	if (query_name.value == lang::queries::divination) {
-		return eval_query_elementary_items(item_price_data.divination_cards); // TODO use complex query later
-	}
-	else if (query_name.value == lang::queries::oils) {
-		return eval_query_elementary_items(item_price_data.prophecies);
-	}
-	else if (query_name.value == lang::queries::incubators) {
-		return eval_query_elementary_items(item_price_data.prophecies);
-	}
-	else if (query_name.value == lang::queries::essences) {
-		return eval_query_elementary_items(item_price_data.essences);
-	}
-	else if (query_name.value == lang::queries::fossils) {
-		return eval_query_elementary_items(item_price_data.fossils);
-	}
-	else if (query_name.value == lang::queries::prophecies) {
-		return eval_query_elementary_items(item_price_data.prophecies);
-	}
-	else if (query_name.value == lang::queries::resonators) {
-		return eval_query_elementary_items(item_price_data.resonators);
-	}
-	else if (query_name.value == lang::queries::scarabs) {
-		return eval_query_elementary_items(item_price_data.scarabs);
-	}
-	else if (query_name.value == lang::queries::helmet_enchants) {
-		return eval_query_elementary_items(item_price_data.helmet_enchants);
-	}
-	else if (query_name.value == lang::queries::uniques_eq_ambiguous) {
-		return eval_query_amb_unique_items(item_price_data.unique_eq.ambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_eq_unambiguous) {
-		return eval_query_unamb_unique_items(item_price_data.unique_eq.unambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_flask_ambiguous) {
-		return eval_query_amb_unique_items(item_price_data.unique_flasks.ambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_flask_unambiguous) {
-		return eval_query_unamb_unique_items(item_price_data.unique_flasks.unambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_jewel_ambiguous) {
-		return eval_query_amb_unique_items(item_price_data.unique_jewels.ambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_jewel_unambiguous) {
-		return eval_query_unamb_unique_items(item_price_data.unique_jewels.unambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_map_ambiguous) {
-		return eval_query_amb_unique_items(item_price_data.unique_maps.ambiguous);
-	}
-	else if (query_name.value == lang::queries::uniques_map_unambiguous) {
-		return eval_query_unamb_unique_items(item_price_data.unique_maps.unambiguous);
-	}
 
-	return errors::no_such_query{parser::get_position_info(query_name)};
+	const query_handler* const handler = price_range_queries.find(query_name.value);
+	if (handler == nullptr)
+		return errors::no_such_query{parser::get_position_info(query_name)};
+
+	if (context.queries != nullptr)
+		if (std::optional<lang::array_object> cached = context.queries->find(query_name.value, price_range); cached)
+			return lang::object{*std::move(cached), position_of_query};
+
+	lang::object result = (*handler)(price_range, position_of_query, item_price_data);
+
+	if (context.queries != nullptr)
+		context.queries->store(query_name.value, price_range, std::get<lang::array_object>(result.value));
+
+	return result;
 }
 
 [[nodiscard]] std::variant<lang::object, compile_error>
 evaluate_identifier(
 	const ast::identifier& identifier,
-	const lang::symbol_table& symbols)
+	const evaluation_context& context)
 {
 	const lang::position_tag place_of_name = parser::get_position_info(identifier);
 
-	const auto it = symbols.find(identifier.value);
-	if (it == symbols.end())
+	const lang::symbol_id id = context.references.id_of(identifier);
+	if (id == lang::invalid_symbol_id)
 		return errors::no_such_name{place_of_name};
 
-	return lang::object{it->second.object_instance.value, place_of_name};
+	// cheap - arrays and compound actions are shared, not copied
+	return lang::object{context.symbols[id].second.object_instance.value, place_of_name};
 }
 
 [[nodiscard]] std::variant<lang::object, compile_error>
 evaluate_compound_action(
 	const ast::compound_action_expression& expr,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	lang::action_set actions;
 
 	for (const ast::action& act : expr) {
-		std::optional<compile_error> error = detail::add_action(act, symbols, item_price_data, actions);
+		std::optional<compile_error> error = detail::add_action(act, context, item_price_data, actions);
 
 		if (error)
 			return *std::move(error);
 	}
 
-	return lang::object{std::move(actions), parser::get_position_info(expr)};
+	return lang::object{lang::action_set_object(std::move(actions)), parser::get_position_info(expr)};
 }
 
 [[nodiscard]] std::variant<lang::object, compile_error>
 evaluate_primary_expression(
 	const ast::primary_expression& primary_expression,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	using result_type = std::variant<lang::object, compile_error>;
@@ -460,19 +430,19 @@ evaluate_primary_expression(
 			return evaluate_literal(literal);
 		},
 		[&](const ast::array_expression& array) {
-			return evaluate_array(array, symbols, item_price_data);
+			return evaluate_array(array, context, item_price_data);
 		},
 		[&](const ast::function_call& function_call) {
-			return evaluate_function_call(function_call, symbols, item_price_data);
+			return evaluate_function_call(function_call, context, item_price_data);
 		},
 		[&](const ast::price_range_query& price_range_query) {
-			return evaluate_price_range_query(price_range_query, symbols, item_price_data);
+			return evaluate_price_range_query(price_range_query, context, item_price_data);
 		},
 		[&](const ast::identifier& identifier) {
-			return evaluate_identifier(identifier, symbols);
+			return evaluate_identifier(identifier, context);
 		},
 		[&](const ast::compound_action_expression& expr) {
-			return evaluate_compound_action(expr, symbols, item_price_data);
+			return evaluate_compound_action(expr, context, item_price_data);
 		}
 	));
 }
@@ -485,19 +455,19 @@ namespace fs::compiler::detail
 std::variant<lang::object, compile_error>
 evaluate_value_expression(
 	const ast::value_expression& value_expression,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	using result_type = std::variant<lang::object, compile_error>;
 
-	result_type result = evaluate_primary_expression(value_expression.primary_expr, symbols, item_price_data);
+	result_type result = evaluate_primary_expression(value_expression.primary_expr, context, item_price_data);
 	if (std::holds_alternative<compile_error>(result))
 		return std::get<compile_error>(std::move(result));
 
 	auto& obj = std::get<lang::object>(result);
 	for (auto& expr : value_expression.postfix_exprs)
 	{
-		result_type res = evaluate_subscript(obj, expr.expr, symbols, item_price_data);
+		result_type res = evaluate_subscript(obj, expr.expr, context, item_price_data);
 		if (std::holds_alternative<compile_error>(res))
 			return std::get<compile_error>(std::move(res));
 		else
@@ -12,10 +12,10 @@ template <typename T, bool AllowPromotions = true>
 [[nodiscard]] std::variant<T, compile_error>
 evaluate_as(
 	const parser::ast::value_expression& expression,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
-	std::variant<lang::object, compile_error> object_or_error = evaluate_value_expression(expression, symbols, item_price_data);
+	std::variant<lang::object, compile_error> object_or_error = evaluate_value_expression(expression, context, item_price_data);
 
 	if (std::holds_alternative<compile_error>(object_or_error))
 		return std::get<compile_error>(std::move(object_or_error));
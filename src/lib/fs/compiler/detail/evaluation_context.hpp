@@ -0,0 +1,19 @@
+#pragma once
+
+#include <fs/compiler/query_cache.hpp>
+#include <fs/compiler/symbol_references.hpp>
+#include <fs/lang/symbol_table.hpp>
+
+namespace fs::compiler::detail
+{
+
+// everything (except item price data) that expressions can refer to
+struct evaluation_context
+{
+	const lang::symbol_table& symbols;
+	const symbol_references& references;
+	// results of price queries - can be null
+	query_cache* queries = nullptr;
+};
+
+}
@@ -11,6 +11,7 @@ namespace
 
 using namespace fs;
 using fs::compiler::compile_error;
+using fs::compiler::detail::evaluation_context;
 
 [[nodiscard]] std::variant<std::optional<double>, compile_error>
 evaluate_range_value(const lang::object& obj)
@@ -40,14 +41,14 @@ namespace fs::compiler::detail
 std::variant<lang::price_range, compile_error>
 construct_price_range(
 	const parser::ast::value_expression_list& arguments,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data)
 {
 	const int arguments_amount = arguments.size();
 	if (arguments_amount != 2)
 		return errors::invalid_amount_of_arguments{2, arguments_amount, parser::get_position_info(arguments)};
 
-	std::variant<lang::object, compile_error> min_or_error = evaluate_value_expression(arguments[0], symbols, item_price_data);
+	std::variant<lang::object, compile_error> min_or_error = evaluate_value_expression(arguments[0], context, item_price_data);
 	if (std::holds_alternative<compile_error>(min_or_error))
 		return std::get<compile_error>(std::move(min_or_error));
 
@@ -56,7 +57,7 @@ construct_price_range(
 	if (std::holds_alternative<compile_error>(min_val_or_error))
 		return std::get<compile_error>(std::move(min_val_or_error));
 
-	std::variant<lang::object, compile_error> max_or_error = evaluate_value_expression(arguments[1], symbols, item_price_data);
+	std::variant<lang::object, compile_error> max_or_error = evaluate_value_expression(arguments[1], context, item_price_data);
 	if (std::holds_alternative<compile_error>(max_or_error))
 		return std::get<compile_error>(std::move(max_or_error));
 
@@ -2,7 +2,7 @@
 
 #include <fs/parser/ast.hpp>
 #include <fs/compiler/error.hpp>
-#include <fs/lang/symbol_table.hpp>
+#include <fs/compiler/detail/evaluation_context.hpp>
 #include <fs/lang/price_range.hpp>
 #include <fs/lang/item_price_data.hpp>
 
@@ -14,7 +14,7 @@ namespace fs::compiler::detail
 [[nodiscard]] std::variant<lang::price_range, compile_error>
 construct_price_range(
 	const parser::ast::value_expression_list& arguments,
-	const lang::symbol_table& symbols,
+	const evaluation_context& context,
 	const lang::item_price_data& item_price_data);
 
 }
@@ -3,6 +3,7 @@
 #include <fs/lang/object.hpp>
 #include <fs/lang/position_tag.hpp>
 
+#include <string>
 #include <variant>
 #include <vector>
 #include <optional>
@@ -117,6 +118,20 @@ struct upper_bound_redefinition
 	lang::position_tag place_of_original_definition;
 };
 
+struct failed_import
+{
+	lang::position_tag place_of_import;
+	std::string path;
+	// already formatted description, errors of imported files refer to their own source
+	std::string description;
+};
+
+struct import_cycle
+{
+	lang::position_tag place_of_import;
+	std::string path;
+};
+
 struct internal_compiler_error_during_action_evaluation
 {
 	lang::position_tag place_of_action;
@@ -166,6 +181,8 @@ using compile_error = std::variant<
 	errors::condition_redefinition,
 	errors::lower_bound_redefinition,
 	errors::upper_bound_redefinition,
+	errors::failed_import,
+	errors::import_cycle,
 	errors::internal_compiler_error_during_action_evaluation,
 	errors::internal_compiler_error_during_range_evaluation,
 	errors::internal_compiler_error_during_comparison_condition_evaluation,
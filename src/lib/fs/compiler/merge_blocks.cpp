@@ -0,0 +1,197 @@
+#include <fs/compiler/merge_blocks.hpp>
+#include <fs/lang/condition_set.hpp>
+#include <fs/utility/string_builder.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace
+{
+
+using namespace fs;
+
+template <typename T>
+bool equal(const lang::range_condition<T>& a, const lang::range_condition<T>& b)
+{
+	return a.lower_bound == b.lower_bound && a.upper_bound == b.upper_bound;
+}
+
+bool equal(const std::optional<lang::boolean_condition>& a, const std::optional<lang::boolean_condition>& b)
+{
+	if (a.has_value() != b.has_value())
+		return false;
+
+	return !a.has_value() || (*a).value == (*b).value;
+}
+
+bool equal(const std::optional<lang::socket_group_condition>& a, const std::optional<lang::socket_group_condition>& b)
+{
+	if (a.has_value() != b.has_value())
+		return false;
+
+	return !a.has_value() || (*a).group == (*b).group;
+}
+
+bool equal(const lang::influences_condition& a, const lang::influences_condition& b)
+{
+	if (a.influences == b.influences)
+		return a.influences == nullptr || a.exact_match_required == b.exact_match_required;
+
+	if (a.influences == nullptr || b.influences == nullptr)
+		return false;
+
+	return a.exact_match_required == b.exact_match_required && *a.influences == *b.influences;
+}
+
+bool equal(const lang::strings_condition& a, const lang::strings_condition& b)
+{
+	if (a.strings == b.strings)
+		return a.strings == nullptr || a.exact_match_required == b.exact_match_required;
+
+	if (a.strings == nullptr || b.strings == nullptr)
+		return false;
+
+	return a.exact_match_required == b.exact_match_required && *a.strings == *b.strings;
+}
+
+bool equal_except_strings(const lang::condition_set& a, const lang::condition_set& b)
+{
+	return equal(a.item_level, b.item_level)
+		&& equal(a.drop_level, b.drop_level)
+		&& equal(a.quality, b.quality)
+		&& equal(a.rarity, b.rarity)
+		&& equal(a.sockets, b.sockets)
+		&& equal(a.links, b.links)
+		&& equal(a.height, b.height)
+		&& equal(a.width, b.width)
+		&& equal(a.stack_size, b.stack_size)
+		&& equal(a.gem_level, b.gem_level)
+		&& equal(a.map_tier, b.map_tier)
+		&& equal(a.is_identified, b.is_identified)
+		&& equal(a.is_corrupted, b.is_corrupted)
+		&& equal(a.is_elder_item, b.is_elder_item)
+		&& equal(a.is_shaper_item, b.is_shaper_item)
+		&& equal(a.is_fractured_item, b.is_fractured_item)
+		&& equal(a.is_synthesised_item, b.is_synthesised_item)
+		&& equal(a.is_enchanted, b.is_enchanted)
+		&& equal(a.is_shaped_map, b.is_shaped_map)
+		&& equal(a.is_elder_map, b.is_elder_map)
+		&& equal(a.is_blighted_map, b.is_blighted_map)
+		&& equal(a.socket_group, b.socket_group)
+		&& equal(a.has_influence, b.has_influence);
+}
+
+// all string conditions mean "any of listed strings", so lists can be joined
+constexpr std::array<lang::strings_condition lang::condition_set::*, 5> strings_conditions = {
+	&lang::condition_set::class_,
+	&lang::condition_set::base_type,
+	&lang::condition_set::has_explicit_mod,
+	&lang::condition_set::has_enchantment,
+	&lang::condition_set::prophecy
+};
+
+std::shared_ptr<std::vector<std::string>> join_lists(
+	const std::vector<std::string>& first,
+	const std::vector<std::string>& second)
+{
+	auto result = std::make_shared<std::vector<std::string>>(first);
+	const std::unordered_set<std::string> present(first.begin(), first.end());
+	for (const std::string& str : second)
+		if (present.count(str) == 0)
+			result->push_back(str);
+
+	return result;
+}
+
+std::size_t count_lines(const lang::filter_block& block)
+{
+	utility::string_builder text;
+	block.generate(text);
+	return static_cast<std::size_t>(std::count(text.str().begin(), text.str().end(), '\n'));
+}
+
+// merges 'next' into 'target' if possible
+bool try_merge(lang::filter_block& target, const lang::filter_block& next)
+{
+	if (target.show != next.show)
+		return false;
+
+	// actions are interned by build_filter_blocks - equal ones are the same instance
+	if (!target.actions.shares_value_with(next.actions))
+		return false;
+
+	if (target.conditions.shares_value_with(next.conditions))
+		return true;
+
+	const lang::condition_set& a = *target.conditions;
+	const lang::condition_set& b = *next.conditions;
+	if (!equal_except_strings(a, b))
+		return false;
+
+	std::optional<lang::strings_condition lang::condition_set::*> different;
+	for (auto member : strings_conditions) {
+		if (equal(a.*member, b.*member))
+			continue;
+
+		if (different)
+			return false;
+
+		different = member;
+	}
+
+	if (!different)
+		return true;
+
+	const lang::strings_condition& cond_a = a.**different;
+	const lang::strings_condition& cond_b = b.**different;
+	if (cond_a.strings == nullptr || cond_b.strings == nullptr
+		|| cond_a.exact_match_required != cond_b.exact_match_required)
+	{
+		return false;
+	}
+
+	auto joined = join_lists(*cond_a.strings, *cond_b.strings);
+	(target.conditions.edit().**different).strings = std::move(joined);
+	return true;
+}
+
+}
+
+namespace fs::compiler
+{
+
+merge_statistics merge_adjacent_blocks(std::vector<lang::filter_block>& blocks)
+{
+	merge_statistics stats;
+	// index (in the result) of the last block that will be generated
+	std::optional<std::size_t> last_valid;
+	std::size_t kept = 0;
+
+	for (std::size_t i = 0; i < blocks.size(); ++i) {
+		const bool is_valid = blocks[i].conditions->is_valid();
+
+		if (is_valid && last_valid && try_merge(blocks[*last_valid], blocks[i])) {
+			++stats.merged_blocks;
+			stats.saved_lines += count_lines(blocks[i]);
+			continue;
+		}
+
+		if (kept != i)
+			blocks[kept] = std::move(blocks[i]);
+
+		if (is_valid)
+			last_valid = kept;
+
+		++kept;
+	}
+
+	blocks.erase(blocks.begin() + kept, blocks.end());
+	return stats;
+}
+
+}
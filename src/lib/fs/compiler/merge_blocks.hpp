@@ -0,0 +1,38 @@
+#pragma once
+
+#include <fs/lang/filter_block.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace fs::compiler
+{
+
+struct merge_statistics
+{
+	// number of blocks merged into the preceding block
+	std::size_t merged_blocks = 0;
+	// number of lines of the generated filter which are no longer emitted
+	std::size_t saved_lines = 0;
+};
+
+/**
+ * @brief merge consecutive blocks which differ only in one list of strings
+ *
+ * @details Two adjacent blocks with the same visibility and actions whose
+ * conditions are equal except one string list (eg BaseType) are replaced
+ * by one block with the union of both lists. The game applies the first
+ * matching block, but both blocks do the same to an item, so it does not
+ * matter which one matches first. Blocks with identical conditions are
+ * merged too (the latter one could not be reached). Invalid blocks are
+ * not generated, so they do not separate blocks.
+ *
+ * Merged lists keep the order of strings, without repetitions.
+ *
+ * Actions are compared by address - blocks from build_filter_blocks share
+ * all equal action sets. Blocks with equal but separate action sets are
+ * not merged.
+ */
+merge_statistics merge_adjacent_blocks(std::vector<lang::filter_block>& blocks);
+
+}
@@ -0,0 +1,75 @@
+#include <fs/compiler/minimize_lists.hpp>
+#include <fs/lang/condition_set.hpp>
+#include <fs/utility/copy_on_write.hpp>
+#include <fs/utility/substring_patterns.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace fs::compiler
+{
+
+std::size_t minimize_string_lists(std::vector<lang::filter_block>& blocks)
+{
+	using utility::copy_on_write;
+	using string_list = std::vector<std::string>;
+
+	constexpr lang::strings_condition lang::condition_set::* string_conditions[] = {
+		&lang::condition_set::class_,
+		&lang::condition_set::base_type,
+		&lang::condition_set::has_explicit_mod,
+		&lang::condition_set::has_enchantment,
+		&lang::condition_set::prophecy
+	};
+
+	std::size_t removed = 0;
+
+	// (the originals are kept so that their addresses can not be reused while in the maps)
+	using minimized_list = std::pair<std::shared_ptr<string_list>, std::shared_ptr<string_list>>;
+	std::unordered_map<const string_list*, minimized_list> lists;
+	const auto minimize = [&](const std::shared_ptr<string_list>& strings) {
+		if (const auto it = lists.find(strings.get()); it != lists.end())
+			return it->second.second;
+
+		auto minimal = std::make_shared<string_list>(*strings);
+		utility::minimize_substring_patterns(*minimal);
+		if (*minimal == *strings)
+			minimal = strings;
+		else
+			removed += strings->size() - minimal->size();
+
+		lists.emplace(strings.get(), minimized_list{strings, minimal});
+		return minimal;
+	};
+
+	using minimized_set = std::pair<copy_on_write<lang::condition_set>, copy_on_write<lang::condition_set>>;
+	std::unordered_map<const lang::condition_set*, minimized_set> condition_sets;
+
+	for (lang::filter_block& block : blocks) {
+		const lang::condition_set* const original = &*block.conditions;
+		if (const auto it = condition_sets.find(original); it != condition_sets.end()) {
+			block.conditions = it->second.second;
+			continue;
+		}
+
+		copy_on_write<lang::condition_set> minimized = block.conditions;
+		for (auto member : string_conditions) {
+			const lang::strings_condition& condition = (*minimized).*member;
+			if (condition.strings == nullptr || condition.exact_match_required)
+				continue;
+
+			std::shared_ptr<string_list> minimal = minimize(condition.strings);
+			if (minimal != condition.strings)
+				(minimized.edit().*member).strings = std::move(minimal);
+		}
+
+		condition_sets.emplace(original, minimized_set{block.conditions, minimized});
+		block.conditions = std::move(minimized);
+	}
+
+	return removed;
+}
+
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <fs/lang/filter_block.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace fs::compiler
+{
+
+/**
+ * @brief minimize string lists of non-exact conditions
+ *
+ * @details Without == the game matches strings by substring, so a list
+ * needs no duplicates and no entry which contains another entry (eg
+ * "Sapphire Ring" next to "Ring"). Such lists are replaced by their sorted,
+ * minimal equivalent. Each distinct list is minimized only once and
+ * blocks keep sharing their condition sets. Exact lists are not changed.
+ *
+ * @return number of removed strings (counted once per distinct list)
+ */
+std::size_t minimize_string_lists(std::vector<lang::filter_block>& blocks);
+
+}
@@ -0,0 +1,408 @@
+#include <fs/compiler/module_cache.hpp>
+#include <fs/lang/object.hpp>
+#include <fs/utility/dump_json.hpp>
+#include <fs/utility/file.hpp>
+#include <fs/utility/hash.hpp>
+#include <fs/version.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+
+using namespace fs;
+using json = nlohmann::json;
+
+constexpr auto field_version = "version";
+constexpr auto field_directory = "directory";
+constexpr auto field_dependencies = "dependencies";
+constexpr auto field_path = "path";
+constexpr auto field_digest = "digest";
+constexpr auto field_symbols = "symbols";
+constexpr auto field_type = "type";
+constexpr auto field_value = "value";
+
+std::string version_string()
+{
+	namespace v = version;
+	return std::to_string(v::major) + "." + std::to_string(v::minor) + "." + std::to_string(v::patch);
+}
+
+// ---- serialization of objects ----
+
+json object_to_json(const lang::object& obj);
+
+json value_to_json(lang::none) { return nullptr; }
+json value_to_json(lang::boolean b) { return b.value; }
+json value_to_json(lang::floating_point fp) { return fp.value; }
+json value_to_json(lang::integer n) { return n.value; }
+json value_to_json(lang::level l) { return l.value; }
+json value_to_json(lang::font_size fs) { return fs.value; }
+json value_to_json(lang::sound_id id) { return id.value; }
+json value_to_json(lang::volume v) { return v.value; }
+json value_to_json(lang::socket_group sg) { return json::array({sg.r, sg.g, sg.b, sg.w}); }
+json value_to_json(lang::influence i) { return static_cast<int>(i); }
+json value_to_json(lang::rarity r) { return static_cast<int>(r); }
+json value_to_json(lang::shape s) { return static_cast<int>(s); }
+json value_to_json(lang::suit s) { return static_cast<int>(s); }
+json value_to_json(const lang::string& str) { return str.value; }
+json value_to_json(const lang::path& p) { return p.value; }
+json value_to_json(const lang::custom_alert_sound& cas) { return cas.path.value; }
+
+json value_to_json(lang::color c)
+{
+	json result = json::array({c.r, c.g, c.b});
+	if (c.a)
+		result.push_back(*c.a);
+
+	return result;
+}
+
+json value_to_json(lang::minimap_icon icon)
+{
+	return json::array({icon.size.value, static_cast<int>(icon.color), static_cast<int>(icon.shape)});
+}
+
+json value_to_json(lang::beam_effect beam)
+{
+	return json::array({static_cast<int>(beam.color), beam.is_temporary});
+}
+
+json value_to_json(lang::built_in_alert_sound sound)
+{
+	return json::array({
+		sound.id.value,
+		sound.volume ? json((*sound.volume).value) : json(nullptr),
+		sound.is_positional.value});
+}
+
+json value_to_json(const lang::alert_sound& sound)
+{
+	// built-in sounds are arrays, custom sounds are strings
+	return std::visit([](const auto& s) { return value_to_json(s); }, sound.sound);
+}
+
+json value_to_json(const lang::array_object& array)
+{
+	json result = json::array();
+	for (const lang::object& obj : array)
+		result.push_back(object_to_json(obj));
+
+	return result;
+}
+
+template <typename T>
+json optional_to_json(const std::optional<T>& opt)
+{
+	return opt ? value_to_json(*opt) : json(nullptr);
+}
+
+json value_to_json(const lang::action_set& actions)
+{
+	return json::array({
+		optional_to_json(actions.border_color),
+		optional_to_json(actions.text_color),
+		optional_to_json(actions.background_color),
+		optional_to_json(actions.font_size),
+		optional_to_json(actions.alert_sound),
+		actions.disabled_drop_sound,
+		optional_to_json(actions.minimap_icon),
+		optional_to_json(actions.beam_effect)});
+}
+
+json value_to_json(const lang::action_set_object& actions)
+{
+	return value_to_json(*actions);
+}
+
+json object_to_json(const lang::object& obj)
+{
+	return json{
+		{field_type, std::string(lang::to_string_view(obj.type()))},
+		{field_value, std::visit([](const auto& value) { return value_to_json(value); }, obj.value)}
+	};
+}
+
+// ---- deserialization of objects ----
+// malformed input results in an exception, functions are only called within a try block
+
+lang::object object_from_json(const json& j);
+
+template <typename T>
+T value_from_json(const json& j);
+
+template <> lang::none value_from_json(const json&) { return lang::none{}; }
+template <> lang::boolean value_from_json(const json& j) { return lang::boolean{j.get<bool>()}; }
+template <> lang::floating_point value_from_json(const json& j) { return lang::floating_point(j.get<double>()); }
+template <> lang::integer value_from_json(const json& j) { return lang::integer{j.get<int>()}; }
+template <> lang::level value_from_json(const json& j) { return lang::level(j.get<int>()); }
+template <> lang::font_size value_from_json(const json& j) { return lang::font_size(j.get<int>()); }
+template <> lang::sound_id value_from_json(const json& j) { return lang::sound_id(j.get<int>()); }
+template <> lang::volume value_from_json(const json& j) { return lang::volume(j.get<int>()); }
+template <> lang::influence value_from_json(const json& j) { return static_cast<lang::influence>(j.get<int>()); }
+template <> lang::rarity value_from_json(const json& j) { return static_cast<lang::rarity>(j.get<int>()); }
+template <> lang::shape value_from_json(const json& j) { return static_cast<lang::shape>(j.get<int>()); }
+template <> lang::suit value_from_json(const json& j) { return static_cast<lang::suit>(j.get<int>()); }
+template <> lang::string value_from_json(const json& j) { return lang::string{j.get<std::string>()}; }
+template <> lang::path value_from_json(const json& j) { return lang::path(j.get<std::string>()); }
+
+template <> lang::custom_alert_sound value_from_json(const json& j)
+{
+	return lang::custom_alert_sound(lang::path(j.get<std::string>()));
+}
+
+template <> lang::socket_group value_from_json(const json& j)
+{
+	return lang::socket_group{j.at(0).get<int>(), j.at(1).get<int>(), j.at(2).get<int>(), j.at(3).get<int>()};
+}
+
+template <> lang::color value_from_json(const json& j)
+{
+	lang::color result(j.at(0).get<int>(), j.at(1).get<int>(), j.at(2).get<int>());
+	if (j.size() > 3)
+		result.a = j.at(3).get<int>();
+
+	return result;
+}
+
+template <> lang::minimap_icon value_from_json(const json& j)
+{
+	return lang::minimap_icon(
+		j.at(0).get<int>(),
+		value_from_json<lang::suit>(j.at(1)),
+		value_from_json<lang::shape>(j.at(2)));
+}
+
+template <> lang::beam_effect value_from_json(const json& j)
+{
+	return lang::beam_effect(value_from_json<lang::suit>(j.at(0)), lang::boolean{j.at(1).get<bool>()});
+}
+
+template <> lang::built_in_alert_sound value_from_json(const json& j)
+{
+	lang::built_in_alert_sound result(lang::sound_id(j.at(0).get<int>()));
+	if (!j.at(1).is_null())
+		result.volume = lang::volume(j.at(1).get<int>());
+
+	result.is_positional = lang::boolean{j.at(2).get<bool>()};
+	return result;
+}
+
+template <> lang::alert_sound value_from_json(const json& j)
+{
+	if (j.is_string())
+		return lang::alert_sound(value_from_json<lang::custom_alert_sound>(j));
+	else
+		return lang::alert_sound(value_from_json<lang::built_in_alert_sound>(j));
+}
+
+template <> lang::array_object value_from_json(const json& j)
+{
+	lang::array_object::container_type result;
+	result.reserve(j.size());
+	for (const json& element : j)
+		result.push_back(object_from_json(element));
+
+	return result;
+}
+
+template <typename T>
+std::optional<T> optional_from_json(const json& j)
+{
+	if (j.is_null())
+		return std::nullopt;
+
+	return value_from_json<T>(j);
+}
+
+template <> lang::action_set value_from_json(const json& j)
+{
+	lang::action_set result;
+	result.border_color        = optional_from_json<lang::color>(j.at(0));
+	result.text_color          = optional_from_json<lang::color>(j.at(1));
+	result.background_color    = optional_from_json<lang::color>(j.at(2));
+	result.font_size           = optional_from_json<lang::font_size>(j.at(3));
+	result.alert_sound         = optional_from_json<lang::alert_sound>(j.at(4));
+	result.disabled_drop_sound = j.at(5).get<bool>();
+	result.minimap_icon        = optional_from_json<lang::minimap_icon>(j.at(6));
+	result.beam_effect         = optional_from_json<lang::beam_effect>(j.at(7));
+	return result;
+}
+
+template <> lang::action_set_object value_from_json(const json& j)
+{
+	return value_from_json<lang::action_set>(j);
+}
+
+template <std::size_t... I>
+lang::object_variant variant_from_json(lang::object_type type, const json& j, std::index_sequence<I...>)
+{
+	std::optional<lang::object_variant> result;
+	const auto try_alternative = [&](auto alternative) {
+		using T = typename decltype(alternative)::type;
+		if (type._to_integral() != lang::type_to_enum<T>()._to_integral())
+			return false;
+
+		result.emplace(value_from_json<T>(j));
+		return true;
+	};
+	(try_alternative(std::common_type<std::variant_alternative_t<I, lang::object_variant>>{}) || ...);
+
+	if (!result)
+		throw std::invalid_argument("unhandled object type");
+
+	return *std::move(result);
+}
+
+lang::object object_from_json(const json& j)
+{
+	const auto type = lang::object_type::_from_string_nothrow(j.at(field_type).get_ref<const std::string&>().c_str());
+	if (!type)
+		throw std::invalid_argument("invalid object type");
+
+	return lang::object{
+		variant_from_json(*type, j.at(field_value), std::make_index_sequence<std::variant_size_v<lang::object_variant>>{}),
+		lang::position_tag{}};
+}
+
+// ---- modules ----
+
+json module_to_json(const compiler::module_cache::module& m)
+{
+	json dependencies = json::array();
+	for (const compiler::module_cache::dependency& dep : m.dependencies)
+		dependencies.push_back(json{{field_path, dep.path}, {field_digest, dep.digest}});
+
+	json symbols = json::object();
+	for (const auto& [name, named_object] : m.symbols)
+		symbols[name] = object_to_json(named_object.object_instance);
+
+	return json{
+		{field_version, version_string()},
+		{field_directory, m.directory},
+		{field_dependencies, std::move(dependencies)},
+		{field_symbols, std::move(symbols)}
+	};
+}
+
+compiler::module_cache::module module_from_json(const json& j)
+{
+	if (j.at(field_version).get_ref<const std::string&>() != version_string())
+		throw std::invalid_argument("module cached by different program version");
+
+	compiler::module_cache::module result;
+	result.directory = j.at(field_directory).get<std::string>();
+
+	for (const json& dep : j.at(field_dependencies))
+		result.dependencies.push_back(compiler::module_cache::dependency{
+			dep.at(field_path).get<std::string>(), dep.at(field_digest).get<std::string>()});
+
+	for (const auto& [name, obj] : j.at(field_symbols).items())
+		result.symbols.emplace(name, lang::named_object{object_from_json(obj), lang::position_tag{}});
+
+	return result;
+}
+
+}
+
+namespace fs::compiler
+{
+
+std::shared_ptr<const module_cache::module> module_cache::find(const std::string& digest, const std::string& directory)
+{
+	std::shared_ptr<const module> result;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (const auto it = modules.find(digest); it != modules.end())
+			result = it->second;
+	}
+
+	if (result == nullptr) {
+		result = load_from_disk(digest);
+
+		if (result != nullptr) {
+			std::lock_guard<std::mutex> lock(mutex);
+			modules.insert_or_assign(digest, result);
+		}
+	}
+
+	// imports are resolved relative to the module file, the same
+	// content in a different directory may import different files
+	const bool valid = result != nullptr
+		&& (result->dependencies.empty() || result->directory == directory)
+		&& files_unchanged(result->dependencies);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (valid) {
+		++stats.hits;
+		return result;
+	}
+	else {
+		++stats.misses;
+		return nullptr;
+	}
+}
+
+void module_cache::store(const std::string& digest, std::shared_ptr<const module> m)
+{
+	save_to_disk(digest, *m);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	modules.insert_or_assign(digest, std::move(m));
+}
+
+module_cache::statistics module_cache::get_statistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+std::shared_ptr<const module_cache::module> module_cache::load_from_disk(const std::string& digest) const
+{
+	if (!directory)
+		return nullptr;
+
+	std::error_code ec;
+	const std::string file_content = utility::load_file(*directory / (digest + ".json"), ec);
+	if (ec)
+		return nullptr;
+
+	// the cache is only an optimization - any invalid file is treated as a miss
+	try {
+		return std::make_shared<const module>(module_from_json(json::parse(file_content)));
+	}
+	catch (const json::exception&) {
+		return nullptr;
+	}
+	catch (const std::invalid_argument&) {
+		return nullptr;
+	}
+}
+
+void module_cache::save_to_disk(const std::string& digest, const module& m) const
+{
+	if (!directory)
+		return;
+
+	// failure to save only means the module will be evaluated again in the next run
+	(void) utility::save_file(*directory / (digest + ".json"), utility::dump_json(module_to_json(m)));
+}
+
+bool files_unchanged(const std::vector<module_cache::dependency>& files)
+{
+	for (const module_cache::dependency& file : files) {
+		std::error_code ec;
+		const std::string content = utility::load_file(file.path, ec);
+
+		if (ec || utility::sha256_hex(content) != file.digest)
+			return false;
+	}
+
+	return true;
+}
+
+}
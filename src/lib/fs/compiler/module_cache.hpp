@@ -0,0 +1,92 @@
+#pragma once
+
+#include <fs/lang/symbol_table.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs::compiler
+{
+
+/**
+ * @class cache of resolved imported files (modules)
+ *
+ * @details Modules are keyed by SHA-256 digest of their content, so an unchanged
+ * module is parsed and evaluated only once - no matter from which template and how
+ * many times it is imported. If a directory is given, modules are also persisted
+ * there and reused across program runs.
+ *
+ * A module is reused only if all files it (also indirectly) imports are unchanged.
+ * Modules which depend on item price data are never cached.
+ *
+ * Thread safety: all member functions can be called concurrently.
+ */
+class module_cache
+{
+public:
+	struct dependency
+	{
+		std::string path;
+		std::string digest;
+	};
+
+	struct module
+	{
+		// definitions of the module itself, objects have no valid origins
+		lang::symbol_table symbols;
+		// directory against which imports of the module were resolved
+		std::string directory;
+		// all files imported by the module (also indirectly), with their digests
+		std::vector<dependency> dependencies;
+		// result of a price query is part of the module - such modules are not cached
+		bool uses_price_data = false;
+	};
+
+	struct statistics
+	{
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+	};
+
+	module_cache() = default;
+	explicit module_cache(boost::filesystem::path directory)
+	: directory(std::move(directory))
+	{
+	}
+
+	/**
+	 * @param digest digest of module content
+	 * @param directory directory of the module file
+	 * @return cached module or nullptr if there is none or any of its dependencies changed
+	 */
+	[[nodiscard]]
+	std::shared_ptr<const module> find(const std::string& digest, const std::string& directory);
+
+	void store(const std::string& digest, std::shared_ptr<const module> m);
+
+	[[nodiscard]]
+	statistics get_statistics() const;
+
+private:
+	[[nodiscard]]
+	std::shared_ptr<const module> load_from_disk(const std::string& digest) const;
+	void save_to_disk(const std::string& digest, const module& m) const;
+
+	mutable std::mutex mutex;
+	std::unordered_map<std::string, std::shared_ptr<const module>> modules;
+	statistics stats;
+	std::optional<boost::filesystem::path> directory;
+};
+
+// whether all files still have the recorded digests
+[[nodiscard]]
+bool files_unchanged(const std::vector<module_cache::dependency>& files);
+
+}
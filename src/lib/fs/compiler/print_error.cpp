@@ -322,6 +322,31 @@ void print_error_impl(
 		"first defined here");
 }
 
+void print_error_impl(
+	const errors::failed_import& error,
+	const parser::lookup_data& lookup_data,
+	log::logger& logger)
+{
+	logger.print_line_number_with_description_and_underlined_code(
+		lookup_data.get_view_of_whole_content(),
+		lookup_data.position_of(error.place_of_import),
+		log::strings::error,
+		"failed to import \"", error.path, "\"");
+	logger << error.description;
+}
+
+void print_error_impl(
+	const errors::import_cycle& error,
+	const parser::lookup_data& lookup_data,
+	log::logger& logger)
+{
+	logger.print_line_number_with_description_and_underlined_code(
+		lookup_data.get_view_of_whole_content(),
+		lookup_data.position_of(error.place_of_import),
+		log::strings::error,
+		"import cycle: \"", error.path, "\" is already being imported");
+}
+
 void print_error_impl(
 	errors::internal_compiler_error_during_action_evaluation error,
 	const parser::lookup_data& lookup_data,
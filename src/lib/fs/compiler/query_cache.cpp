@@ -0,0 +1,34 @@
+#include <fs/compiler/query_cache.hpp>
+
+#include <utility>
+
+namespace fs::compiler
+{
+
+std::optional<lang::array_object> query_cache::find(const std::string& query_name, lang::price_range range)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto it = results.find(key_type(query_name, range.min, range.max));
+	if (it == results.end()) {
+		++stats.misses;
+		return std::nullopt;
+	}
+
+	++stats.hits;
+	return it->second;
+}
+
+void query_cache::store(const std::string& query_name, lang::price_range range, lang::array_object result)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	// if multiple threads evaluated the same query, keep the first result
+	results.emplace(key_type(query_name, range.min, range.max), std::move(result));
+}
+
+query_cache::statistics query_cache::get_statistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <fs/lang/object.hpp>
+#include <fs/lang/price_range.hpp>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace fs::compiler
+{
+
+/**
+ * @class cache of price range query results
+ *
+ * @details Results are keyed by query name and its evaluated bounds, so the same
+ * query written in multiple places scans item price data only once and all places
+ * share the same array. The cache is valid only for one item price data instance -
+ * create a new one for each compilation.
+ *
+ * Elements of query results have no origins of their own, so a cached array can be
+ * returned as is - each place only sets the origin of the whole array object.
+ *
+ * Thread safety: all member functions can be called concurrently.
+ */
+class query_cache
+{
+public:
+	struct statistics
+	{
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+	};
+
+	[[nodiscard]]
+	std::optional<lang::array_object> find(const std::string& query_name, lang::price_range range);
+
+	void store(const std::string& query_name, lang::price_range range, lang::array_object result);
+
+	[[nodiscard]]
+	statistics get_statistics() const;
+
+private:
+	using key_type = std::tuple<std::string, std::optional<double>, std::optional<double>>;
+
+	mutable std::mutex mutex;
+	std::map<key_type, lang::array_object> results;
+	statistics stats;
+};
+
+}
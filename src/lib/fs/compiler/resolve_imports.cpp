@@ -0,0 +1,232 @@
+#include <fs/compiler/resolve_imports.hpp>
+#include <fs/compiler/resolve_symbols.hpp>
+#include <fs/compiler/print_error.hpp>
+#include <fs/parser/parser.hpp>
+#include <fs/parser/for_each_node.hpp>
+#include <fs/log/buffered_logger.hpp>
+#include <fs/log/strings.hpp>
+#include <fs/utility/file.hpp>
+#include <fs/utility/hash.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace ast = fs::parser::ast;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+using namespace fs;
+using namespace fs::compiler;
+
+struct import_state
+{
+	const lang::item_price_data& item_price_data;
+	module_cache& cache;
+	// files which are currently being imported, for cycle detection
+	std::vector<bfs::path> chain;
+};
+
+struct imported_symbols
+{
+	lang::symbol_table symbols;
+	std::vector<module_cache::dependency> dependencies;
+	bool uses_price_data = false;
+};
+
+bool uses_price_queries(const std::vector<ast::definition>& definitions)
+{
+	bool result = false;
+	const auto check_node = [&](const auto& node) {
+		if constexpr (std::is_same_v<std::decay_t<decltype(node)>, ast::price_range_query>)
+			result = true;
+	};
+
+	for (const ast::definition& def : definitions)
+		parser::for_each_node(def, check_node);
+
+	return result;
+}
+
+errors::failed_import make_failed_import(const ast::import_directive& import, const bfs::path& path, std::string description)
+{
+	return errors::failed_import{parser::get_position_info(import), path.generic_string(), std::move(description)};
+}
+
+std::variant<imported_symbols, compile_error>
+import_modules(
+	const std::vector<ast::import_directive>& imports,
+	const bfs::path& directory,
+	import_state& state);
+
+/*
+ * core of the import
+ *
+ * flow:
+ * - load and hash the file
+ * - reuse cached module if possible
+ * - otherwise parse it, recursively import its imports and evaluate its definitions
+ * - cache the module (unless it depends on item price data)
+ *
+ * Errors from the imported file refer to its own source so they are formatted here.
+ */
+std::variant<std::shared_ptr<const module_cache::module>, compile_error>
+load_module(
+	const ast::import_directive& import,
+	const bfs::path& path,
+	import_state& state,
+	std::vector<module_cache::dependency>& dependencies)
+{
+	std::error_code ec;
+	const std::string content = utility::load_file(path, ec);
+	if (ec)
+		return make_failed_import(import, path, "failed to load file: " + ec.message() + "\n");
+
+	const std::string digest = utility::sha256_hex(content);
+	const std::string module_directory = path.parent_path().generic_string();
+	dependencies.push_back(module_cache::dependency{path.generic_string(), digest});
+
+	if (std::shared_ptr<const module_cache::module> cached = state.cache.find(digest, module_directory); cached) {
+		dependencies.insert(dependencies.end(), cached->dependencies.begin(), cached->dependencies.end());
+		return cached;
+	}
+
+	std::variant<parser::parse_success_data, parser::parse_failure_data> parse_result = parser::parse(content);
+	if (std::holds_alternative<parser::parse_failure_data>(parse_result)) {
+		log::buffered_logger logger;
+		parser::print_parse_errors(std::get<parser::parse_failure_data>(parse_result), logger);
+		return make_failed_import(import, path, logger.flush_out());
+	}
+
+	const auto& parse_data = std::get<parser::parse_success_data>(parse_result);
+	if (!parse_data.ast.statements.empty()) {
+		log::buffered_logger logger;
+		logger.begin_error_message();
+		logger.print_line_number_with_description_and_underlined_code(
+			parse_data.lookup_data.get_view_of_whole_content(),
+			parse_data.lookup_data.position_of(parse_data.ast.statements.front()),
+			log::strings::error,
+			"imported files can contain only imports and definitions");
+		logger.end_message();
+		return make_failed_import(import, path, logger.flush_out());
+	}
+
+	state.chain.push_back(path);
+	std::variant<imported_symbols, compile_error> imports_result = import_modules(parse_data.ast.imports, path.parent_path(), state);
+	state.chain.pop_back();
+
+	const auto module_error = [&](const compile_error& error) {
+		log::buffered_logger logger;
+		compiler::print_error(error, parse_data.lookup_data, logger);
+		return make_failed_import(import, path, logger.flush_out());
+	};
+
+	if (std::holds_alternative<compile_error>(imports_result))
+		return module_error(std::get<compile_error>(imports_result));
+
+	auto& imported = std::get<imported_symbols>(imports_result);
+	dependencies.insert(dependencies.end(), imported.dependencies.begin(), imported.dependencies.end());
+
+	std::variant<lang::symbol_table, compile_error> symbols_or_error =
+		compiler::resolve_symbols(parse_data.ast.definitions, state.item_price_data, std::move(imported.symbols));
+	if (std::holds_alternative<compile_error>(symbols_or_error))
+		return module_error(std::get<compile_error>(symbols_or_error));
+
+	// export only own definitions, origins refer to the source of the module so drop them
+	auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+	module_cache::module result;
+	for (const ast::definition& def : parse_data.ast.definitions) {
+		lang::object obj = symbols.at(def.definition.name.value).object_instance;
+		lang::set_origins(obj, lang::position_tag{});
+		result.symbols.emplace(def.definition.name.value, lang::named_object{std::move(obj), lang::position_tag{}});
+	}
+
+	result.directory = module_directory;
+	result.dependencies = std::move(imported.dependencies);
+	result.uses_price_data = imported.uses_price_data || uses_price_queries(parse_data.ast.definitions);
+
+	auto module_ptr = std::make_shared<const module_cache::module>(std::move(result));
+	if (!module_ptr->uses_price_data)
+		state.cache.store(digest, module_ptr);
+
+	return module_ptr;
+}
+
+std::variant<imported_symbols, compile_error>
+import_modules(
+	const std::vector<ast::import_directive>& imports,
+	const bfs::path& directory,
+	import_state& state)
+{
+	imported_symbols result;
+	std::vector<bfs::path> imported_paths;
+
+	for (const ast::import_directive& import : imports) {
+		const bfs::path path = bfs::absolute(directory / import.path).lexically_normal();
+
+		// repeated imports of the same file are allowed and have no effect
+		if (std::find(imported_paths.begin(), imported_paths.end(), path) != imported_paths.end())
+			continue;
+
+		imported_paths.push_back(path);
+
+		const lang::position_tag place_of_import = parser::get_position_info(import);
+		if (std::find(state.chain.begin(), state.chain.end(), path) != state.chain.end())
+			return errors::import_cycle{place_of_import, path.generic_string()};
+
+		std::variant<std::shared_ptr<const module_cache::module>, compile_error> module_or_error =
+			load_module(import, path, state, result.dependencies);
+		if (std::holds_alternative<compile_error>(module_or_error))
+			return std::get<compile_error>(std::move(module_or_error));
+
+		const module_cache::module& m = *std::get<std::shared_ptr<const module_cache::module>>(module_or_error);
+		result.uses_price_data = result.uses_price_data || m.uses_price_data;
+
+		for (const auto& [name, named_object] : m.symbols) {
+			if (const auto it = result.symbols.find(name); it != result.symbols.end())
+				return errors::name_already_exists{place_of_import, it->second.name_origin};
+
+			lang::named_object obj = named_object;
+			lang::set_origins(obj.object_instance, place_of_import);
+			obj.name_origin = place_of_import;
+			result.symbols.emplace(name, std::move(obj));
+		}
+	}
+
+	return result;
+}
+
+} // namespace
+
+namespace fs::compiler
+{
+
+std::variant<lang::symbol_table, compile_error>
+resolve_imports(
+	const std::vector<parser::ast::import_directive>& imports,
+	const boost::filesystem::path& directory,
+	const lang::item_price_data& item_price_data,
+	module_cache& cache,
+	std::vector<module_cache::dependency>* imported_files)
+{
+	import_state state{item_price_data, cache, {}};
+	std::variant<imported_symbols, compile_error> result = import_modules(imports, directory, state);
+
+	if (std::holds_alternative<compile_error>(result))
+		return std::get<compile_error>(std::move(result));
+
+	auto& imported = std::get<imported_symbols>(result);
+	if (imported_files != nullptr)
+		*imported_files = std::move(imported.dependencies);
+
+	return std::move(imported.symbols);
+}
+
+} // namespace fs::compiler
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <fs/compiler/error.hpp>
+#include <fs/compiler/module_cache.hpp>
+#include <fs/parser/ast.hpp>
+#include <fs/lang/symbol_table.hpp>
+#include <fs/lang/item_price_data.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <vector>
+
+namespace fs::compiler
+{
+
+/**
+ * @brief load definitions of imported files
+ *
+ * @details Relative paths are resolved against @p directory, imports of imported
+ * files against their own directory. Imported files may contain only imports and
+ * definitions. Only own definitions of a file are visible to the importer.
+ * Imported objects have their origins set to the place of the import directive.
+ *
+ * @param imported_files if not null, receives all (also indirectly) imported files with their digests
+ * @return symbols of all imported files, to be extended by template definitions
+ */
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_imports(
+	const std::vector<parser::ast::import_directive>& imports,
+	const boost::filesystem::path& directory,
+	const lang::item_price_data& item_price_data,
+	module_cache& cache,
+	std::vector<module_cache::dependency>* imported_files = nullptr);
+
+}
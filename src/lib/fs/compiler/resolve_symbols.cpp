@@ -4,13 +4,14 @@
 #include <fs/lang/symbol_table.hpp>
 #include <fs/lang/position_tag.hpp>
 #include <fs/parser/ast.hpp>
+#include <fs/utility/parallel.hpp>
 
 #include <boost/spirit/home/x3/support/utility/lambda_visitor.hpp>
 
+#include <algorithm>
 #include <cassert>
-#include <string_view>
 #include <utility>
-#include <sstream>
+#include <vector>
 
 namespace ast = fs::parser::ast;
 namespace x3 = boost::spirit::x3;
@@ -21,51 +22,235 @@ namespace
 using namespace fs;
 using namespace fs::compiler;
 
+// a definition whose name already has an ID but the value is not evaluated yet
+struct pending_definition
+{
+	pending_definition(const ast::constant_definition& definition, lang::symbol_id id)
+	: definition(&definition), id(id)
+	{
+	}
+
+	const ast::constant_definition* definition;
+	lang::symbol_id id;
+	// definitions that are not needed are not evaluated (their object stays none)
+	bool needed = true;
+	// definitions in the same wave do not depend on each other
+	int wave = 0;
+	// also set when any dependency failed
+	bool failed = false;
+	std::optional<compile_error> error;
+};
+
 /*
- * core entry point into adding constants
- *
- * task:
- * Add object only if valid, error with appropriate information otherwise; in any case
- * after either successful addition or any error return immediately.
+ * first pass: names and references
  *
- * flow:
- * - check that name is not already taken and error if so
- *   (it's impossible to have multiple objects with the same name)
- *   (as of now, filter's language has no scoping/name shadowing)
- * - convert expression to language object and proceed
+ * Each definition gets an ID and its references are resolved before its
+ * name is added - definitions can refer only to earlier definitions.
+ * This is cheap and done serially. Stops at the first duplicated name
+ * (it's impossible to have multiple objects with the same name), the
+ * error is reported only if no preceding definition fails to evaluate.
  */
 [[nodiscard]] std::optional<compile_error>
-add_constant_from_definition(
-	const ast::constant_definition& def,
+add_names_from_definitions(
+	const std::vector<ast::definition>& definitions,
+	lang::symbol_table& symbols,
+	symbol_references& references,
+	std::vector<pending_definition>& pending)
+{
+	pending.reserve(definitions.size());
+
+	for (const ast::definition& def : definitions) {
+		const ast::constant_definition& constant_def = def.definition;
+		const ast::identifier& wanted_name = constant_def.name;
+
+		if (const auto it = symbols.find(wanted_name.value); it != symbols.end())
+		{
+			const lang::position_tag place_of_original_name = parser::get_position_info(it->second.name_origin);
+			const lang::position_tag place_of_duplicated_name = parser::get_position_info(wanted_name);
+			return errors::name_already_exists{place_of_duplicated_name, place_of_original_name};
+		}
+
+		resolve_references(constant_def.value, symbols, references);
+
+		const auto pair = symbols.emplace(
+			wanted_name.value,
+			lang::named_object{lang::object{}, parser::get_position_info(wanted_name)});
+		assert(pair.second); // C++20: use [[assert]]
+		(void) pair; // ignore insertion result in release builds
+		pending.emplace_back(constant_def, static_cast<lang::symbol_id>(symbols.size() - 1));
+	}
+
+	return std::nullopt;
+}
+
+// groups definitions so that each one depends only on definitions from earlier groups
+std::vector<std::vector<std::size_t>> make_waves(
+	std::vector<pending_definition>& pending,
+	const symbol_references& references)
+{
+	std::vector<std::vector<std::size_t>> waves;
+	if (pending.empty())
+		return waves;
+
+	const lang::symbol_id first_id = pending.front().id;
+	for (std::size_t i = 0; i < pending.size(); ++i) {
+		pending_definition& def = pending[i];
+		if (!def.needed)
+			continue;
+
+		for (lang::symbol_id dependency : referenced_symbols(def.definition->value, references))
+			if (dependency >= first_id) // other symbols (eg imported) are already evaluated
+				def.wave = std::max(def.wave, pending[dependency - first_id].wave + 1);
+
+		if (def.wave >= static_cast<int>(waves.size()))
+			waves.resize(def.wave + 1);
+
+		waves[def.wave].push_back(i);
+	}
+
+	return waves;
+}
+
+/*
+ * Only given symbols and definitions used by them (also indirectly) are needed.
+ * Definitions can refer only to earlier ones so there are no cycles and going
+ * backwards visits every definition after all definitions which could use it.
+ */
+void mark_needed_definitions(
+	std::vector<pending_definition>& pending,
+	const std::vector<lang::symbol_id>& needed_symbols,
+	const symbol_references& references)
+{
+	if (pending.empty())
+		return;
+
+	for (pending_definition& def : pending)
+		def.needed = false;
+
+	const lang::symbol_id first_id = pending.front().id;
+	const auto mark = [&](lang::symbol_id id) {
+		if (id >= first_id) // other symbols (eg imported) are already evaluated
+			pending[id - first_id].needed = true;
+	};
+
+	for (lang::symbol_id id : needed_symbols)
+		mark(id);
+
+	for (auto it = pending.rbegin(); it != pending.rend(); ++it)
+		if (it->needed)
+			for (lang::symbol_id id : referenced_symbols(it->definition->value, references))
+				mark(id);
+}
+
+void mark_needed_definitions(
+	std::vector<pending_definition>& pending,
+	const std::vector<ast::statement>& statements,
+	const symbol_references& references)
+{
+	mark_needed_definitions(pending, referenced_symbols(statements, references), references);
+}
+
+std::vector<pending_definition> make_pending_definitions(
+	const std::vector<ast::definition>& definitions,
+	lang::symbol_id first_own_symbol)
+{
+	std::vector<pending_definition> pending;
+	pending.reserve(definitions.size());
+	for (std::size_t i = 0; i < definitions.size(); ++i)
+		pending.emplace_back(definitions[i].definition, first_own_symbol + static_cast<lang::symbol_id>(i));
+
+	return pending;
+}
+
+void evaluate_definition(
+	pending_definition& def,
+	const std::vector<pending_definition>& pending,
 	const lang::item_price_data& item_price_data,
-	lang::symbol_table& symbols)
+	lang::symbol_table& symbols,
+	const symbol_references& references,
+	query_cache* queries)
 {
-	const ast::identifier& wanted_name = def.name;
-	const ast::value_expression& value_expression = def.value;
+	const ast::value_expression& value_expression = def.definition->value;
 
-	if (const auto it = symbols.find(wanted_name.value); it != symbols.end())
-	{
-		const lang::position_tag place_of_original_name = parser::get_position_info(it->second.name_origin);
-		const lang::position_tag place_of_duplicated_name = parser::get_position_info(wanted_name);
-		return errors::name_already_exists{place_of_duplicated_name, place_of_original_name};
+	// an error of a dependency is reported instead
+	const lang::symbol_id first_id = pending.front().id;
+	for (lang::symbol_id dependency : referenced_symbols(value_expression, references)) {
+		if (dependency >= first_id && pending[dependency - first_id].failed) {
+			def.failed = true;
+			return;
+		}
 	}
 
 	std::variant<lang::object, compile_error> expr_result =
-		compiler::detail::evaluate_value_expression(value_expression, symbols, item_price_data);
-
-	if (std::holds_alternative<compile_error>(expr_result))
-		return std::get<compile_error>(std::move(expr_result));
-
-	const auto pair = symbols.emplace(
-		wanted_name.value,
-		lang::named_object{
-			std::get<lang::object>(std::move(expr_result)),
-			parser::get_position_info(wanted_name)});
-	assert(pair.second); // C++20: use [[assert]]
-	(void) pair; // ignore insertion result in release builds
+		compiler::detail::evaluate_value_expression(value_expression, {symbols, references, queries}, item_price_data);
+
+	if (std::holds_alternative<compile_error>(expr_result)) {
+		def.failed = true;
+		def.error = std::get<compile_error>(std::move(expr_result));
+		return;
+	}
+
+	symbols.assign_object(def.id, std::get<lang::object>(std::move(expr_result)));
+}
+
+// returns the first error in order of definitions
+[[nodiscard]] std::optional<compile_error>
+evaluate_pending_definitions(
+	std::vector<pending_definition>& pending,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table& symbols,
+	const symbol_references& references,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	// each thread writes only objects of its definitions and reads only objects of earlier waves
+	num_threads = utility::resolve_thread_count(num_threads);
+	for (const std::vector<std::size_t>& wave : make_waves(pending, references)) {
+		utility::parallel_for(wave.size(), num_threads, [&](std::size_t i) {
+			evaluate_definition(pending[wave[i]], pending, item_price_data, symbols, references, queries);
+		});
+	}
+
+	// report errors as if definitions were evaluated in order
+	for (pending_definition& def : pending)
+		if (def.error)
+			return *std::move(def.error);
+
 	return std::nullopt;
 }
 
+std::variant<lang::symbol_table, compile_error>
+resolve_symbols_impl(
+	const std::vector<ast::definition>& definitions,
+	const std::vector<ast::statement>* statements,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	symbol_references& references,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	std::vector<pending_definition> pending;
+	std::optional<compile_error> name_error = add_names_from_definitions(definitions, symbols, references, pending);
+
+	// with a duplicated name, statements can not be resolved - evaluate all
+	// preceding definitions to report errors the same way as without statements
+	if (statements != nullptr && !name_error) {
+		resolve_references(*statements, symbols, references);
+		mark_needed_definitions(pending, *statements, references);
+	}
+
+	if (std::optional<compile_error> error = evaluate_pending_definitions(
+		pending, item_price_data, symbols, references, num_threads, queries))
+	{
+		return *std::move(error);
+	}
+
+	if (name_error)
+		return *std::move(name_error);
+
+	return symbols;
+}
+
 } // namespace
 
 namespace fs::compiler
@@ -76,13 +261,168 @@ resolve_symbols(
 	const std::vector<parser::ast::definition>& definitions,
 	const lang::item_price_data& item_price_data)
 {
-	lang::symbol_table symbols;
+	return resolve_symbols(definitions, item_price_data, lang::symbol_table());
+}
 
-	for (const ast::definition& def : definitions) {
-		std::optional<compile_error> error = add_constant_from_definition(def.definition, item_price_data, symbols);
+std::variant<lang::symbol_table, compile_error>
+resolve_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table initial_symbols)
+{
+	symbol_references references;
+	return resolve_symbols(definitions, item_price_data, std::move(initial_symbols), references);
+}
+
+std::variant<lang::symbol_table, compile_error>
+resolve_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	symbol_references& references,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	return resolve_symbols_impl(
+		definitions, nullptr, item_price_data, std::move(symbols), references, num_threads, queries);
+}
+
+std::variant<lang::symbol_table, compile_error>
+resolve_symbols_used_by(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>& statements,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	symbol_references& references,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	return resolve_symbols_impl(
+		definitions, &statements, item_price_data, std::move(symbols), references, num_threads, queries);
+}
+
+std::variant<lang::symbol_table, compile_error>
+resolve_symbols_needed_by(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>& statements,
+	const std::vector<lang::symbol_id>& needed_symbols,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	const symbol_references& references,
+	lang::symbol_id first_own_symbol,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	assert(symbols.size() == first_own_symbol + definitions.size());
+
+	std::vector<pending_definition> pending = make_pending_definitions(definitions, first_own_symbol);
+	mark_needed_definitions(pending, statements, references);
+	std::vector<bool> evaluated(pending.size());
+	for (std::size_t i = 0; i < pending.size(); ++i)
+		evaluated[i] = pending[i].needed;
+
+	mark_needed_definitions(pending, needed_symbols, references);
+	for (std::size_t i = 0; i < pending.size(); ++i)
+		pending[i].needed = pending[i].needed && !evaluated[i];
 
-		if (error)
-			return *std::move(error);
+	if (std::optional<compile_error> error = evaluate_pending_definitions(
+		pending, item_price_data, symbols, references, num_threads, queries))
+	{
+		return *std::move(error);
+	}
+
+	return symbols;
+}
+
+std::variant<std::vector<symbol_override>, compile_error>
+evaluate_overrides(
+	const std::vector<parser::ast::definition>& overrides,
+	const lang::item_price_data& item_price_data,
+	const lang::symbol_table& symbols,
+	lang::symbol_id first_own_symbol,
+	query_cache* queries)
+{
+	symbol_references references;
+	std::vector<symbol_override> result;
+	result.reserve(overrides.size());
+
+	for (std::size_t i = 0; i < overrides.size(); ++i) {
+		const ast::constant_definition& constant_def = overrides[i].definition;
+		const ast::identifier& name = constant_def.name;
+
+		const lang::symbol_id id = symbols.id_of(name.value);
+		if (id < first_own_symbol) // also invalid_symbol_id
+			return errors::no_such_name{parser::get_position_info(name)};
+
+		for (std::size_t j = 0; j < i; ++j) {
+			if (result[j].id == id) {
+				return errors::name_already_exists{
+					parser::get_position_info(name),
+					parser::get_position_info(overrides[j].definition.name)};
+			}
+		}
+
+		resolve_references(constant_def.value, symbols, references);
+		std::variant<lang::object, compile_error> value_or_error =
+			compiler::detail::evaluate_value_expression(constant_def.value, {symbols, references, queries}, item_price_data);
+
+		if (std::holds_alternative<compile_error>(value_or_error))
+			return std::get<compile_error>(std::move(value_or_error));
+
+		result.push_back(symbol_override{id, std::get<lang::object>(std::move(value_or_error))});
+	}
+
+	return result;
+}
+
+std::variant<lang::symbol_table, compile_error>
+resolve_variant_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>* statements,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	const symbol_references& references,
+	lang::symbol_id first_own_symbol,
+	std::vector<symbol_override> overrides,
+	unsigned num_threads,
+	query_cache* queries)
+{
+	assert(symbols.size() == first_own_symbol + definitions.size());
+
+	std::vector<pending_definition> pending = make_pending_definitions(definitions, first_own_symbol);
+	if (statements != nullptr)
+		mark_needed_definitions(pending, *statements, references);
+
+	// objects which differ from the template (overridden or depending on overridden ones)
+	std::vector<bool> changed(pending.size(), false);
+	for (symbol_override& replacement : overrides) {
+		const std::size_t index = replacement.id - first_own_symbol;
+		lang::set_origins(replacement.object, parser::get_position_info(definitions[index].definition.value));
+		symbols.assign_object(replacement.id, std::move(replacement.object));
+		changed[index] = true;
+	}
+
+	for (std::size_t i = 0; i < pending.size(); ++i) {
+		pending_definition& def = pending[i];
+		if (changed[i]) {
+			def.needed = false;
+			continue;
+		}
+
+		for (lang::symbol_id dependency : referenced_symbols(def.definition->value, references)) {
+			if (dependency >= first_own_symbol && changed[dependency - first_own_symbol]) {
+				changed[i] = true;
+				break;
+			}
+		}
+
+		def.needed = def.needed && changed[i];
+	}
+
+	if (std::optional<compile_error> error = evaluate_pending_definitions(
+		pending, item_price_data, symbols, references, num_threads, queries))
+	{
+		return *std::move(error);
 	}
 
 	return symbols;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <fs/compiler/error.hpp>
+#include <fs/compiler/query_cache.hpp>
+#include <fs/compiler/symbol_references.hpp>
 #include <fs/parser/ast.hpp>
 #include <fs/lang/symbol_table.hpp>
 #include <fs/lang/item_price_data.hpp>
@@ -16,4 +18,101 @@ resolve_symbols(
 	const std::vector<parser::ast::definition>& definitions,
 	const lang::item_price_data& item_price_data);
 
+// as above, but definitions are added to already existing (eg imported) symbols
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table initial_symbols);
+
+/*
+ * as above, also outputs how definitions refer to symbols
+ *
+ * Definitions that do not depend on each other are evaluated concurrently
+ * using up to num_threads threads (0 means all hardware threads). Errors
+ * are the same as if definitions were evaluated one by one in order.
+ * If queries is not null, results of price queries are cached there.
+ */
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table initial_symbols,
+	symbol_references& references,
+	unsigned num_threads = 1,
+	query_cache* queries = nullptr);
+
+/*
+ * as above, but only definitions used by statements (also indirectly) are
+ * evaluated - objects of other definitions are none and their errors are
+ * not reported; also resolves references of statements
+ */
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_symbols_used_by(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>& statements,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table initial_symbols,
+	symbol_references& references,
+	unsigned num_threads = 1,
+	query_cache* queries = nullptr);
+
+/*
+ * evaluate definitions which resolve_symbols_used_by() skipped for given
+ * definitions and statements but which are needed (also indirectly) by
+ * needed_symbols, eg by overrides of variants - definitions used by
+ * statements are not evaluated again
+ */
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_symbols_needed_by(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>& statements,
+	const std::vector<lang::symbol_id>& needed_symbols,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	const symbol_references& references,
+	lang::symbol_id first_own_symbol,
+	unsigned num_threads = 1,
+	query_cache* queries = nullptr);
+
+// replacement of an object of a definition, for variants of a template
+struct symbol_override
+{
+	lang::symbol_id id;
+	lang::object object;
+};
+
+/*
+ * evaluate overrides of template definitions - definitions from other
+ * source whose names must be names of own template definitions (symbols
+ * with ID >= first_own_symbol). Values are evaluated with template symbols
+ * visible, overrides can not refer to each other.
+ */
+[[nodiscard]] std::variant<std::vector<symbol_override>, compile_error>
+evaluate_overrides(
+	const std::vector<parser::ast::definition>& overrides,
+	const lang::item_price_data& item_price_data,
+	const lang::symbol_table& symbols,
+	lang::symbol_id first_own_symbol,
+	query_cache* queries = nullptr);
+
+/*
+ * symbols of a variant of a template: starts from symbols and references
+ * resolved for the template, replaces overridden objects and evaluates again
+ * only definitions that depend on them (also indirectly) - with statements,
+ * only these used by statements. Overridden objects get origins of replaced
+ * values, so all errors refer to the template source.
+ */
+[[nodiscard]] std::variant<lang::symbol_table, compile_error>
+resolve_variant_symbols(
+	const std::vector<parser::ast::definition>& definitions,
+	const std::vector<parser::ast::statement>* statements,
+	const lang::item_price_data& item_price_data,
+	lang::symbol_table symbols,
+	const symbol_references& references,
+	lang::symbol_id first_own_symbol,
+	std::vector<symbol_override> overrides,
+	unsigned num_threads = 1,
+	query_cache* queries = nullptr);
+
 }
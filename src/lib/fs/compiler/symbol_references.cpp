@@ -0,0 +1,142 @@
+#include <fs/compiler/symbol_references.hpp>
+#include <fs/parser/for_each_node.hpp>
+
+#include <boost/variant/get.hpp>
+
+#include <cassert>
+#include <type_traits>
+
+namespace ast = fs::parser::ast;
+
+namespace
+{
+
+using namespace fs;
+
+template <typename Node>
+void resolve_references_impl(
+	const Node& node,
+	const lang::symbol_table& symbols,
+	compiler::symbol_references& references)
+{
+	// only identifiers directly in a primary expression name objects
+	const auto resolve = [&](const auto& n) {
+		if constexpr (std::is_same_v<std::decay_t<decltype(n)>, ast::primary_expression>)
+			if (const auto* const identifier = boost::get<ast::identifier>(&n.var); identifier != nullptr)
+				references.add(*identifier, symbols.id_of(identifier->value));
+	};
+
+	parser::for_each_node(node, resolve);
+}
+
+template <typename Node>
+void referenced_symbols_impl(
+	const Node& node,
+	const compiler::symbol_references& references,
+	std::vector<lang::symbol_id>& result)
+{
+	const auto collect = [&](const auto& n) {
+		if constexpr (std::is_same_v<std::decay_t<decltype(n)>, ast::primary_expression>)
+			if (const auto* const identifier = boost::get<ast::identifier>(&n.var); identifier != nullptr)
+				if (const lang::symbol_id id = references.id_of(*identifier); id != lang::invalid_symbol_id)
+					result.push_back(id);
+	};
+
+	parser::for_each_node(node, collect);
+}
+
+} // namespace
+
+namespace fs::compiler
+{
+
+lang::symbol_id symbol_references::id_of(const parser::ast::identifier& identifier) const noexcept
+{
+	const int position_id = identifier.id_first;
+	if (position_id < 0 || position_id >= static_cast<int>(ids.size()))
+		return lang::invalid_symbol_id;
+
+	return ids[position_id];
+}
+
+int symbol_references::use_count(lang::symbol_id id) const noexcept
+{
+	if (id < 0 || id >= static_cast<lang::symbol_id>(use_counts.size()))
+		return 0;
+
+	return use_counts[id];
+}
+
+void symbol_references::add(const parser::ast::identifier& identifier, lang::symbol_id id)
+{
+	const int position_id = identifier.id_first;
+	assert(position_id >= 0); // all AST nodes should be position-tagged
+
+	if (position_id >= static_cast<int>(ids.size()))
+		ids.resize(position_id + 1, lang::invalid_symbol_id);
+
+	ids[position_id] = id;
+
+	if (id == lang::invalid_symbol_id)
+		return;
+
+	if (id >= static_cast<lang::symbol_id>(use_counts.size()))
+		use_counts.resize(id + 1, 0);
+
+	++use_counts[id];
+}
+
+void resolve_references(
+	const parser::ast::value_expression& expression,
+	const lang::symbol_table& symbols,
+	symbol_references& references)
+{
+	resolve_references_impl(expression, symbols, references);
+}
+
+void resolve_references(
+	const std::vector<parser::ast::statement>& statements,
+	const lang::symbol_table& symbols,
+	symbol_references& references)
+{
+	for (const ast::statement& statement : statements)
+		resolve_references_impl(statement, symbols, references);
+}
+
+std::vector<lang::symbol_id>
+referenced_symbols(
+	const parser::ast::value_expression& expression,
+	const symbol_references& references)
+{
+	std::vector<lang::symbol_id> result;
+	referenced_symbols_impl(expression, references, result);
+	return result;
+}
+
+std::vector<lang::symbol_id>
+referenced_symbols(
+	const std::vector<parser::ast::statement>& statements,
+	const symbol_references& references)
+{
+	std::vector<lang::symbol_id> result;
+	for (const ast::statement& statement : statements)
+		referenced_symbols_impl(statement, references, result);
+
+	return result;
+}
+
+std::vector<lang::symbol_id>
+find_unused_symbols(
+	const lang::symbol_table& symbols,
+	const symbol_references& references,
+	lang::symbol_id first_id)
+{
+	std::vector<lang::symbol_id> result;
+	for (lang::symbol_id id = first_id; id < static_cast<lang::symbol_id>(symbols.size()); ++id)
+		if (references.use_count(id) == 0)
+			result.push_back(id);
+
+	return result;
+}
+
+}
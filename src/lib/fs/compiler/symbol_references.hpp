@@ -0,0 +1,65 @@
+#pragma once
+
+#include <fs/parser/ast.hpp>
+#include <fs/lang/symbol_table.hpp>
+
+#include <vector>
+
+namespace fs::compiler
+{
+
+/**
+ * @brief identifiers of the AST resolved to symbol IDs
+ *
+ * @details Names are looked up only once, before evaluation. Each AST node
+ * has its own position ID which is used here as an index, so evaluation of
+ * an identifier is just 2 array accesses (position ID -> symbol ID -> object).
+ * As a by-product, references to each symbol are counted.
+ */
+class symbol_references
+{
+public:
+	// invalid_symbol_id if the identifier does not refer to any (preceding) symbol
+	[[nodiscard]] lang::symbol_id id_of(const parser::ast::identifier& identifier) const noexcept;
+
+	[[nodiscard]] int use_count(lang::symbol_id id) const noexcept;
+
+	void add(const parser::ast::identifier& identifier, lang::symbol_id id);
+
+private:
+	// indexed by position ID of the identifier
+	std::vector<lang::symbol_id> ids;
+	// indexed by symbol ID
+	std::vector<int> use_counts;
+};
+
+// resolve identifiers used as values (names of functions, queries etc are not references)
+void resolve_references(
+	const parser::ast::value_expression& expression,
+	const lang::symbol_table& symbols,
+	symbol_references& references);
+
+void resolve_references(
+	const std::vector<parser::ast::statement>& statements,
+	const lang::symbol_table& symbols,
+	symbol_references& references);
+
+// IDs of symbols referenced by (already resolved) expression, in order of appearance
+[[nodiscard]] std::vector<lang::symbol_id>
+referenced_symbols(
+	const parser::ast::value_expression& expression,
+	const symbol_references& references);
+
+[[nodiscard]] std::vector<lang::symbol_id>
+referenced_symbols(
+	const std::vector<parser::ast::statement>& statements,
+	const symbol_references& references);
+
+// symbols with ID >= first_id that are never referenced
+[[nodiscard]] std::vector<lang::symbol_id>
+find_unused_symbols(
+	const lang::symbol_table& symbols,
+	const symbol_references& references,
+	lang::symbol_id first_id = 0);
+
+}
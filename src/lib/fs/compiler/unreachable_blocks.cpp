@@ -0,0 +1,299 @@
+#include <fs/compiler/unreachable_blocks.hpp>
+#include <fs/lang/condition_set.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace
+{
+
+using namespace fs;
+
+/*
+ * Each function below checks whether condition 'a' (of the earlier block)
+ * accepts every item that condition 'b' (of the later block) accepts.
+ */
+
+template <typename T>
+bool lower_bound_covers(const std::optional<lang::range_bound<T>>& a, const std::optional<lang::range_bound<T>>& b)
+{
+	if (!a.has_value())
+		return true;
+
+	if (!b.has_value())
+		return false;
+
+	if ((*a).value != (*b).value)
+		return (*b).value > (*a).value;
+
+	return (*a).inclusive || !(*b).inclusive;
+}
+
+template <typename T>
+bool upper_bound_covers(const std::optional<lang::range_bound<T>>& a, const std::optional<lang::range_bound<T>>& b)
+{
+	if (!a.has_value())
+		return true;
+
+	if (!b.has_value())
+		return false;
+
+	if ((*a).value != (*b).value)
+		return (*b).value < (*a).value;
+
+	return (*a).inclusive || !(*b).inclusive;
+}
+
+template <typename T>
+bool covers(const lang::range_condition<T>& a, const lang::range_condition<T>& b)
+{
+	return lower_bound_covers(a.lower_bound, b.lower_bound) && upper_bound_covers(a.upper_bound, b.upper_bound);
+}
+
+bool covers(const std::optional<lang::boolean_condition>& a, const std::optional<lang::boolean_condition>& b)
+{
+	if (!a.has_value())
+		return true;
+
+	return b.has_value() && (*a).value.value == (*b).value.value;
+}
+
+// the group has to contain at least the specified sockets
+bool covers(const std::optional<lang::socket_group_condition>& a, const std::optional<lang::socket_group_condition>& b)
+{
+	if (!a.has_value())
+		return true;
+
+	if (!b.has_value())
+		return false;
+
+	const lang::socket_group& ga = (*a).group;
+	const lang::socket_group& gb = (*b).group;
+	return gb.r >= ga.r && gb.g >= ga.g && gb.b >= ga.b && gb.w >= ga.w;
+}
+
+// non-exact: the item has any of listed influences, exact: the item has exactly listed influences
+bool covers(const lang::influences_condition& a, const lang::influences_condition& b)
+{
+	if (a.influences == nullptr)
+		return true;
+
+	if (b.influences == nullptr)
+		return false;
+
+	const auto contains = [](const std::vector<lang::influence>& influences, lang::influence infl) {
+		return std::find(influences.begin(), influences.end(), infl) != influences.end();
+	};
+	const auto all_in_a = std::all_of(b.influences->begin(), b.influences->end(), [&](lang::influence infl) {
+		return contains(*a.influences, infl);
+	});
+
+	if (!a.exact_match_required)
+		return all_in_a;
+
+	return b.exact_match_required && all_in_a && std::all_of(a.influences->begin(), a.influences->end(), [&](lang::influence infl) {
+		return contains(*b.influences, infl);
+	});
+}
+
+// non-exact: the property contains any of listed strings, exact: the property is one of listed strings
+bool covers(const lang::strings_condition& a, const lang::strings_condition& b)
+{
+	if (a.strings == nullptr)
+		return true;
+
+	if (b.strings == nullptr)
+		return false;
+
+	// lists are interned, so equal lists are usually the same object
+	if (a.strings == b.strings && (!a.exact_match_required || b.exact_match_required))
+		return true;
+
+	const std::vector<std::string>& strings_a = *a.strings;
+	const std::vector<std::string>& strings_b = *b.strings;
+
+	if (a.exact_match_required) {
+		return b.exact_match_required && std::all_of(strings_b.begin(), strings_b.end(), [&](const std::string& str) {
+			return std::find(strings_a.begin(), strings_a.end(), str) != strings_a.end();
+		});
+	}
+
+	// whatever contains (or is) a string from b also contains a string from a
+	return std::all_of(strings_b.begin(), strings_b.end(), [&](const std::string& str_b) {
+		return std::any_of(strings_a.begin(), strings_a.end(), [&](const std::string& str_a) {
+			return str_b.find(str_a) != std::string::npos;
+		});
+	});
+}
+
+// cheapest checks first, string lists can be long
+bool covers(const lang::condition_set& a, const lang::condition_set& b)
+{
+	return covers(a.item_level, b.item_level)
+		&& covers(a.drop_level, b.drop_level)
+		&& covers(a.quality, b.quality)
+		&& covers(a.rarity, b.rarity)
+		&& covers(a.sockets, b.sockets)
+		&& covers(a.links, b.links)
+		&& covers(a.height, b.height)
+		&& covers(a.width, b.width)
+		&& covers(a.stack_size, b.stack_size)
+		&& covers(a.gem_level, b.gem_level)
+		&& covers(a.map_tier, b.map_tier)
+		&& covers(a.is_identified, b.is_identified)
+		&& covers(a.is_corrupted, b.is_corrupted)
+		&& covers(a.is_elder_item, b.is_elder_item)
+		&& covers(a.is_shaper_item, b.is_shaper_item)
+		&& covers(a.is_fractured_item, b.is_fractured_item)
+		&& covers(a.is_synthesised_item, b.is_synthesised_item)
+		&& covers(a.is_enchanted, b.is_enchanted)
+		&& covers(a.is_shaped_map, b.is_shaped_map)
+		&& covers(a.is_elder_map, b.is_elder_map)
+		&& covers(a.is_blighted_map, b.is_blighted_map)
+		&& covers(a.socket_group, b.socket_group)
+		&& covers(a.has_influence, b.has_influence)
+		&& covers(a.class_, b.class_)
+		&& covers(a.base_type, b.base_type)
+		&& covers(a.prophecy, b.prophecy)
+		&& covers(a.has_explicit_mod, b.has_explicit_mod)
+		&& covers(a.has_enchantment, b.has_enchantment);
+}
+
+/*
+ * One bit for each specified condition. A block can only be covered by
+ * blocks whose conditions are a subset of its own, which rejects most
+ * candidates with a single comparison.
+ */
+std::uint32_t condition_mask(const lang::condition_set& cs)
+{
+	std::uint32_t mask = 0;
+	int bit = 0;
+	const auto add = [&](bool specified) {
+		if (specified)
+			mask |= std::uint32_t(1) << bit;
+
+		++bit;
+	};
+
+	add(cs.item_level.has_anything());
+	add(cs.drop_level.has_anything());
+	add(cs.quality.has_anything());
+	add(cs.rarity.has_anything());
+	add(cs.class_.strings != nullptr);
+	add(cs.base_type.strings != nullptr);
+	add(cs.sockets.has_anything());
+	add(cs.links.has_anything());
+	add(cs.socket_group.has_value());
+	add(cs.height.has_anything());
+	add(cs.width.has_anything());
+	add(cs.has_explicit_mod.strings != nullptr);
+	add(cs.has_enchantment.strings != nullptr);
+	add(cs.prophecy.strings != nullptr);
+	add(cs.has_influence.influences != nullptr);
+	add(cs.stack_size.has_anything());
+	add(cs.gem_level.has_anything());
+	add(cs.map_tier.has_anything());
+	add(cs.is_identified.has_value());
+	add(cs.is_corrupted.has_value());
+	add(cs.is_elder_item.has_value());
+	add(cs.is_shaper_item.has_value());
+	add(cs.is_fractured_item.has_value());
+	add(cs.is_synthesised_item.has_value());
+	add(cs.is_enchanted.has_value());
+	add(cs.is_shaped_map.has_value());
+	add(cs.is_elder_map.has_value());
+	add(cs.is_blighted_map.has_value());
+	return mask;
+}
+
+// reachable blocks with the same set of specified conditions
+struct block_group
+{
+	std::uint32_t mask;
+	std::vector<std::size_t> indexes;
+};
+
+}
+
+namespace fs::compiler
+{
+
+std::vector<unreachable_block>
+find_unreachable_blocks(const std::vector<lang::filter_block>& blocks)
+{
+	std::vector<unreachable_block> result;
+	std::vector<block_group> groups;
+
+	for (std::size_t i = 0; i < blocks.size(); ++i) {
+		const lang::condition_set& conditions = *blocks[i].conditions;
+		if (!conditions.is_valid())
+			continue;
+
+		const std::uint32_t mask = condition_mask(conditions);
+		std::optional<std::size_t> shadowed_by;
+
+		for (const block_group& group : groups) {
+			if ((group.mask & ~mask) != 0)
+				continue;
+
+			for (std::size_t j : group.indexes) {
+				if (shadowed_by && *shadowed_by < j)
+					break;
+
+				// blocks from the same scope share their conditions
+				if (blocks[j].conditions.shares_value_with(blocks[i].conditions)
+					|| covers(*blocks[j].conditions, conditions))
+				{
+					shadowed_by = j;
+					break;
+				}
+			}
+		}
+
+		if (shadowed_by) {
+			result.push_back(unreachable_block{i, *shadowed_by});
+			// anything this block would cover is covered by the earlier block too
+			continue;
+		}
+
+		const auto it = std::find_if(groups.begin(), groups.end(), [&](const block_group& group) {
+			return group.mask == mask;
+		});
+
+		if (it == groups.end())
+			groups.push_back(block_group{mask, {i}});
+		else
+			(*it).indexes.push_back(i);
+	}
+
+	return result;
+}
+
+void remove_unreachable_blocks(
+	std::vector<lang::filter_block>& blocks,
+	const std::vector<unreachable_block>& unreachable)
+{
+	if (unreachable.empty())
+		return;
+
+	std::size_t next_unreachable = 0;
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < blocks.size(); ++i) {
+		if (next_unreachable < unreachable.size() && unreachable[next_unreachable].index == i) {
+			++next_unreachable;
+			continue;
+		}
+
+		if (kept != i)
+			blocks[kept] = std::move(blocks[i]);
+
+		++kept;
+	}
+
+	blocks.erase(blocks.begin() + kept, blocks.end());
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <fs/lang/filter_block.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace fs::compiler
+{
+
+struct unreachable_block
+{
+	// index of the block that can never be matched
+	std::size_t index;
+	// index of an earlier block which matches every item the block could match
+	std::size_t shadowed_by;
+};
+
+/**
+ * @brief find blocks which no item can ever reach
+ *
+ * @details The game checks blocks from top to bottom and applies the
+ * first one that matches, so a block is unreachable if an earlier block
+ * matches every item the block could match. The analysis is conservative:
+ * every reported block is unreachable but not every unreachable block is
+ * found (conditions are compared one by one, never in combination).
+ * Invalid blocks (not generated) are ignored.
+ *
+ * @return unreachable blocks in ascending order of indexes
+ */
+[[nodiscard]] std::vector<unreachable_block>
+find_unreachable_blocks(const std::vector<lang::filter_block>& blocks);
+
+// removes blocks reported by find_unreachable_blocks, the order of remaining blocks is kept
+void remove_unreachable_blocks(
+	std::vector<lang::filter_block>& blocks,
+	const std::vector<unreachable_block>& unreachable);
+
+}
@@ -0,0 +1,100 @@
+#include <fs/generator/batch_manifest.hpp>
+#include <fs/log/logger.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <utility>
+
+namespace fs::generator
+{
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+// throws nlohmann::json::exception on missing keys and wrong types
+std::optional<batch_data_source>
+parse_data_source(const std::string& name, const nlohmann::json& json, const bfs::path& directory, log::logger& logger)
+{
+	batch_data_source source;
+	int ways = 0;
+
+	if (const auto it = json.find("download"); it != json.end()) {
+		++ways;
+		const std::string api = it->get<std::string>();
+		const std::string league = json.at("league").get<std::string>();
+
+		if (api == "poe.ninja") {
+			source.download_league_name_ninja = league;
+		}
+		else if (api == "poe.watch") {
+			source.download_league_name_watch = league;
+		}
+		else {
+			logger.error() << "data source " << name << ": unknown API \"" << api << "\" (expected poe.ninja or poe.watch)";
+			return std::nullopt;
+		}
+	}
+
+	if (const auto it = json.find("read"); it != json.end()) {
+		++ways;
+		source.data_read_dir = (directory / it->get<std::string>()).generic_string();
+	}
+
+	if (const auto it = json.find("empty"); it != json.end()) {
+		++ways;
+		source.empty = it->get<bool>();
+	}
+
+	if (ways != 1) {
+		logger.error() << "data source " << name << " must specify exactly 1 of: download, read, empty";
+		return std::nullopt;
+	}
+
+	return source;
+}
+
+} // namespace
+
+std::optional<batch_manifest>
+parse_batch_manifest(
+	std::string_view content,
+	const bfs::path& directory,
+	log::logger& logger)
+{
+	try {
+		const nlohmann::json json = nlohmann::json::parse(content.begin(), content.end());
+		batch_manifest result;
+
+		for (const auto& [name, source_json] : json.at("data").items()) {
+			std::optional<batch_data_source> source = parse_data_source(name, source_json, directory, logger);
+			if (!source)
+				return std::nullopt;
+
+			result.data_sources.emplace(name, std::move(*source));
+		}
+
+		for (const nlohmann::json& job_json : json.at("jobs")) {
+			batch_job job{
+				directory / job_json.at("template").get<std::string>(),
+				job_json.at("data").get<std::string>(),
+				directory / job_json.at("output").get<std::string>()};
+
+			if (result.data_sources.count(job.data_name) == 0) {
+				logger.error() << "job " << static_cast<int>(result.jobs.size() + 1) << " uses undefined data source " << job.data_name;
+				return std::nullopt;
+			}
+
+			result.jobs.push_back(std::move(job));
+		}
+
+		return result;
+	}
+	catch (const nlohmann::json::exception& e) {
+		logger.error() << "invalid batch manifest: " << e.what();
+		return std::nullopt;
+	}
+}
+
+}
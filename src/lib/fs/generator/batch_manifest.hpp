@@ -0,0 +1,69 @@
+#pragma once
+
+#include <fs/log/logger_fwd.hpp>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs::generator
+{
+
+// exactly one way of obtaining item price data
+struct batch_data_source
+{
+	boost::optional<std::string> download_league_name_ninja;
+	boost::optional<std::string> download_league_name_watch;
+	boost::optional<std::string> data_read_dir;
+	bool empty = false;
+};
+
+struct batch_job
+{
+	boost::filesystem::path template_path;
+	std::string data_name;
+	boost::filesystem::path output_path;
+};
+
+struct batch_manifest
+{
+	std::map<std::string, batch_data_source> data_sources;
+	std::vector<batch_job> jobs;
+};
+
+/**
+ * @brief read the description of many filters to generate in one process
+ *
+ * @details The manifest is a JSON file:
+ *
+ *     {
+ *         "data": {
+ *             "sc":  { "download": "poe.ninja", "league": "Metamorph" },
+ *             "hc":  { "download": "poe.watch", "league": "Hardcore Metamorph" },
+ *             "old": { "read": "saved_data" },
+ *             "ssf": { "empty": true }
+ *         },
+ *         "jobs": [
+ *             { "template": "filter.fs", "data": "sc", "output": "out/sc.filter" },
+ *             { "template": "filter.fs", "data": "hc", "output": "out/hc.filter" }
+ *         ]
+ *     }
+ *
+ * Each data source must specify exactly one of download, read and empty.
+ * Every job must use a data source defined in the manifest. Paths are
+ * resolved against @p directory (the directory of the manifest).
+ *
+ * @return nullopt if the manifest is invalid, the reason is logged
+ */
+[[nodiscard]] std::optional<batch_manifest>
+parse_batch_manifest(
+	std::string_view content,
+	const boost::filesystem::path& directory,
+	log::logger& logger);
+
+}
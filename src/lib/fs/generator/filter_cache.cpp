@@ -0,0 +1,273 @@
+#include <fs/generator/filter_cache.hpp>
+#include <fs/utility/dump_json.hpp>
+#include <fs/utility/file.hpp>
+#include <fs/utility/hash.hpp>
+#include <fs/version.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+using namespace fs;
+using json = nlohmann::json;
+
+constexpr auto field_imported_files = "imported_files";
+constexpr auto field_path = "path";
+constexpr auto field_digest = "digest";
+constexpr auto field_filter = "filter";
+constexpr auto field_warnings = "warnings";
+
+/*
+ * Unambiguous serialization of key components - strings are prefixed with
+ * their length and numbers are stored as their bytes. The result is only
+ * hashed and never leaves the machine, so byte order does not matter.
+ */
+class key_builder
+{
+public:
+	void add(std::string_view str)
+	{
+		add(str.size());
+		data.append(str);
+	}
+
+	void add(const std::string& str) { add(std::string_view(str)); }
+
+	template <typename T>
+	void add(T value)
+	{
+		static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+		char bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		data.append(bytes, sizeof(T));
+	}
+
+	void add(const lang::elementary_item& item)
+	{
+		add(item.name);
+		add(item.price.chaos_value);
+		add(item.price.is_low_confidence);
+	}
+
+	template <typename T>
+	void add(const std::vector<T>& items)
+	{
+		add(items.size());
+		for (const T& item : items)
+			add(item);
+	}
+
+	void add(const lang::divination_card& card)
+	{
+		add(static_cast<const lang::elementary_item&>(card));
+		add(card.stack_size);
+	}
+
+	void add(const lang::gem& g)
+	{
+		add(static_cast<const lang::elementary_item&>(g));
+		add(g.level);
+		add(g.quality);
+		add(g.is_corrupted);
+	}
+
+	void add(const lang::base& b)
+	{
+		add(static_cast<const lang::elementary_item&>(b));
+		add(b.item_level);
+		add(b.influence);
+	}
+
+	// iteration order of unordered maps is unspecified - sort by keys
+	template <typename Map>
+	void add_map(const Map& map)
+	{
+		std::vector<const typename Map::value_type*> entries;
+		entries.reserve(map.size());
+		for (const auto& entry : map)
+			entries.push_back(&entry);
+
+		std::sort(entries.begin(), entries.end(), [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+		add(entries.size());
+		for (const auto* entry : entries) {
+			add(entry->first);
+			add(entry->second);
+		}
+	}
+
+	void add(const lang::unique_item_price_data& uniques)
+	{
+		add_map(uniques.unambiguous);
+		add_map(uniques.ambiguous);
+	}
+
+	void add(const lang::item_price_data& ipd)
+	{
+		add(ipd.divination_cards);
+		add(ipd.oils);
+		add(ipd.incubators);
+		add(ipd.essences);
+		add(ipd.fossils);
+		add(ipd.prophecies);
+		add(ipd.resonators);
+		add(ipd.scarabs);
+		add(ipd.helmet_enchants);
+		add(ipd.gems);
+		add(ipd.bases);
+		add(ipd.unique_eq);
+		add(ipd.unique_flasks);
+		add(ipd.unique_jewels);
+		add(ipd.unique_maps);
+	}
+
+	const std::string& str() const noexcept { return data; }
+
+private:
+	std::string data;
+};
+
+json entry_to_json(
+	const std::vector<compiler::module_cache::dependency>& imported_files,
+	const generator::filter_cache::cached_filter& filter)
+{
+	json files = json::array();
+	for (const compiler::module_cache::dependency& file : imported_files)
+		files.push_back(json{{field_path, file.path}, {field_digest, file.digest}});
+
+	return json{
+		{field_imported_files, std::move(files)},
+		{field_filter, filter.blocks},
+		{field_warnings, filter.warnings}
+	};
+}
+
+}
+
+namespace fs::generator
+{
+
+std::string filter_cache::make_key(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const options& options)
+{
+	key_builder key;
+
+	namespace v = version;
+	key.add(v::major);
+	key.add(v::minor);
+	key.add(v::patch);
+
+	// only options which affect generated blocks, keep in sync with options.hpp
+	key.add(options.strict);
+	key.add(options.remove_unreachable_blocks);
+	key.add(options.merge_blocks);
+	key.add(options.minimize_string_lists);
+	// cached warnings depend on it
+	key.add(options.warn_unused_definitions);
+	// the same import directives may refer to different files
+	key.add(options.import_directory);
+
+	key.add(input);
+	key.add(item_price_data);
+
+	return utility::sha256_hex(key.str());
+}
+
+std::shared_ptr<const filter_cache::cached_filter> filter_cache::find(const std::string& key)
+{
+	std::optional<entry> result;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (const auto it = filters.find(key); it != filters.end())
+			result = it->second;
+	}
+
+	if (!result) {
+		result = load_from_disk(key);
+
+		if (result) {
+			std::lock_guard<std::mutex> lock(mutex);
+			filters.insert_or_assign(key, *result);
+		}
+	}
+
+	const bool valid = result && compiler::files_unchanged(result->imported_files);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (valid) {
+		++stats.hits;
+		return result->filter;
+	}
+	else {
+		++stats.misses;
+		return nullptr;
+	}
+}
+
+void filter_cache::store(
+	const std::string& key,
+	std::vector<compiler::module_cache::dependency> imported_files,
+	cached_filter filter)
+{
+	entry e{std::move(imported_files), std::make_shared<const cached_filter>(std::move(filter))};
+	save_to_disk(key, e);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	filters.insert_or_assign(key, std::move(e));
+}
+
+filter_cache::statistics filter_cache::get_statistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+std::optional<filter_cache::entry> filter_cache::load_from_disk(const std::string& key) const
+{
+	if (!directory)
+		return std::nullopt;
+
+	std::error_code ec;
+	const std::string file_content = utility::load_file(*directory / (key + ".json"), ec);
+	if (ec)
+		return std::nullopt;
+
+	// the cache is only an optimization - any invalid file is treated as a miss
+	try {
+		const json j = json::parse(file_content);
+
+		entry result;
+		for (const json& file : j.at(field_imported_files))
+			result.imported_files.push_back(compiler::module_cache::dependency{
+				file.at(field_path).get<std::string>(), file.at(field_digest).get<std::string>()});
+
+		result.filter = std::make_shared<const cached_filter>(cached_filter{
+			j.at(field_filter).get<std::string>(), j.at(field_warnings).get<std::vector<std::string>>()});
+		return result;
+	}
+	catch (const json::exception&) {
+		return std::nullopt;
+	}
+}
+
+void filter_cache::save_to_disk(const std::string& key, const entry& e) const
+{
+	if (!directory)
+		return;
+
+	// failure to save only means the filter will be generated again in the next run
+	(void) utility::save_file(*directory / (key + ".json"), utility::dump_json(entry_to_json(e.imported_files, *e.filter)));
+}
+
+}
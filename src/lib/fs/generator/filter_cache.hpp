@@ -0,0 +1,98 @@
+#pragma once
+
+#include <fs/compiler/module_cache.hpp>
+#include <fs/generator/options.hpp>
+#include <fs/lang/item_price_data.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs::generator
+{
+
+/**
+ * @class cache of generated filters
+ *
+ * @details Filters are keyed by SHA-256 digest of everything that determines
+ * their content: the template, item price data, options which affect the
+ * output and the program version. Imported files are not known before the
+ * template is parsed, so they are stored with the filter and checked on
+ * lookup - just like dependencies of cached modules. If a directory is
+ * given, filters are also persisted there and reused across program runs.
+ *
+ * Only blocks are cached, the generation information at the top of the
+ * filter is made anew on every run. Warnings of the compilation are cached
+ * too, so that they can be repeated when a cached filter is reused.
+ *
+ * Thread safety: all member functions can be called concurrently.
+ */
+class filter_cache
+{
+public:
+	struct statistics
+	{
+		std::size_t hits = 0;
+		std::size_t misses = 0;
+	};
+
+	struct cached_filter
+	{
+		// without generation information
+		std::string blocks;
+		// texts of warning messages of the compilation
+		std::vector<std::string> warnings;
+	};
+
+	filter_cache() = default;
+	explicit filter_cache(boost::filesystem::path directory)
+	: directory(std::move(directory))
+	{
+	}
+
+	[[nodiscard]]
+	static std::string make_key(
+		std::string_view input,
+		const lang::item_price_data& item_price_data,
+		const options& options);
+
+	/**
+	 * @param key result of make_key()
+	 * @return cached filter or nullptr if there is none or any of its imported files changed
+	 */
+	[[nodiscard]]
+	std::shared_ptr<const cached_filter> find(const std::string& key);
+
+	void store(
+		const std::string& key,
+		std::vector<compiler::module_cache::dependency> imported_files,
+		cached_filter filter);
+
+	[[nodiscard]]
+	statistics get_statistics() const;
+
+private:
+	struct entry
+	{
+		std::vector<compiler::module_cache::dependency> imported_files;
+		std::shared_ptr<const cached_filter> filter;
+	};
+
+	[[nodiscard]]
+	std::optional<entry> load_from_disk(const std::string& key) const;
+	void save_to_disk(const std::string& key, const entry& e) const;
+
+	mutable std::mutex mutex;
+	std::unordered_map<std::string, entry> filters;
+	statistics stats;
+	std::optional<boost::filesystem::path> directory;
+};
+
+}
@@ -1,44 +1,218 @@
 #include <fs/generator/generate_filter.hpp>
 #include <fs/generator/generator.hpp>
+#include <fs/generator/filter_cache.hpp>
+#include <fs/generator/output_sink.hpp>
 #include <fs/lang/symbol_table.hpp>
 #include <fs/parser/parser.hpp>
 #include <fs/parser/ast_adapted.hpp> // required adaptation info for fs::log::structure_printer
 #include <fs/compiler/error.hpp>
 #include <fs/compiler/print_error.hpp>
 #include <fs/compiler/resolve_symbols.hpp>
+#include <fs/compiler/resolve_imports.hpp>
+#include <fs/compiler/symbol_references.hpp>
+#include <fs/compiler/module_cache.hpp>
+#include <fs/compiler/query_cache.hpp>
 #include <fs/compiler/build_filter_blocks.hpp>
+#include <fs/compiler/unreachable_blocks.hpp>
+#include <fs/compiler/merge_blocks.hpp>
+#include <fs/compiler/minimize_lists.hpp>
 #include <fs/log/logger.hpp>
+#include <fs/log/buffered_logger.hpp>
+#include <fs/log/strings.hpp>
 #include <fs/log/structure_printer.hpp>
+#include <fs/utility/parallel.hpp>
 
-namespace fs::generator
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
 {
 
-std::optional<std::string> generate_filter(
-	std::string_view input,
-	const lang::item_price_data& item_price_data,
-	const lang::item_price_metadata& item_price_metadata,
-	options options,
+using namespace fs;
+
+// symbols used only by overrides of variants are not referenced by the template
+void print_unused_definitions(
+	const lang::symbol_table& symbols,
+	const compiler::symbol_references& references,
+	lang::symbol_id first_own_symbol,
+	const std::vector<lang::symbol_id>& used_by_overrides,
+	const parser::lookup_data& lookup_data,
 	log::logger& logger)
 {
-	std::optional<std::string> maybe_filter = generate_filter_without_preamble(input, item_price_data, options, logger);
+	for (lang::symbol_id id : compiler::find_unused_symbols(symbols, references, first_own_symbol)) {
+		if (std::find(used_by_overrides.begin(), used_by_overrides.end(), id) != used_by_overrides.end())
+			continue;
 
-	if (!maybe_filter)
-		return std::nullopt;
+		logger.begin_warning_message();
+		logger.print_line_number_with_description_and_underlined_code(
+			lookup_data.get_view_of_whole_content(),
+			lookup_data.position_of(symbols[id].second.name_origin),
+			log::strings::warning,
+			"unused definition");
+		logger.end_message();
+	}
+}
 
-	std::string& filter = *maybe_filter;
-	prepend_metadata(item_price_metadata, filter);
-	return filter;
+void print_unreachable_blocks(
+	const std::vector<lang::filter_block>& blocks,
+	const std::vector<compiler::unreachable_block>& unreachable,
+	const parser::lookup_data& lookup_data,
+	log::logger& logger)
+{
+	for (compiler::unreachable_block block : unreachable) {
+		logger.begin_warning_message();
+		logger.print_line_number_with_description_and_underlined_code(
+			lookup_data.get_view_of_whole_content(),
+			lookup_data.position_of(blocks[block.index].origin),
+			log::strings::warning,
+			"unreachable block, all items it could match are matched by an earlier block");
+		logger.print_line_number_with_description_and_underlined_code(
+			lookup_data.get_view_of_whole_content(),
+			lookup_data.position_of(blocks[block.shadowed_by].origin),
+			log::strings::note,
+			"earlier block here");
+		logger.end_message();
+	}
 }
 
-std::optional<std::string> generate_filter_without_preamble(
+// passes all messages further and keeps texts of warnings, so that they can be repeated later
+class warning_recorder : public log::logger
+{
+public:
+	explicit warning_recorder(log::logger& destination)
+	: destination(destination)
+	{
+	}
+
+	void begin_info_message() override
+	{
+		destination.begin_info_message();
+	}
+
+	void begin_warning_message() override
+	{
+		recording = true;
+		warnings.emplace_back();
+		destination.begin_warning_message();
+	}
+
+	void begin_error_message() override
+	{
+		destination.begin_error_message();
+	}
+
+	void end_message() override
+	{
+		recording = false;
+		destination.end_message();
+	}
+
+	void add(std::string_view text) override
+	{
+		if (recording)
+			warnings.back() += text;
+
+		destination.add(text);
+	}
+
+	void add(char character) override
+	{
+		if (recording)
+			warnings.back() += character;
+
+		destination.add(character);
+	}
+
+	void add(int number) override
+	{
+		if (recording)
+			warnings.back() += std::to_string(number);
+
+		destination.add(number);
+	}
+
+	std::vector<std::string> take_warnings() { return std::move(warnings); }
+
+private:
+	log::logger& destination;
+	std::vector<std::string> warnings;
+	bool recording = false;
+};
+
+// passes the filter further and keeps a copy of it
+class copying_sink : public generator::output_sink
+{
+public:
+	explicit copying_sink(generator::output_sink& destination)
+	: destination(destination)
+	{
+	}
+
+	void write(std::string_view data) override
+	{
+		destination.write(data);
+		copy.append(data);
+	}
+
+	std::string take_copy() { return std::move(copy); }
+
+private:
+	generator::output_sink& destination;
+	std::string copy;
+};
+
+// template symbols referenced by overrides of variants (null for variants which failed to parse)
+std::vector<lang::symbol_id> symbols_used_by_overrides(
+	const std::vector<std::optional<parser::parse_success_data>>& variant_overrides,
+	const lang::symbol_table& symbols)
+{
+	std::vector<lang::symbol_id> result;
+	for (const std::optional<parser::parse_success_data>& overrides : variant_overrides) {
+		if (!overrides)
+			continue;
+
+		// each parse has its own position IDs, so it needs its own references
+		compiler::symbol_references references;
+		for (const parser::ast::definition& def : overrides->ast.definitions) {
+			compiler::resolve_references(def.definition.value, symbols, references);
+			for (lang::symbol_id id : compiler::referenced_symbols(def.definition.value, references))
+				result.push_back(id);
+		}
+	}
+
+	return result;
+}
+
+// parsed template with evaluated definitions, shared by all its variants
+struct compiled_template
+{
+	parser::parse_success_data parse_data;
+	lang::symbol_table symbols;
+	compiler::symbol_references references;
+	lang::symbol_id first_own_symbol;
+	// all (also indirectly) imported files
+	std::vector<compiler::module_cache::dependency> imported_files;
+};
+
+/*
+ * Definitions used by overrides of variants are evaluated too, even if
+ * the template itself does not use them.
+ */
+std::optional<compiled_template> compile_template(
 	std::string_view input,
 	const lang::item_price_data& item_price_data,
-	options options,
-	log::logger& logger)
+	const generator::options& options,
+	compiler::query_cache& queries,
+	log::logger& logger,
+	const std::vector<std::optional<parser::parse_success_data>>& variant_overrides = {})
 {
 	logger.info() << "" << item_price_data; // TODO fix .info() etc so that it does not return rvalue
 	logger.info() << "parsing filter template";
-	std::variant<parser::parse_success_data, parser::parse_failure_data> parse_result = parser::parse(input);
+	std::variant<parser::parse_success_data, parser::parse_failure_data> parse_result = parser::parse_parallel(input, options.num_threads);
 
 	if (std::holds_alternative<parser::parse_failure_data>(parse_result))
 	{
@@ -47,35 +221,336 @@ std::optional<std::string> generate_filter_without_preamble(
 	}
 
 	logger.info() << "parse successful";
-	const auto& parse_data = std::get<parser::parse_success_data>(parse_result);
+	auto& parse_data = std::get<parser::parse_success_data>(parse_result);
 
 	if (options.print_ast)
 		fs::log::structure_printer()(parse_data.ast);
 
 	logger.info() << "compiling filter template";
 
-	std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error =
-		compiler::resolve_symbols(parse_data.ast.definitions, item_price_data);
+	compiler::module_cache local_module_cache;
+	compiler::module_cache& module_cache = options.module_cache != nullptr ? *options.module_cache : local_module_cache;
+	std::vector<compiler::module_cache::dependency> imported_files;
+	std::variant<lang::symbol_table, compiler::compile_error> imports_or_error =
+		compiler::resolve_imports(parse_data.ast.imports, options.import_directory, item_price_data, module_cache, &imported_files);
+	if (std::holds_alternative<compiler::compile_error>(imports_or_error))
+	{
+		compiler::print_error(std::get<compiler::compile_error>(imports_or_error), parse_data.lookup_data, logger);
+		return std::nullopt;
+	}
+
+	// definitions of the template get IDs after imported symbols
+	auto& imported_symbols = std::get<lang::symbol_table>(imports_or_error);
+	const auto first_own_symbol = static_cast<lang::symbol_id>(imported_symbols.size());
+
+	compiler::symbol_references references;
+	std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = options.strict
+		? compiler::resolve_symbols(
+			parse_data.ast.definitions, item_price_data, std::move(imported_symbols), references, options.num_threads, &queries)
+		: compiler::resolve_symbols_used_by(
+			parse_data.ast.definitions, parse_data.ast.statements, item_price_data, std::move(imported_symbols), references, options.num_threads, &queries);
 	if (std::holds_alternative<compiler::compile_error>(symbols_or_error))
 	{
 		compiler::print_error(std::get<compiler::compile_error>(symbols_or_error), parse_data.lookup_data, logger);
 		return std::nullopt;
 	}
 
-	const auto& map = std::get<lang::symbol_table>(symbols_or_error);
-	const std::variant<std::vector<lang::filter_block>, compiler::compile_error> filter_or_error =
-		compiler::build_filter_blocks(parse_data.ast.statements, map, item_price_data);
+	if (options.strict)
+		compiler::resolve_references(parse_data.ast.statements, std::get<lang::symbol_table>(symbols_or_error), references);
+
+	const std::vector<lang::symbol_id> used_by_overrides =
+		symbols_used_by_overrides(variant_overrides, std::get<lang::symbol_table>(symbols_or_error));
+	if (!options.strict && !used_by_overrides.empty()) {
+		symbols_or_error = compiler::resolve_symbols_needed_by(
+			parse_data.ast.definitions,
+			parse_data.ast.statements,
+			used_by_overrides,
+			item_price_data,
+			std::get<lang::symbol_table>(std::move(symbols_or_error)),
+			references,
+			first_own_symbol,
+			options.num_threads,
+			&queries);
+		if (std::holds_alternative<compiler::compile_error>(symbols_or_error))
+		{
+			compiler::print_error(std::get<compiler::compile_error>(symbols_or_error), parse_data.lookup_data, logger);
+			return std::nullopt;
+		}
+	}
+
+	auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+	if (options.warn_unused_definitions)
+		print_unused_definitions(symbols, references, first_own_symbol, used_by_overrides, parse_data.lookup_data, logger);
+
+	return compiled_template{
+		std::move(parse_data), std::move(symbols), std::move(references), first_own_symbol, std::move(imported_files)};
+}
+
+// symbols are the template's or of its variant
+std::optional<std::vector<lang::filter_block>> build_blocks(
+	const compiled_template& tmpl,
+	const lang::symbol_table& symbols,
+	const lang::item_price_data& item_price_data,
+	const generator::options& options,
+	unsigned num_threads,
+	compiler::query_cache& queries,
+	log::logger& logger)
+{
+	const parser::lookup_data& lookup_data = tmpl.parse_data.lookup_data;
+	std::variant<std::vector<lang::filter_block>, compiler::compile_error> filter_or_error =
+		compiler::build_filter_blocks(tmpl.parse_data.ast.statements, symbols, tmpl.references, item_price_data, num_threads, &queries);
 
 	if (std::holds_alternative<compiler::compile_error>(filter_or_error))
 	{
-		compiler::print_error(std::get<compiler::compile_error>(filter_or_error), parse_data.lookup_data, logger);
+		compiler::print_error(std::get<compiler::compile_error>(filter_or_error), lookup_data, logger);
+		return std::nullopt;
+	}
+
+	auto& blocks = std::get<std::vector<lang::filter_block>>(filter_or_error);
+	const std::vector<compiler::unreachable_block> unreachable = compiler::find_unreachable_blocks(blocks);
+	print_unreachable_blocks(blocks, unreachable, lookup_data, logger);
+	if (options.remove_unreachable_blocks)
+		compiler::remove_unreachable_blocks(blocks, unreachable);
+
+	if (options.merge_blocks) {
+		const compiler::merge_statistics merge_stats = compiler::merge_adjacent_blocks(blocks);
+		logger.info() << "merged " << static_cast<int>(merge_stats.merged_blocks) << " blocks ("
+			<< static_cast<int>(merge_stats.saved_lines) << " lines saved)";
+	}
+
+	if (options.minimize_string_lists) {
+		const std::size_t removed_strings = compiler::minimize_string_lists(blocks);
+		logger.info() << "removed " << static_cast<int>(removed_strings) << " redundant strings from condition lists";
+	}
+
+	return std::move(blocks);
+}
+
+std::optional<std::vector<lang::filter_block>> compile_filter(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const generator::options& options,
+	log::logger& logger,
+	std::vector<compiler::module_cache::dependency>* imported_files = nullptr)
+{
+	compiler::query_cache queries;
+	const std::optional<compiled_template> tmpl = compile_template(input, item_price_data, options, queries, logger);
+	if (!tmpl)
 		return std::nullopt;
+
+	std::optional<std::vector<lang::filter_block>> blocks =
+		build_blocks(*tmpl, tmpl->symbols, item_price_data, options, options.num_threads, queries, logger);
+	if (!blocks)
+		return std::nullopt;
+
+	const compiler::query_cache::statistics query_stats = queries.get_statistics();
+	logger.info() << "compilation successful (price queries: "
+		<< static_cast<int>(query_stats.misses) << " evaluated, " << static_cast<int>(query_stats.hits) << " reused)";
+
+	if (imported_files != nullptr)
+		*imported_files = tmpl->imported_files;
+
+	return blocks;
+}
+
+std::optional<parser::parse_success_data> parse_overrides(
+	const generator::filter_variant& variant,
+	log::logger& logger)
+{
+	std::variant<parser::parse_success_data, parser::parse_failure_data> parse_result = parser::parse(variant.overrides);
+	if (std::holds_alternative<parser::parse_failure_data>(parse_result))
+	{
+		parser::print_parse_errors(std::get<parser::parse_failure_data>(parse_result), logger);
+		return std::nullopt;
+	}
+
+	auto& overrides_data = std::get<parser::parse_success_data>(parse_result);
+	if (!overrides_data.ast.imports.empty() || !overrides_data.ast.statements.empty()) {
+		logger.error() << "overrides of variant " << variant.name << " can contain only definitions";
+		return std::nullopt;
+	}
+
+	return std::move(overrides_data);
+}
+
+/*
+ * Only definitions affected by overrides are evaluated again. Errors in
+ * overrides are reported with their own source, all other errors with
+ * the template source.
+ */
+bool generate_variant(
+	const compiled_template& tmpl,
+	const generator::filter_variant& variant,
+	const parser::parse_success_data& overrides_data,
+	const lang::item_price_data& item_price_data,
+	std::string_view preamble,
+	const generator::options& options,
+	compiler::query_cache& queries,
+	log::logger& logger)
+{
+	std::variant<std::vector<compiler::symbol_override>, compiler::compile_error> overrides_or_error =
+		compiler::evaluate_overrides(overrides_data.ast.definitions, item_price_data, tmpl.symbols, tmpl.first_own_symbol, &queries);
+	if (std::holds_alternative<compiler::compile_error>(overrides_or_error))
+	{
+		compiler::print_error(std::get<compiler::compile_error>(overrides_or_error), overrides_data.lookup_data, logger);
+		return false;
+	}
+
+	const parser::ast::ast_type& ast = tmpl.parse_data.ast;
+	std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = compiler::resolve_variant_symbols(
+		ast.definitions,
+		options.strict ? nullptr : &ast.statements,
+		item_price_data,
+		tmpl.symbols,
+		tmpl.references,
+		tmpl.first_own_symbol,
+		std::get<std::vector<compiler::symbol_override>>(std::move(overrides_or_error)),
+		1,
+		&queries);
+	if (std::holds_alternative<compiler::compile_error>(symbols_or_error))
+	{
+		compiler::print_error(std::get<compiler::compile_error>(symbols_or_error), tmpl.parse_data.lookup_data, logger);
+		return false;
+	}
+
+	const std::optional<std::vector<lang::filter_block>> blocks = build_blocks(
+		tmpl, std::get<lang::symbol_table>(symbols_or_error), item_price_data, options, 1, queries, logger);
+	if (!blocks)
+		return false;
+
+	variant.output->write(preamble);
+	generator::write_blocks(*blocks, *variant.output, 1);
+	return true;
+}
+
+} // namespace
+
+namespace fs::generator
+{
+
+bool generate_filter(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const lang::item_price_metadata& item_price_metadata,
+	options options,
+	output_sink& output,
+	log::logger& logger)
+{
+	// printing the AST requires parsing, do not skip it
+	if (options.filter_cache == nullptr || options.print_ast) {
+		const std::optional<std::vector<lang::filter_block>> blocks = compile_filter(input, item_price_data, options, logger);
+
+		if (!blocks)
+			return false;
+
+		output.write(make_metadata_preamble(item_price_metadata));
+		write_blocks(*blocks, output, options.num_threads);
+		return true;
+	}
+
+	filter_cache& cache = *options.filter_cache;
+	const std::string key = filter_cache::make_key(input, item_price_data, options);
+	if (const std::shared_ptr<const filter_cache::cached_filter> cached = cache.find(key); cached) {
+		logger.info() << "template, imported files, item price data and options unchanged - reusing cached filter";
+		for (const std::string& warning : cached->warnings)
+			logger.warning() << warning;
+
+		output.write(make_metadata_preamble(item_price_metadata));
+		output.write(cached->blocks);
+		return true;
+	}
+
+	std::vector<compiler::module_cache::dependency> imported_files;
+	warning_recorder recorder(logger);
+	const std::optional<std::vector<lang::filter_block>> blocks = compile_filter(input, item_price_data, options, recorder, &imported_files);
+
+	if (!blocks)
+		return false;
+
+	output.write(make_metadata_preamble(item_price_metadata));
+	copying_sink copying_output(output);
+	write_blocks(*blocks, copying_output, options.num_threads);
+	cache.store(key, std::move(imported_files), filter_cache::cached_filter{copying_output.take_copy(), recorder.take_warnings()});
+	return true;
+}
+
+std::optional<std::string> generate_filter(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const lang::item_price_metadata& item_price_metadata,
+	options options,
+	log::logger& logger)
+{
+	string_sink output;
+
+	if (!generate_filter(input, item_price_data, item_price_metadata, options, output, logger))
+		return std::nullopt;
+
+	return std::move(output).str();
+}
+
+std::optional<std::string> generate_filter_without_preamble(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	options options,
+	log::logger& logger)
+{
+	const std::optional<std::vector<lang::filter_block>> blocks = compile_filter(input, item_price_data, options, logger);
+
+	if (!blocks)
+		return std::nullopt;
+
+	return assemble_blocks_to_raw_filter(*blocks, options.num_threads);
+}
+
+std::vector<bool> generate_filter_variants(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const lang::item_price_metadata& item_price_metadata,
+	options options,
+	const std::vector<filter_variant>& variants,
+	log::logger& logger)
+{
+	// each variant logs to its own buffer, logs are printed in order of variants
+	std::vector<std::string> logs(variants.size());
+
+	// overrides are parsed first - template definitions used by them must be evaluated
+	std::vector<std::optional<parser::parse_success_data>> overrides(variants.size());
+	for (std::size_t i = 0; i < variants.size(); ++i) {
+		log::buffered_logger variant_logger;
+		overrides[i] = parse_overrides(variants[i], variant_logger);
+		logs[i] = variant_logger.flush_out();
+	}
+
+	compiler::query_cache queries;
+	const std::optional<compiled_template> tmpl = compile_template(input, item_price_data, options, queries, logger, overrides);
+	if (!tmpl)
+		return std::vector<bool>(variants.size(), false);
+
+	const std::string preamble = make_metadata_preamble(item_price_metadata);
+
+	std::vector<char> results(variants.size(), false);
+	utility::parallel_for(variants.size(), utility::resolve_thread_count(options.num_threads), [&](std::size_t i) {
+		if (!overrides[i])
+			return;
+
+		log::buffered_logger variant_logger;
+		results[i] = generate_variant(*tmpl, variants[i], *overrides[i], item_price_data, preamble, options, queries, variant_logger);
+		logs[i] += variant_logger.flush_out();
+	});
+
+	for (std::size_t i = 0; i < variants.size(); ++i) {
+		if (results[i])
+			logger.info() << "variant " << variants[i].name << " generated\n" << logs[i];
+		else
+			logger.error() << "variant " << variants[i].name << " failed\n" << logs[i];
 	}
 
-	logger.info() << "compilation successful";
+	const compiler::query_cache::statistics query_stats = queries.get_statistics();
+	logger.info() << "price queries: "
+		<< static_cast<int>(query_stats.misses) << " evaluated, " << static_cast<int>(query_stats.hits) << " reused";
 
-	const auto& blocks = std::get<std::vector<lang::filter_block>>(filter_or_error);
-	return assemble_blocks_to_raw_filter(blocks);
+	return std::vector<bool>(results.begin(), results.end());
 }
 
 }
@@ -3,14 +3,39 @@
 #include <fs/lang/item_price_data.hpp>
 #include <fs/lang/item_price_metadata.hpp>
 #include <fs/generator/options.hpp>
+#include <fs/generator/output_sink.hpp>
 #include <fs/log/logger_fwd.hpp>
 
+#include <string>
 #include <string_view>
 #include <optional>
+#include <vector>
 
 namespace fs::generator
 {
 
+/**
+ * @brief end-to-end filter generation function, streams the filter to the output
+ *
+ * @details The filter is written in pieces (generation information
+ * first) and only after the template compiled successfully, so on
+ * failure nothing is written.
+ *
+ * If options.filter_cache is set, a filter generated earlier from the
+ * same template, imported files, item price data and options is reused
+ * without compiling anything.
+ *
+ * @return true if the filter was generated
+ */
+[[nodiscard]]
+bool generate_filter(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const lang::item_price_metadata& item_price_metadata,
+	options options,
+	output_sink& output,
+	log::logger& logger);
+
 /**
  * @brief end-to-end filter generation function
  *
@@ -28,6 +53,36 @@ std::optional<std::string> generate_filter(
 	options options,
 	log::logger& logger);
 
+struct filter_variant
+{
+	std::string name;
+	// definitions in the template language, each replaces the template definition of the same name
+	std::string overrides;
+	// where to write the variant, must not be shared with other variants
+	output_sink* output;
+};
+
+/**
+ * @brief generate multiple variants of one template
+ *
+ * @details The template is parsed and its imports and definitions are
+ * evaluated once. A variant then evaluates again only definitions that
+ * depend on its overrides (eg a strictness level or a color palette), all
+ * other objects are shared. Variants are compiled and written concurrently
+ * (up to options.num_threads at once). A failed variant does not stop
+ * others, nothing is written to outputs of failed variants.
+ *
+ * @return for each variant, whether it has been generated
+ */
+[[nodiscard]]
+std::vector<bool> generate_filter_variants(
+	std::string_view input,
+	const lang::item_price_data& item_price_data,
+	const lang::item_price_metadata& item_price_metadata,
+	options options,
+	const std::vector<filter_variant>& variants,
+	log::logger& logger);
+
 // mostly for tests
 [[nodiscard]]
 std::optional<std::string> generate_filter_without_preamble(
@@ -1,13 +1,18 @@
 #include <fs/generator/generator.hpp>
 #include <fs/lang/filter_block.hpp>
+#include <fs/utility/parallel.hpp>
+#include <fs/utility/string_builder.hpp>
 #include <fs/version.hpp>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
 #include <string_view>
-#include <sstream>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -37,26 +42,153 @@ std::string ptime_to_pretty_string(boost::posix_time::ptime time)
 	return result;
 }
 
+std::size_t estimate_generated_size(const fs::lang::strings_condition& condition)
+{
+	if (condition.strings == nullptr)
+		return 0;
+
+	std::size_t result = 32; // name of the condition
+	for (const std::string& str : *condition.strings)
+		result += str.size() + 3; // space and quotes
+
+	return result;
+}
+
+// strings dominate the output of bigger filters, everything else is small and bounded
+std::size_t estimate_generated_size(const fs::lang::filter_block& block)
+{
+	const fs::lang::condition_set& conditions = *block.conditions;
+	return 256
+		+ estimate_generated_size(conditions.class_)
+		+ estimate_generated_size(conditions.base_type)
+		+ estimate_generated_size(conditions.has_explicit_mod)
+		+ estimate_generated_size(conditions.has_enchantment)
+		+ estimate_generated_size(conditions.prophecy);
+}
+
+// few hundred kilobytes of text - enough work to be worth a thread
+constexpr std::size_t blocks_per_chunk = 256;
+
+// the preamble is recognized by these, everything between them may change
+constexpr std::string_view preamble_first_line = "# autogenerated by Filter Spirit";
+constexpr std::string_view preamble_last_lines = "# May the drops be with you.\n\n";
+
+std::size_t number_of_chunks(const std::vector<fs::lang::filter_block>& blocks)
+{
+	return (blocks.size() + blocks_per_chunk - 1) / blocks_per_chunk;
+}
+
+void generate_chunk(
+	const std::vector<fs::lang::filter_block>& blocks,
+	std::size_t chunk_index,
+	fs::utility::string_builder& output)
+{
+	const auto first = blocks.begin() + chunk_index * blocks_per_chunk;
+	const auto last = blocks.begin() + std::min(blocks.size(), (chunk_index + 1) * blocks_per_chunk);
+
+	std::size_t expected_size = 0;
+	for (auto it = first; it != last; ++it)
+		expected_size += estimate_generated_size(*it);
+
+	output.clear();
+	output.reserve(expected_size);
+
+	for (auto it = first; it != last; ++it)
+		it->generate(output);
+}
+
+// generates chunks [first_chunk, first_chunk + outputs.size()) concurrently
+void generate_chunks(
+	const std::vector<fs::lang::filter_block>& blocks,
+	std::size_t first_chunk,
+	std::vector<fs::utility::string_builder>& outputs,
+	unsigned num_threads)
+{
+	fs::utility::parallel_for(outputs.size(), num_threads, [&](std::size_t i) {
+		generate_chunk(blocks, first_chunk + i, outputs[i]);
+	});
+}
+
 }
 
 namespace fs::generator
 {
 
-std::string assemble_blocks_to_raw_filter(const std::vector<lang::filter_block>& blocks)
+std::string assemble_blocks_to_raw_filter(const std::vector<lang::filter_block>& blocks, unsigned num_threads)
 {
-	std::stringstream ss;
+	num_threads = utility::resolve_thread_count(num_threads);
 
-	for (const lang::filter_block& block : blocks)
-		block.generate(ss);
+	if (num_threads == 1) {
+		std::size_t expected_size = 0;
+		for (const lang::filter_block& block : blocks)
+			expected_size += estimate_generated_size(block);
 
-	return ss.str();
+		utility::string_builder output(expected_size);
+
+		for (const lang::filter_block& block : blocks)
+			block.generate(output);
+
+		return std::move(output).str();
+	}
+
+	std::vector<utility::string_builder> chunks(number_of_chunks(blocks));
+	generate_chunks(blocks, 0, chunks, num_threads);
+
+	std::size_t total_size = 0;
+	for (const utility::string_builder& chunk : chunks)
+		total_size += chunk.size();
+
+	utility::string_builder output(total_size);
+	for (const utility::string_builder& chunk : chunks)
+		output << chunk.str();
+
+	return std::move(output).str();
+}
+
+void write_blocks(const std::vector<lang::filter_block>& blocks, output_sink& output, unsigned num_threads)
+{
+	num_threads = utility::resolve_thread_count(num_threads);
+
+	if (num_threads == 1) {
+		// big enough to amortize writes, small enough to stay in cache
+		constexpr std::size_t chunk_size = 1 << 16;
+		utility::string_builder chunk(2 * chunk_size);
+
+		for (const lang::filter_block& block : blocks) {
+			block.generate(chunk);
+
+			if (chunk.size() >= chunk_size) {
+				output.write(chunk.str());
+				chunk.clear();
+			}
+		}
+
+		if (chunk.size() > 0)
+			output.write(chunk.str());
+
+		return;
+	}
+
+	// only a window of chunks is held in memory at a time, buffers are reused
+	const std::size_t total_chunks = number_of_chunks(blocks);
+	const std::size_t window = 2 * static_cast<std::size_t>(num_threads);
+	std::vector<utility::string_builder> chunks;
+
+	for (std::size_t first_chunk = 0; first_chunk < total_chunks; first_chunk += window) {
+		chunks.resize(std::min(window, total_chunks - first_chunk));
+		generate_chunks(blocks, first_chunk, chunks, num_threads);
+
+		for (const utility::string_builder& chunk : chunks)
+			output.write(chunk.str());
+	}
 }
 
-void prepend_metadata(const lang::item_price_metadata& metadata, std::string& raw_filter)
+std::string make_metadata_preamble(const lang::item_price_metadata& metadata)
 {
 	namespace v = version;
-	std::string data_to_prepend =
-R"(# autogenerated by Filter Spirit - an advanced item filter generator for Path of Exile
+	std::string preamble(preamble_first_line);
+	preamble +=
+R"( - an advanced item filter generator for Path of Exile
 # Write filters in an enhanced language with the ability to query item prices. Refresh whenever you want.
 #
 # read tutorial, browse documentation, ask questions, report bugs on: github.com/Xeverous/filter_spirit
@@ -68,17 +200,28 @@ R"(# autogenerated by Filter Spirit - an advanced item filter generator for Path
 #
 # Generation info:
 )";
-	data_to_prepend +=
+	preamble +=
 "#     Filter Spirit version     : " + std::to_string(v::major) + "." + std::to_string(v::minor) + "." + std::to_string(v::patch) + "\n"
 "#     filter generation date    : " + ptime_to_pretty_string(boost::posix_time::microsec_clock::universal_time()) + "\n"
 "#     item price data downloaded: " + ptime_to_pretty_string(metadata.download_date) + "\n"
 "#     item price data from      : " + std::string(lang::to_string(metadata.data_source)) + "\n"
 "#     item price data for league: " + metadata.league_name + "\n"
-"#\n"
-"# May the drops be with you.\n"
-"\n";
+"#\n";
+	preamble += preamble_last_lines;
+
+	return preamble;
+}
+
+std::string_view remove_metadata_preamble(std::string_view filter)
+{
+	if (filter.compare(0, preamble_first_line.size(), preamble_first_line) != 0)
+		return filter;
+
+	const auto end = filter.find(preamble_last_lines);
+	if (end == std::string_view::npos)
+		return filter;
 
-	raw_filter = data_to_prepend + raw_filter;
+	return filter.substr(end + preamble_last_lines.size());
 }
 
 }
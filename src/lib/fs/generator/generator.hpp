@@ -1,17 +1,34 @@
 #pragma once
 
+#include <fs/generator/output_sink.hpp>
 #include <fs/lang/filter_block.hpp>
 #include <fs/lang/item_price_metadata.hpp>
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace fs::generator
 {
 
+/*
+ * Text of blocks is generated using up to num_threads threads (0 means all
+ * hardware threads): consecutive blocks are grouped in chunks, each chunk is
+ * generated into its own buffer and buffers are joined in order. The output
+ * is the same for any number of threads.
+ */
 [[nodiscard]]
-std::string assemble_blocks_to_raw_filter(const std::vector<lang::filter_block>& blocks);
+std::string assemble_blocks_to_raw_filter(const std::vector<lang::filter_block>& blocks, unsigned num_threads = 1);
 
-void prepend_metadata(const lang::item_price_metadata& metadata, std::string& raw_filter);
+// as above but writes to the output in chunks, without building the whole filter
+void write_blocks(const std::vector<lang::filter_block>& blocks, output_sink& output, unsigned num_threads = 1);
+
+// comment at the top of the filter with generation information
+[[nodiscard]]
+std::string make_metadata_preamble(const lang::item_price_metadata& metadata);
+
+// the filter without the above comment, unchanged if it has no such comment
+[[nodiscard]]
+std::string_view remove_metadata_preamble(std::string_view filter);
 
 }
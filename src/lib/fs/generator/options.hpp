@@ -1,11 +1,42 @@
 #pragma once
 
+#include <string>
+
+namespace fs::compiler
+{
+
+class module_cache;
+
+}
+
 namespace fs::generator
 {
 
+class filter_cache;
+
+// options which affect generated blocks or warnings are a part of filter_cache keys
 struct options
 {
 	bool print_ast = false;
+	// evaluate also definitions which are not used by any block (reports their errors),
+	// by default they are skipped and their errors are not reported
+	bool strict = false;
+	// warn about definitions which are not used by any block or other definition
+	bool warn_unused_definitions = false;
+	// leave out blocks which no item can reach (they are reported as warnings either way)
+	bool remove_unreachable_blocks = false;
+	// join consecutive blocks which differ only in one list of strings (eg BaseType)
+	bool merge_blocks = false;
+	// sort lists of non-exact string conditions and remove entries which contain other entries
+	bool minimize_string_lists = false;
+	// number of threads for parallelizable work, 0 means all hardware threads
+	unsigned num_threads = 0;
+	// directory against which relative import paths are resolved, empty means current directory
+	std::string import_directory;
+	// cache of imported files, shared between generations - can be null
+	compiler::module_cache* module_cache = nullptr;
+	// cache of generated filters, shared between generations - can be null
+	generator::filter_cache* filter_cache = nullptr;
 };
 
 }
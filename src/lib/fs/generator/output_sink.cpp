@@ -0,0 +1,121 @@
+#include <fs/generator/output_sink.hpp>
+#include <fs/generator/generator.hpp>
+#include <fs/utility/file.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+namespace fs::generator
+{
+
+namespace bfs = boost::filesystem;
+
+output_status combine(output_status lhs, output_status rhs)
+{
+	if (lhs == output_status::failed || rhs == output_status::failed)
+		return output_status::failed;
+
+	if (lhs == output_status::written || rhs == output_status::written)
+		return output_status::written;
+
+	return output_status::unchanged;
+}
+
+file_sink::file_sink(bfs::path path, std::size_t buffer_size)
+: file_sink(std::move(path), write_policy::always, buffer_size)
+{
+}
+
+file_sink::file_sink(bfs::path path, write_policy policy, std::size_t buffer_size)
+: path(std::move(path))
+, buffer_size(buffer_size)
+, policy(policy)
+{
+}
+
+void file_sink::write(std::string_view data)
+{
+	// nothing can be written before the whole output is known
+	if (policy == write_policy::if_changed) {
+		buffer.append(data);
+		return;
+	}
+
+	if (buffer.size() + data.size() <= buffer_size) {
+		if (buffer.capacity() < buffer_size)
+			buffer.reserve(buffer_size);
+
+		buffer.append(data);
+		return;
+	}
+
+	write_to_file(buffer);
+	buffer.clear();
+
+	if (data.size() >= buffer_size)
+		write_to_file(data);
+	else
+		buffer.append(data);
+}
+
+std::error_code file_sink::finish()
+{
+	if (policy == write_policy::if_changed && same_as_existing_file()) {
+		is_unchanged = true;
+		buffer.clear();
+		return error;
+	}
+
+	write_to_file(buffer);
+	buffer.clear();
+
+	// nothing has been written - still create the (empty) file
+	if (!error && !file.is_open())
+		write_to_file({});
+
+	if (file.is_open()) {
+		file.close();
+
+		if (!error && file.fail())
+			error = std::make_error_code(std::io_errc::stream);
+	}
+
+	return error;
+}
+
+void file_sink::write_to_file(std::string_view data)
+{
+	if (error)
+		return;
+
+	if (!file.is_open()) {
+		if (bfs::is_directory(path)) {
+			error = std::make_error_code(std::errc::is_a_directory);
+			return;
+		}
+
+		// data is already collected in big chunks, do not buffer it again
+		file.rdbuf()->pubsetbuf(nullptr, 0);
+		file.open(path, std::ios::binary | std::ios::trunc);
+
+		if (!file.good()) {
+			error = std::make_error_code(std::io_errc::stream);
+			return;
+		}
+	}
+
+	if (!data.empty() && !file.write(data.data(), data.size()))
+		error = std::make_error_code(std::io_errc::stream);
+}
+
+bool file_sink::same_as_existing_file() const
+{
+	// a missing or unreadable file is simply replaced
+	std::error_code ec;
+	const std::string existing = utility::load_file(path, ec);
+	if (ec)
+		return false;
+
+	return remove_metadata_preamble(existing) == remove_metadata_preamble(buffer);
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace fs::generator
+{
+
+/**
+ * @class destination of generated filter text
+ *
+ * @details Generation writes the filter in pieces, in order, so that
+ * the whole filter does not have to be held in memory.
+ */
+class output_sink
+{
+public:
+	virtual ~output_sink() = default;
+
+	virtual void write(std::string_view data) = 0;
+};
+
+// collects the output in memory
+class string_sink : public output_sink
+{
+public:
+	void write(std::string_view data) override { output.append(data); }
+
+	const std::string& str() const & noexcept { return output; }
+	std::string str() && noexcept { return std::move(output); }
+
+private:
+	std::string output;
+};
+
+enum class write_policy
+{
+	// always (re)write the file
+	always,
+	// leave the file untouched if it already contains the same filter,
+	// ignoring generation information (dates, versions) at the top
+	if_changed
+};
+
+// outcome of generating one or more output files
+enum class output_status
+{
+	failed,
+	written,
+	// with write_policy::if_changed: all outputs already had the same filter
+	unchanged
+};
+
+// failed if any failed, otherwise written if any was written
+[[nodiscard]] output_status combine(output_status lhs, output_status rhs);
+
+/**
+ * @class writes the output to a file
+ *
+ * @details The file is created (or truncated) on first write, so nothing
+ * happens to an existing file if generation fails before producing any
+ * output. Data is collected in a large buffer and written in big chunks,
+ * chunks bigger than the buffer are written directly.
+ *
+ * With write_policy::if_changed the whole output is held in memory and
+ * compared with the existing file in finish(), the file is written only
+ * if they differ - this way file watchers and synchronization tools are
+ * not woken up when price changes did not affect the filter.
+ *
+ * Errors are not reported until finish().
+ */
+class file_sink : public output_sink
+{
+public:
+	static constexpr std::size_t default_buffer_size = 1 << 20;
+
+	explicit file_sink(boost::filesystem::path path, std::size_t buffer_size = default_buffer_size);
+	file_sink(boost::filesystem::path path, write_policy policy, std::size_t buffer_size = default_buffer_size);
+
+	void write(std::string_view data) override;
+
+	// writes remaining data and closes the file - call it once, after all writes
+	[[nodiscard]] std::error_code finish();
+
+	// after successful finish(): whether the file has been left untouched
+	bool unchanged() const noexcept { return is_unchanged; }
+
+private:
+	void write_to_file(std::string_view data);
+	bool same_as_existing_file() const;
+
+	boost::filesystem::path path;
+	boost::filesystem::ofstream file;
+	std::string buffer;
+	std::size_t buffer_size;
+	write_policy policy;
+	bool is_unchanged = false;
+	std::error_code error;
+};
+
+}
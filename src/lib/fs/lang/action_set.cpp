@@ -2,144 +2,174 @@
 #include <fs/lang/generation.hpp>
 #include <fs/utility/visitor.hpp>
 
-#include <ostream>
+#include <boost/functional/hash.hpp>
 
 namespace
 {
 
 using namespace fs;
 
+void hash_combine(std::size_t& seed, const std::optional<lang::color>& color)
+{
+	boost::hash_combine(seed, color.has_value());
+	if (!color)
+		return;
+
+	boost::hash_combine(seed, (*color).r);
+	boost::hash_combine(seed, (*color).g);
+	boost::hash_combine(seed, (*color).b);
+	boost::hash_combine(seed, (*color).a.value_or(-1));
+}
+
+void hash_combine(std::size_t& seed, const std::optional<lang::alert_sound>& alert_sound)
+{
+	boost::hash_combine(seed, alert_sound.has_value());
+	if (!alert_sound)
+		return;
+
+	std::visit(utility::visitor{
+		[&](const lang::built_in_alert_sound& sound) {
+			boost::hash_combine(seed, sound.id.value);
+			boost::hash_combine(seed, sound.volume.has_value() ? (*sound.volume).value : -1);
+			boost::hash_combine(seed, sound.is_positional.value);
+		},
+		[&](const lang::custom_alert_sound& sound) {
+			boost::hash_combine(seed, sound.path.value);
+		}
+	}, (*alert_sound).sound);
+}
+
 void output_color_action(
 	std::optional<lang::color> color,
 	const char* name,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!color.has_value())
 		return;
 
 	const lang::color& c = *color;
-	output_stream << '\t' << name << ' ' << c.r << ' ' << c.g << ' ' << c.b;
+	output << '\t' << name << ' ' << c.r << ' ' << c.g << ' ' << c.b;
 	if (c.a.has_value())
-		output_stream << ' ' << *c.a;
+		output << ' ' << *c.a;
 
-	output_stream << '\n';
+	output << '\n';
 }
 
 void output_font_size(
 	std::optional<lang::font_size> font_size,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!font_size.has_value())
 		return;
 
-	output_stream << '\t' << lang::generation::set_font_size << ' ' << (*font_size).value << '\n';
+	output << '\t' << lang::generation::set_font_size << ' ' << (*font_size).value << '\n';
 }
 
 void output_built_in_alert_sound(
 	lang::built_in_alert_sound alert_sound,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
-	output_stream << '\t';
+	output << '\t';
 
 	if (alert_sound.is_positional.value)
-		output_stream << lang::generation::play_alert_sound_positional;
+		output << lang::generation::play_alert_sound_positional;
 	else
-		output_stream << lang::generation::play_alert_sound;
+		output << lang::generation::play_alert_sound;
 
-	output_stream << ' ' << alert_sound.id.value;
+	output << ' ' << alert_sound.id.value;
 
 	if (alert_sound.volume.has_value())
-		output_stream << ' ' << (*alert_sound.volume).value;
+		output << ' ' << (*alert_sound.volume).value;
 
-	output_stream << '\n';
+	output << '\n';
 }
 
 void output_custom_alert_sound(
 	const lang::custom_alert_sound& alert_sound,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
-	output_stream << '\t' << lang::generation::custom_alert_sound
+	output << '\t' << lang::generation::custom_alert_sound
 		<< " \"" << alert_sound.path.value << "\"\n";
 }
 
 void output_alert_sound(
 	const std::optional<lang::alert_sound>& alert_sound,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!alert_sound.has_value())
 		return;
 
 	const lang::alert_sound& as = *alert_sound;
 	std::visit(utility::visitor{
-		[&output_stream](lang::built_in_alert_sound sound)
+		[&output](lang::built_in_alert_sound sound)
 		{
-			output_built_in_alert_sound(sound, output_stream);
+			output_built_in_alert_sound(sound, output);
 		},
-		[&output_stream](const lang::custom_alert_sound& sound)
+		[&output](const lang::custom_alert_sound& sound)
 		{
-			output_custom_alert_sound(sound, output_stream);
+			output_custom_alert_sound(sound, output);
 		}
 	}, as.sound);
 }
 
 void output_disabled_drop_sound(
 	bool is_disabled,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!is_disabled)
 		return;
 
-	output_stream << '\t' << lang::generation::disable_drop_sound << '\n';
+	output << '\t' << lang::generation::disable_drop_sound << '\n';
 }
 
-void output_suit(lang::suit s, std::ostream& output_stream)
+void output_suit(lang::suit s, utility::string_builder& output)
 {
 	switch (s)
 	{
 		case lang::suit::red:
-			output_stream << lang::generation::red;
+			output << lang::generation::red;
 			break;
 		case lang::suit::green:
-			output_stream << lang::generation::green;
+			output << lang::generation::green;
 			break;
 		case lang::suit::blue:
-			output_stream << lang::generation::blue;
+			output << lang::generation::blue;
 			break;
 		case lang::suit::white:
-			output_stream << lang::generation::white;
+			output << lang::generation::white;
 			break;
 		case lang::suit::brown:
-			output_stream << lang::generation::brown;
+			output << lang::generation::brown;
 			break;
 		case lang::suit::yellow:
-			output_stream << lang::generation::yellow;
+			output << lang::generation::yellow;
 			break;
 		default:
 			break;
 	}
 }
 
-void output_shape(lang::shape s, std::ostream& output_stream)
+void output_shape(lang::shape s, utility::string_builder& output)
 {
 	switch (s)
 	{
 		case lang::shape::circle:
-			output_stream << lang::generation::circle;
+			output << lang::generation::circle;
 			break;
 		case lang::shape::diamond:
-			output_stream << lang::generation::diamond;
+			output << lang::generation::diamond;
 			break;
 		case lang::shape::hexagon:
-			output_stream << lang::generation::hexagon;
+			output << lang::generation::hexagon;
 			break;
 		case lang::shape::square:
-			output_stream << lang::generation::square;
+			output << lang::generation::square;
 			break;
 		case lang::shape::star:
-			output_stream << lang::generation::star;
+			output << lang::generation::star;
 			break;
 		case lang::shape::triangle:
-			output_stream << lang::generation::triangle;
+			output << lang::generation::triangle;
 			break;
 		default:
 			break;
@@ -148,34 +178,34 @@ void output_shape(lang::shape s, std::ostream& output_stream)
 
 void output_minimap_icon(
 	std::optional<lang::minimap_icon> minimap_icon,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!minimap_icon.has_value())
 		return;
 
 	const lang::minimap_icon& mi = *minimap_icon;
-	output_stream << '\t' << lang::generation::minimap_icon << ' ' << mi.size.value << ' ';
+	output << '\t' << lang::generation::minimap_icon << ' ' << mi.size.value << ' ';
 
-	output_suit(mi.color, output_stream);
-	output_stream << ' ';
-	output_shape(mi.shape, output_stream);
-	output_stream << '\n';
+	output_suit(mi.color, output);
+	output << ' ';
+	output_shape(mi.shape, output);
+	output << '\n';
 }
 
 void output_beam_effect(
 	std::optional<lang::beam_effect> beam_effect,
-	std::ostream& output_stream)
+	utility::string_builder& output)
 {
 	if (!beam_effect.has_value())
 		return;
 
 	const lang::beam_effect& be = *beam_effect;
-	output_stream << '\t' << lang::generation::play_effect << ' ';
-	output_suit(be.color, output_stream);
+	output << '\t' << lang::generation::play_effect << ' ';
+	output_suit(be.color, output);
 	if (be.is_temporary)
-		output_stream << ' ' << lang::generation::temp;
+		output << ' ' << lang::generation::temp;
 
-	output_stream << '\n';
+	output << '\n';
 }
 
 }
@@ -183,21 +213,21 @@ void output_beam_effect(
 namespace fs::lang
 {
 
-void action_set::generate(std::ostream& output_stream) const
+void action_set::generate(utility::string_builder& output) const
 {
 	namespace lg = lang::generation;
-	output_color_action(border_color,     lg::set_border_color,     output_stream);
-	output_color_action(text_color,       lg::set_text_color,       output_stream);
-	output_color_action(background_color, lg::set_background_color, output_stream);
-
-	output_font_size(font_size, output_stream);
-	output_alert_sound(alert_sound, output_stream);
-	output_disabled_drop_sound(disabled_drop_sound, output_stream);
-	output_minimap_icon(minimap_icon, output_stream);
-	output_beam_effect(beam_effect, output_stream);
+	output_color_action(border_color,     lg::set_border_color,     output);
+	output_color_action(text_color,       lg::set_text_color,       output);
+	output_color_action(background_color, lg::set_background_color, output);
+
+	output_font_size(font_size, output);
+	output_alert_sound(alert_sound, output);
+	output_disabled_drop_sound(disabled_drop_sound, output);
+	output_minimap_icon(minimap_icon, output);
+	output_beam_effect(beam_effect, output);
 }
 
-void action_set::override_with(action_set&& other)
+void action_set::override_with(const action_set& other)
 {
 	if (other.border_color)
 		override_border_color(*other.border_color);
@@ -212,7 +242,7 @@ void action_set::override_with(action_set&& other)
 		override_font_size(*other.font_size);
 
 	if (other.alert_sound)
-		override_alert_sound(*std::move(other.alert_sound));
+		override_alert_sound(*other.alert_sound);
 
 	disabled_drop_sound = other.disabled_drop_sound;
 
@@ -240,4 +270,30 @@ bool operator!=(const action_set& lhs, const action_set& rhs)
 	return !(lhs == rhs);
 }
 
+std::size_t hash_value(const action_set& actions) noexcept
+{
+	std::size_t seed = 0;
+	hash_combine(seed, actions.border_color);
+	hash_combine(seed, actions.text_color);
+	hash_combine(seed, actions.background_color);
+	boost::hash_combine(seed, actions.font_size.has_value() ? (*actions.font_size).value : -1);
+	hash_combine(seed, actions.alert_sound);
+	boost::hash_combine(seed, actions.disabled_drop_sound);
+
+	boost::hash_combine(seed, actions.minimap_icon.has_value());
+	if (actions.minimap_icon) {
+		boost::hash_combine(seed, (*actions.minimap_icon).size.value);
+		boost::hash_combine(seed, static_cast<int>((*actions.minimap_icon).color));
+		boost::hash_combine(seed, static_cast<int>((*actions.minimap_icon).shape));
+	}
+
+	boost::hash_combine(seed, actions.beam_effect.has_value());
+	if (actions.beam_effect) {
+		boost::hash_combine(seed, static_cast<int>((*actions.beam_effect).color));
+		boost::hash_combine(seed, (*actions.beam_effect).is_temporary);
+	}
+
+	return seed;
+}
+
 }
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <fs/lang/primitive_types.hpp>
+#include <fs/utility/string_builder.hpp>
 
+#include <cstddef>
 #include <utility>
-#include <iosfwd>
 
 namespace fs::lang
 {
@@ -50,9 +51,9 @@ struct action_set
 		beam_effect = new_beam_effect;
 	}
 
-	void override_with(action_set&& other);
+	void override_with(const action_set& other);
 
-	void generate(std::ostream& output_stream) const;
+	void generate(utility::string_builder& output) const;
 
 	std::optional<color> border_color;
 	std::optional<color> text_color;
@@ -67,4 +68,7 @@ struct action_set
 bool operator==(const action_set& lhs, const action_set& rhs);
 bool operator!=(const action_set& lhs, const action_set& rhs);
 
+// consistent with operator==
+std::size_t hash_value(const action_set& actions) noexcept;
+
 }
@@ -2,6 +2,7 @@
 
 #include <fs/lang/object.hpp>
 #include <fs/lang/position_tag.hpp>
+#include <fs/utility/string_builder.hpp>
 
 #include <memory>
 #include <optional>
@@ -120,7 +121,7 @@ struct influences_condition
 
 struct condition_set
 {
-	void generate(std::ostream& output_stream) const;
+	void generate(utility::string_builder& output) const;
 
 	/**
 	 * @brief determines whether given condition set is valid
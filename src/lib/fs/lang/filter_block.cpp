@@ -1,24 +1,23 @@
 #include <fs/lang/filter_block.hpp>
 #include <fs/lang/generation.hpp>
-#include <ostream>
 
 namespace fs::lang
 {
 
-void filter_block::generate(std::ostream& output_stream) const
+void filter_block::generate(utility::string_builder& output) const
 {
-	if (!conditions.is_valid())
+	if (!conditions->is_valid())
 		return;
 
 	if (show)
-		output_stream << generation::show;
+		output << generation::show;
 	else
-		output_stream << generation::hide;
-	output_stream << '\n';
+		output << generation::hide;
+	output << '\n';
 
-	conditions.generate(output_stream);
-	actions.generate(output_stream);
-	output_stream << '\n';
+	conditions->generate(output);
+	actions->generate(output);
+	output << '\n';
 }
 
 }
@@ -1,18 +1,23 @@
 #pragma once
 #include <fs/lang/condition_set.hpp>
 #include <fs/lang/action_set.hpp>
-#include <iosfwd>
+#include <fs/lang/position_tag.hpp>
+#include <fs/utility/copy_on_write.hpp>
+#include <fs/utility/string_builder.hpp>
 
 namespace fs::lang
 {
 
 struct filter_block
 {
-	void generate(std::ostream& output_stream) const;
+	void generate(utility::string_builder& output) const;
 
 	bool show;
-	condition_set conditions;
-	action_set actions;
+	// blocks emitted from the same scope share their sets
+	utility::copy_on_write<condition_set> conditions;
+	utility::copy_on_write<action_set> actions;
+	// Show/Hide statement which emitted the block
+	position_tag origin;
 };
 
 }
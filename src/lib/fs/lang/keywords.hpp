@@ -73,7 +73,7 @@ constexpr auto warlord     = generation::warlord;
 
 // ---- definitions ----
 
-// (nothing)
+constexpr auto import_ = "Import";
 
 // ---- rules ----
 
@@ -114,5 +114,6 @@ constexpr auto set_alert_sound            = "SetAlertSound";
 constexpr auto play_default_drop_sound    = "PlayDefaultDropSound";
 constexpr auto set_minimap_icon           = "SetMinimapIcon";
 constexpr auto set_beam                   = "SetBeam";
+constexpr auto set                        = "Set";
 
 }
@@ -3,6 +3,7 @@
 #include <fs/utility/type_traits.hpp>
 
 #include <type_traits>
+#include <utility>
 
 namespace fs::lang
 {
@@ -21,6 +22,20 @@ object_type type_of_object(const object_variant& object) noexcept
 		}, object);
 }
 
+// array elements are shared (immutable) so relocated arrays have to be rebuilt
+void set_origins(object& obj, const position_tag& origin)
+{
+	obj.value_origin = origin;
+
+	if (const auto* const array = std::get_if<array_object>(&obj.value)) {
+		array_object::container_type elements = array->elements();
+		for (object& element : elements)
+			element.value_origin = origin;
+
+		obj.value = array_object(std::move(elements));
+	}
+}
+
 // this could be in the header but there is no need for it to be parsed multiple times
 static_assert(
 	object_type::_size() == traits::variant_size_v<object_variant>,
@@ -2,19 +2,60 @@
 
 #include <fs/utility/type_traits.hpp>
 #include <fs/utility/better_enum.hpp>
+#include <fs/utility/immutable.hpp>
 #include <fs/lang/position_tag.hpp>
 #include <fs/lang/primitive_types.hpp>
 #include <fs/lang/action_set.hpp>
 
+#include <cassert>
+#include <initializer_list>
 #include <vector>
 #include <variant>
 
 namespace fs::lang
 {
 
-class object;
+struct object;
 
-using array_object = std::vector<object>;
+/*
+ * Objects are copied every time a name is referenced so big values
+ * (arrays and compound actions) are shared - copies of them only
+ * copy a handle. Origins of the whole value are stored in the object
+ * outside the shared value so the same array can be referenced from
+ * different places.
+ */
+class array_object
+{
+public:
+	using container_type = std::vector<object>;
+	using const_iterator = container_type::const_iterator;
+
+	array_object();
+	array_object(container_type elements);
+	array_object(std::initializer_list<object> elements);
+
+	const_iterator begin() const noexcept;
+	const_iterator end() const noexcept;
+	std::size_t size() const noexcept;
+	bool empty() const noexcept;
+	const object& operator[](std::size_t n) const noexcept;
+	const object& front() const noexcept;
+
+	const container_type& elements() const noexcept { return *_elements; }
+
+	bool shares_elements_with(const array_object& other) const noexcept
+	{
+		return _elements.shares_value_with(other._elements);
+	}
+
+private:
+	utility::immutable<container_type> _elements;
+};
+
+bool operator==(const array_object& lhs, const array_object& rhs) noexcept;
+inline bool operator!=(const array_object& lhs, const array_object& rhs) noexcept { return !(lhs == rhs); }
+
+using action_set_object = utility::immutable<action_set>;
 
 using object_variant = std::variant<
 	// primitive types
@@ -42,7 +83,7 @@ using object_variant = std::variant<
 	// array
 	array_object,
 	// compound action
-	action_set
+	action_set_object
 >;
 
 BETTER_ENUM(object_type, int,
@@ -88,7 +129,7 @@ struct object
 
 	bool is_compound_action() const noexcept
 	{
-		return std::holds_alternative<action_set>(value);
+		return std::holds_alternative<action_set_object>(value);
 	}
 
 	bool is_primitive() const noexcept
@@ -105,7 +146,7 @@ struct object
 	array_object promote_to_array() const
 	{
 		assert(!is_array());
-		return array_object(1, *this);
+		return array_object{*this};
 	}
 
 	object_variant value;
@@ -120,6 +161,43 @@ inline bool operator==(const object& lhs, const object& rhs) noexcept
 }
 inline bool operator!=(const object& lhs, const object& rhs) noexcept { return !(lhs == rhs); }
 
+// sets origin of the object and its elements, eg when it is moved to a different source file
+void set_origins(object& obj, const position_tag& origin);
+
+inline array_object::array_object() = default;
+
+inline array_object::array_object(container_type elements)
+: _elements(std::move(elements))
+{
+}
+
+inline array_object::array_object(std::initializer_list<object> elements)
+: _elements(container_type(elements))
+{
+}
+
+inline array_object::const_iterator array_object::begin() const noexcept { return elements().begin(); }
+inline array_object::const_iterator array_object::end() const noexcept { return elements().end(); }
+inline std::size_t array_object::size() const noexcept { return elements().size(); }
+inline bool array_object::empty() const noexcept { return elements().empty(); }
+
+inline const object& array_object::operator[](std::size_t n) const noexcept
+{
+	assert(n < size());
+	return elements()[n];
+}
+
+inline const object& array_object::front() const noexcept
+{
+	assert(!empty());
+	return elements().front();
+}
+
+inline bool operator==(const array_object& lhs, const array_object& rhs) noexcept
+{
+	return lhs.shares_elements_with(rhs) || lhs.elements() == rhs.elements();
+}
+
 
 template <typename T> [[nodiscard]] constexpr
 object_type type_to_enum_impl() noexcept
@@ -173,7 +251,7 @@ object_type type_to_enum_impl<alert_sound>() noexcept { return object_type::aler
 template <> constexpr
 object_type type_to_enum_impl<array_object>() noexcept { return object_type::array; }
 template <> constexpr
-object_type type_to_enum_impl<action_set>() noexcept { return object_type::action_set; }
+object_type type_to_enum_impl<action_set_object>() noexcept { return object_type::action_set; }
 
 template <typename T> [[nodiscard]] constexpr
 object_type type_to_enum() noexcept
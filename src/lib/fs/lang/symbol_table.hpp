@@ -3,8 +3,11 @@
 #include <fs/lang/object.hpp>
 #include <fs/lang/position_tag.hpp>
 
+#include <cassert>
 #include <unordered_map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace fs::lang
 {
@@ -15,6 +18,79 @@ struct named_object
 	position_tag name_origin;
 };
 
-using symbol_table = std::unordered_map<std::string, named_object>;
+// dense index of a symbol in symbol_table, assigned in order of definition
+using symbol_id = int;
+constexpr symbol_id invalid_symbol_id = -1;
+
+/*
+ * Names are used only to resolve identifiers - after that, objects are
+ * accessed by their ID which is a plain array index. Iteration order
+ * is the order of definitions.
+ */
+class symbol_table
+{
+public:
+	using value_type = std::pair<std::string, named_object>;
+	using container_type = std::vector<value_type>;
+	// there is no mutable access to names - it would allow to break their index
+	using const_iterator = container_type::const_iterator;
+
+	[[nodiscard]] symbol_id id_of(const std::string& name) const noexcept
+	{
+		const auto it = ids.find(name);
+		return it == ids.end() ? invalid_symbol_id : it->second;
+	}
+
+	[[nodiscard]] const value_type& operator[](symbol_id id) const noexcept
+	{
+		assert(0 <= id && id < static_cast<symbol_id>(entries.size()));
+		return entries[id];
+	}
+
+	[[nodiscard]] const_iterator find(const std::string& name) const noexcept
+	{
+		const symbol_id id = id_of(name);
+		return id == invalid_symbol_id ? end() : begin() + id;
+	}
+
+	[[nodiscard]] std::size_t count(const std::string& name) const noexcept
+	{
+		return ids.count(name);
+	}
+
+	// throws std::out_of_range if there is no such name
+	[[nodiscard]] const named_object& at(const std::string& name) const
+	{
+		return entries[ids.at(name)].second;
+	}
+
+	// new symbol gets the next ID; does nothing if the name already exists
+	std::pair<const_iterator, bool> emplace(std::string name, named_object obj)
+	{
+		const auto [it, inserted] = ids.emplace(name, static_cast<symbol_id>(entries.size()));
+		if (!inserted)
+			return {begin() + it->second, false};
+
+		entries.emplace_back(std::move(name), std::move(obj));
+		return {end() - 1, true};
+	}
+
+	// objects can be replaced - this allows to assign IDs to names before their values are known
+	void assign_object(symbol_id id, object obj) noexcept
+	{
+		assert(0 <= id && id < static_cast<symbol_id>(entries.size()));
+		entries[id].second.object_instance = std::move(obj);
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept { return entries.size(); }
+	[[nodiscard]] bool empty() const noexcept { return entries.empty(); }
+
+	const_iterator begin() const noexcept { return entries.begin(); }
+	const_iterator end() const noexcept { return entries.end(); }
+
+private:
+	container_type entries;
+	std::unordered_map<std::string, symbol_id> ids;
+};
 
 }
@@ -4,6 +4,7 @@ namespace fs::log::strings
 {
 
 constexpr auto note = "note: ";
+constexpr auto warning = "warning: ";
 constexpr auto error = "error: ";
 
 constexpr auto internal_compiler_error = "internal compiler error: ";
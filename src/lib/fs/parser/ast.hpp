@@ -272,6 +272,19 @@ struct postfix_expression : x3::position_tagged
 
 // ---- definitions ----
 
+struct import_directive : x3::position_tagged
+{
+	import_directive& operator=(string_literal str)
+	{
+		path = std::move(str);
+		return *this;
+	}
+
+	const string_literal& get_value() const { return path; }
+
+	string_literal path;
+};
+
 struct constant_definition : x3::position_tagged
 {
 	identifier name;
@@ -426,6 +439,7 @@ struct statement : x3::variant<
 
 struct filter_structure : x3::position_tagged
 {
+	std::vector<import_directive> imports;
 	std::vector<definition> definitions;
 	std::vector<statement> statements;
 };
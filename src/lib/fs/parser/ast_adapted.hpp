@@ -89,4 +89,4 @@ BOOST_FUSION_ADAPT_STRUCT(
 
 BOOST_FUSION_ADAPT_STRUCT(
 	fs::parser::ast::filter_structure,
-	definitions, statements)
+	imports, definitions, statements)
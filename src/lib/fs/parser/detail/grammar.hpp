@@ -86,11 +86,7 @@ struct identifier_class                      : error_on_error, annotate_on_succe
 struct floating_point_literal_class          : error_on_error, annotate_on_success {};
 struct integer_literal_class                 : error_on_error, annotate_on_success {};
 struct string_literal_class                  : error_on_error, annotate_on_success {};
-struct boolean_literal_class                 : error_on_error, annotate_on_success {};
-struct rarity_literal_class                  : error_on_error, annotate_on_success {};
-struct shape_literal_class                   : error_on_error, annotate_on_success {};
-struct suit_literal_class                    : error_on_error, annotate_on_success {};
-struct influence_literal_class               : error_on_error, annotate_on_success {};
+struct keyword_literal_class                 : error_on_error, annotate_on_success {};
 struct none_literal_class                    : error_on_error, annotate_on_success {};
 
 // ---- expressions ----
@@ -108,6 +104,7 @@ struct value_expression_class                : error_on_error, annotate_on_succe
 
 // ---- definitions ----
 
+struct import_directive_class                : error_on_error, annotate_on_success {};
 struct constant_definition_class             : error_on_error, annotate_on_success {};
 struct definition_class                      : error_on_error, annotate_on_success {};
 
@@ -179,20 +176,9 @@ BOOST_SPIRIT_DECLARE(integer_literal_type)
 using string_literal_type = x3::rule<string_literal_class, ast::string_literal>;
 BOOST_SPIRIT_DECLARE(string_literal_type)
 
-using boolean_literal_type = x3::rule<boolean_literal_class, ast::boolean_literal>;
-BOOST_SPIRIT_DECLARE(boolean_literal_type)
-
-using rarity_literal_type = x3::rule<rarity_literal_class, ast::rarity_literal>;
-BOOST_SPIRIT_DECLARE(rarity_literal_type)
-
-using shape_literal_type = x3::rule<shape_literal_class, ast::shape_literal>;
-BOOST_SPIRIT_DECLARE(shape_literal_type)
-
-using suit_literal_type = x3::rule<suit_literal_class, ast::suit_literal>;
-BOOST_SPIRIT_DECLARE(suit_literal_type)
-
-using influence_literal_type = x3::rule<influence_literal_class, ast::influence_literal>;
-BOOST_SPIRIT_DECLARE(influence_literal_type)
+// boolean, rarity, shape, suit and influence literals - recognized in one keyword table lookup
+using keyword_literal_type = x3::rule<keyword_literal_class, ast::literal_expression>;
+BOOST_SPIRIT_DECLARE(keyword_literal_type)
 
 using none_literal_type = x3::rule<none_literal_class, ast::none_literal>;
 BOOST_SPIRIT_DECLARE(none_literal_type)
@@ -231,6 +217,9 @@ BOOST_SPIRIT_DECLARE(value_expression_type)
 
 // ---- definitions ----
 
+using import_directive_type = x3::rule<import_directive_class, ast::import_directive>;
+BOOST_SPIRIT_DECLARE(import_directive_type)
+
 using constant_definition_type = x3::rule<constant_definition_class, ast::constant_definition>;
 BOOST_SPIRIT_DECLARE(constant_definition_type)
 
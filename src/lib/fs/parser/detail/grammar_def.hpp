@@ -55,25 +55,9 @@ const string_literal_type string_literal = "string";
 const auto string_literal_def = x3::lexeme['"' > *(x3::char_ - (x3::lit('"') | '\n' | '\r')) > '"'];
 BOOST_SPIRIT_DEFINE(string_literal)
 
-const boolean_literal_type boolean_literal = "boolean literal";
-const auto boolean_literal_def = x3::lexeme[symbols::booleans >> not_alnum_or_underscore];
-BOOST_SPIRIT_DEFINE(boolean_literal)
-
-const rarity_literal_type rarity_literal = "rarity literal";
-const auto rarity_literal_def = x3::lexeme[symbols::rarities >> not_alnum_or_underscore];
-BOOST_SPIRIT_DEFINE(rarity_literal)
-
-const shape_literal_type shape_literal = "shape literal";
-const auto shape_literal_def = x3::lexeme[symbols::shapes >> not_alnum_or_underscore];
-BOOST_SPIRIT_DEFINE(shape_literal)
-
-const suit_literal_type suit_literal = "suit literal";
-const auto suit_literal_def = x3::lexeme[symbols::suits >> not_alnum_or_underscore];
-BOOST_SPIRIT_DEFINE(suit_literal)
-
-const influence_literal_type influence_literal = "influence literal";
-const auto influence_literal_def = x3::lexeme[symbols::influences >> not_alnum_or_underscore];
-BOOST_SPIRIT_DEFINE(influence_literal)
+const keyword_literal_type keyword_literal = "keyword literal";
+const auto keyword_literal_def = symbols::keyword_literals;
+BOOST_SPIRIT_DEFINE(keyword_literal)
 
 const none_literal_type none_literal = "none literal";
 const auto none_literal_def = x3::lexeme['_' >> not_alnum_or_underscore] > x3::attr(ast::none_literal());
@@ -97,11 +81,7 @@ const auto literal_expression_def =
 	  floating_point_literal
 	| integer_literal
 	| string_literal
-	| boolean_literal
-	| rarity_literal
-	| shape_literal
-	| suit_literal
-	| influence_literal
+	| keyword_literal
 	| none_literal;
 BOOST_SPIRIT_DEFINE(literal_expression)
 
@@ -147,6 +127,10 @@ BOOST_SPIRIT_DEFINE(value_expression)
 
 // ---- definitions ----
 
+const import_directive_type import_directive = "import directive";
+const auto import_directive_def = symbols::import_keyword > string_literal;
+BOOST_SPIRIT_DEFINE(import_directive)
+
 const constant_definition_type constant_definition = "constant definiton";
 const auto constant_definition_def = identifier >> '=' > value_expression;
 BOOST_SPIRIT_DEFINE(constant_definition)
@@ -164,7 +148,7 @@ BOOST_SPIRIT_DEFINE(comparison_operator_expression)
 
 const comparison_condition_type comparison_condition = "comparison condition";
 const auto comparison_condition_def =
-	x3::lexeme[symbols::comparison_condition_properties >> not_alnum_or_underscore]
+	symbols::comparison_condition_properties
 	> comparison_operator_expression
 	> value_expression;
 BOOST_SPIRIT_DEFINE(comparison_condition)
@@ -175,17 +159,17 @@ BOOST_SPIRIT_DEFINE(exact_matching_policy_operator)
 
 const array_condition_type array_condition = "array condition";
 const auto array_condition_def =
-	x3::lexeme[symbols::array_condition_properties >> not_alnum_or_underscore]
+	symbols::array_condition_properties
 	> exact_matching_policy_operator
 	> value_expression;
 BOOST_SPIRIT_DEFINE(array_condition)
 
 const boolean_condition_type boolean_condition = "boolean condition";
-const auto boolean_condition_def = x3::lexeme[symbols::boolean_condition_properties >> not_alnum_or_underscore] > value_expression;
+const auto boolean_condition_def = symbols::boolean_condition_properties > value_expression;
 BOOST_SPIRIT_DEFINE(boolean_condition)
 
 const socket_group_condition_type socket_group_condition = "socket group condition";
-const auto socket_group_condition_def = x3::lexeme[lang::keywords::socket_group >> not_alnum_or_underscore] > value_expression;
+const auto socket_group_condition_def = symbols::socket_group_keyword > value_expression;
 BOOST_SPIRIT_DEFINE(socket_group_condition)
 
 const condition_type condition = "condition";
@@ -197,11 +181,11 @@ const auto condition_def =
 BOOST_SPIRIT_DEFINE(condition)
 
 const unary_action_type unary_action = "unary action";
-const auto unary_action_def = x3::lexeme[symbols::unary_action_types >> not_alnum_or_underscore] > value_expression;
+const auto unary_action_def = symbols::unary_action_types > value_expression;
 BOOST_SPIRIT_DEFINE(unary_action)
 
 const compound_action_type compound_action = "compound action";
-const auto compound_action_def = x3::lexeme["Set" >> not_alnum_or_underscore] > value_expression;
+const auto compound_action_def = symbols::compound_action_keyword > value_expression;
 BOOST_SPIRIT_DEFINE(compound_action)
 
 const auto action_def = compound_action | unary_action;
@@ -210,7 +194,7 @@ BOOST_SPIRIT_DEFINE(action)
 // ---- filter structure ----
 
 const visibility_statement_type visibility_statement = "visibility statement";
-const auto visibility_statement_def = x3::lexeme[symbols::visibility_literals >> not_alnum_or_underscore];
+const auto visibility_statement_def = symbols::visibility_literals;
 BOOST_SPIRIT_DEFINE(visibility_statement)
 
 // moved here due to circular dependency
@@ -224,7 +208,7 @@ const auto rule_block_def = *condition >> x3::lit('{') > *statement > x3::lit('}
 BOOST_SPIRIT_DEFINE(rule_block)
 
 const filter_structure_type filter_structure = "filter structure";
-const auto filter_structure_def = *definition > *statement;
+const auto filter_structure_def = *import_directive > *definition > *statement;
 BOOST_SPIRIT_DEFINE(filter_structure)
 
 const grammar_type grammar = "code";
@@ -0,0 +1,241 @@
+/**
+ * @file compile-time keyword table
+ *
+ * @details All identifier-shaped keywords of the language are listed once here
+ * together with their kind and payload (enum value). A perfect hash is computed
+ * at compile time over this list so that any scanned identifier-shaped token can
+ * be classified with a single hash computation and a single string comparison.
+ */
+#pragma once
+
+#include <fs/lang/keywords.hpp>
+#include <fs/lang/primitive_types.hpp>
+#include <fs/lang/condition_properties.hpp>
+#include <fs/lang/action_properties.hpp>
+
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace fs::parser::detail
+{
+
+enum class keyword_kind
+{
+	boolean,
+	rarity,
+	shape,
+	suit,
+	influence,
+	import_directive,
+	comparison_condition_property,
+	array_condition_property,
+	boolean_condition_property,
+	socket_group_condition,
+	unary_action_type,
+	compound_action,
+	visibility
+};
+
+struct keyword_info
+{
+	std::string_view name;
+	keyword_kind kind;
+	int payload; // value of the enum (or bool) that the keyword denotes
+};
+
+template <typename Enum> constexpr
+keyword_info make_keyword(const char* name, keyword_kind kind, Enum value) noexcept
+{
+	return keyword_info{name, kind, static_cast<int>(value)};
+}
+
+namespace kw = lang::keywords;
+using kk = keyword_kind;
+
+constexpr std::array keyword_list = {
+	make_keyword(kw::true_,  kk::boolean, true),
+	make_keyword(kw::false_, kk::boolean, false),
+
+	make_keyword(kw::normal, kk::rarity, lang::rarity::normal),
+	make_keyword(kw::magic,  kk::rarity, lang::rarity::magic),
+	make_keyword(kw::rare,   kk::rarity, lang::rarity::rare),
+	make_keyword(kw::unique, kk::rarity, lang::rarity::unique),
+
+	make_keyword(kw::circle,   kk::shape, lang::shape::circle),
+	make_keyword(kw::diamond,  kk::shape, lang::shape::diamond),
+	make_keyword(kw::hexagon,  kk::shape, lang::shape::hexagon),
+	make_keyword(kw::square,   kk::shape, lang::shape::square),
+	make_keyword(kw::star,     kk::shape, lang::shape::star),
+	make_keyword(kw::triangle, kk::shape, lang::shape::triangle),
+
+	make_keyword(kw::red,    kk::suit, lang::suit::red),
+	make_keyword(kw::green,  kk::suit, lang::suit::green),
+	make_keyword(kw::blue,   kk::suit, lang::suit::blue),
+	make_keyword(kw::white,  kk::suit, lang::suit::white),
+	make_keyword(kw::brown,  kk::suit, lang::suit::brown),
+	make_keyword(kw::yellow, kk::suit, lang::suit::yellow),
+
+	make_keyword(kw::shaper,   kk::influence, lang::influence::shaper),
+	make_keyword(kw::elder,    kk::influence, lang::influence::elder),
+	make_keyword(kw::crusader, kk::influence, lang::influence::crusader),
+	make_keyword(kw::redeemer, kk::influence, lang::influence::redeemer),
+	make_keyword(kw::hunter,   kk::influence, lang::influence::hunter),
+	make_keyword(kw::warlord,  kk::influence, lang::influence::warlord),
+
+	make_keyword(kw::import_, kk::import_directive, 0),
+
+	make_keyword(kw::item_level,     kk::comparison_condition_property, lang::comparison_condition_property::item_level),
+	make_keyword(kw::drop_level,     kk::comparison_condition_property, lang::comparison_condition_property::drop_level),
+	make_keyword(kw::quality,        kk::comparison_condition_property, lang::comparison_condition_property::quality),
+	make_keyword(kw::rarity,         kk::comparison_condition_property, lang::comparison_condition_property::rarity),
+	make_keyword(kw::sockets,        kk::comparison_condition_property, lang::comparison_condition_property::sockets),
+	make_keyword(kw::linked_sockets, kk::comparison_condition_property, lang::comparison_condition_property::links),
+	make_keyword(kw::height,         kk::comparison_condition_property, lang::comparison_condition_property::height),
+	make_keyword(kw::width,          kk::comparison_condition_property, lang::comparison_condition_property::width),
+	make_keyword(kw::stack_size,     kk::comparison_condition_property, lang::comparison_condition_property::stack_size),
+	make_keyword(kw::gem_level,      kk::comparison_condition_property, lang::comparison_condition_property::gem_level),
+	make_keyword(kw::map_tier,       kk::comparison_condition_property, lang::comparison_condition_property::map_tier),
+
+	make_keyword(kw::class_,           kk::array_condition_property, lang::array_condition_property::class_),
+	make_keyword(kw::base_type,        kk::array_condition_property, lang::array_condition_property::base_type),
+	make_keyword(kw::has_explicit_mod, kk::array_condition_property, lang::array_condition_property::has_explicit_mod),
+	make_keyword(kw::has_enchantment,  kk::array_condition_property, lang::array_condition_property::has_enchantment),
+	make_keyword(kw::prophecy,         kk::array_condition_property, lang::array_condition_property::prophecy),
+	make_keyword(kw::has_influence,    kk::array_condition_property, lang::array_condition_property::has_influence),
+
+	make_keyword(kw::identified,       kk::boolean_condition_property, lang::boolean_condition_property::identified),
+	make_keyword(kw::corrupted,        kk::boolean_condition_property, lang::boolean_condition_property::corrupted),
+	make_keyword(kw::elder_item,       kk::boolean_condition_property, lang::boolean_condition_property::elder_item),
+	make_keyword(kw::shaper_item,      kk::boolean_condition_property, lang::boolean_condition_property::shaper_item),
+	make_keyword(kw::fractured_item,   kk::boolean_condition_property, lang::boolean_condition_property::fractured_item),
+	make_keyword(kw::synthesised_item, kk::boolean_condition_property, lang::boolean_condition_property::synthesised_item),
+	make_keyword(kw::any_enchantment,  kk::boolean_condition_property, lang::boolean_condition_property::any_enchantment),
+	make_keyword(kw::shaped_map,       kk::boolean_condition_property, lang::boolean_condition_property::shaped_map),
+	make_keyword(kw::elder_map,        kk::boolean_condition_property, lang::boolean_condition_property::elder_map),
+	make_keyword(kw::blighted_map,     kk::boolean_condition_property, lang::boolean_condition_property::blighted_map),
+
+	make_keyword(kw::socket_group, kk::socket_group_condition, 0),
+
+	make_keyword(kw::set_border_color,        kk::unary_action_type, lang::unary_action_type::set_border_color),
+	make_keyword(kw::set_text_color,          kk::unary_action_type, lang::unary_action_type::set_text_color),
+	make_keyword(kw::set_background_color,    kk::unary_action_type, lang::unary_action_type::set_background_color),
+	make_keyword(kw::set_font_size,           kk::unary_action_type, lang::unary_action_type::set_font_size),
+	make_keyword(kw::set_alert_sound,         kk::unary_action_type, lang::unary_action_type::set_alert_sound),
+	make_keyword(kw::play_default_drop_sound, kk::unary_action_type, lang::unary_action_type::play_default_drop_sound),
+	make_keyword(kw::set_minimap_icon,        kk::unary_action_type, lang::unary_action_type::set_minimap_icon),
+	make_keyword(kw::set_beam,                kk::unary_action_type, lang::unary_action_type::set_beam),
+
+	make_keyword(kw::set, kk::compound_action, 0),
+
+	make_keyword(kw::show, kk::visibility, true),
+	make_keyword(kw::hide, kk::visibility, false)
+};
+
+// ---- perfect hash ----
+
+// FNV-1a, the seed is mixed into the offset basis
+constexpr std::uint32_t keyword_hash(std::string_view str, std::uint32_t seed) noexcept
+{
+	std::uint32_t hash = 2166136261u ^ seed;
+	for (char c : str) {
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// power of 2, ~8 times the number of keywords so that a collision-free seed is found quickly
+constexpr std::size_t keyword_table_size = 512;
+constexpr std::uint8_t empty_keyword_slot = std::numeric_limits<std::uint8_t>::max();
+static_assert(keyword_list.size() < empty_keyword_slot, "slot type is too small to index all keywords");
+
+constexpr std::size_t keyword_slot_of(std::string_view str, std::uint32_t seed) noexcept
+{
+	return keyword_hash(str, seed) % keyword_table_size;
+}
+
+constexpr bool is_perfect_seed(std::uint32_t seed) noexcept
+{
+	std::array<bool, keyword_table_size> taken{};
+	for (const keyword_info& info : keyword_list) {
+		bool& slot = taken[keyword_slot_of(info.name, seed)];
+		if (slot)
+			return false; // note: duplicated keywords also end here
+
+		slot = true;
+	}
+
+	return true;
+}
+
+constexpr std::uint32_t find_perfect_seed() noexcept
+{
+	for (std::uint32_t seed = 0; seed < 10000; ++seed)
+		if (is_perfect_seed(seed))
+			return seed;
+
+	return std::numeric_limits<std::uint32_t>::max();
+}
+
+constexpr std::uint32_t keyword_seed = find_perfect_seed();
+static_assert(keyword_seed != std::numeric_limits<std::uint32_t>::max(),
+	"no perfect hash seed found - duplicated keyword or table too small");
+
+constexpr std::array<std::uint8_t, keyword_table_size> make_keyword_slots() noexcept
+{
+	std::array<std::uint8_t, keyword_table_size> slots{};
+	for (std::uint8_t& slot : slots)
+		slot = empty_keyword_slot;
+
+	for (std::size_t i = 0; i < keyword_list.size(); ++i)
+		slots[keyword_slot_of(keyword_list[i].name, keyword_seed)] = static_cast<std::uint8_t>(i);
+
+	return slots;
+}
+
+constexpr std::array<std::uint8_t, keyword_table_size> keyword_slots = make_keyword_slots();
+
+/**
+ * @brief classify an identifier-shaped token
+ * @return keyword information or null if the token is not a keyword
+ */
+[[nodiscard]] constexpr
+const keyword_info* find_keyword(std::string_view token) noexcept
+{
+	const std::uint8_t index = keyword_slots[keyword_slot_of(token, keyword_seed)];
+	if (index == empty_keyword_slot)
+		return nullptr;
+
+	const keyword_info& info = keyword_list[index];
+	if (info.name != token)
+		return nullptr;
+
+	return &info;
+}
+
+static_assert(find_keyword(kw::rare) != nullptr && find_keyword(kw::rare)->kind == keyword_kind::rarity);
+static_assert(find_keyword("Rar") == nullptr && find_keyword("Rare_") == nullptr);
+
+constexpr bool is_identifier_character(char c) noexcept
+{
+	return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_';
+}
+
+/**
+ * @brief scan the longest identifier-shaped token starting at @p first
+ * @return scanned token, empty if @p first does not point at an identifier character
+ */
+[[nodiscard]] constexpr
+std::string_view scan_identifier_token(const char* first, const char* last) noexcept
+{
+	const char* it = first;
+	while (it != last && is_identifier_character(*it))
+		++it;
+
+	return std::string_view(first, it - first);
+}
+
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <boost/spirit/home/x3/support/ast/position_tagged.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace fs::parser::detail
+{
+
+namespace x3 = boost::spirit::x3;
+
+/**
+ * @class positions of AST nodes in the parsed text
+ *
+ * @details The same interface as x3::position_cache, but positions are held
+ * as offsets together with the number of text edits that had been made before
+ * they were recorded. An edit (see parser::parse_incremental) only moves the
+ * text pointer and records a shift - positions after the edited region are
+ * adjusted when they are looked up. This way an edit costs time proportional
+ * to the edited region, not to the size of the whole text.
+ *
+ * Shifts are applied to all positions at once (and then forgotten) only after
+ * many edits, so that lookups stay cheap.
+ *
+ * Positions of nodes replaced by an edit are never looked up again, but they
+ * stay in the cache. Once the cache has grown to twice its size from the last
+ * rebuild (or from the first edit), the caller should rebuild it (see
+ * keep_only) - this bounds dead positions by the number of live ones while
+ * the cost of rebuilding is spread over the edits that made it necessary.
+ */
+class position_cache
+{
+public:
+	using iterator_type = const char*;
+
+	position_cache(iterator_type first, iterator_type last)
+	: first_(first), last_(last)
+	{
+	}
+
+	boost::iterator_range<iterator_type> position_of(const x3::position_tagged& ast) const
+	{
+		return boost::iterator_range<iterator_type>(position_at(ast.id_first), position_at(ast.id_last));
+	}
+
+	template <typename AST>
+	void annotate(AST& ast, iterator_type first, iterator_type last)
+	{
+		if constexpr (std::is_base_of_v<x3::position_tagged, AST>) {
+			x3::position_tagged& tagged = ast;
+			tagged.id_first = add_position(first);
+			tagged.id_last = add_position(last);
+		}
+	}
+
+	// throws if there is no position with such ID
+	iterator_type position_at(int id) const
+	{
+		const position& pos = positions.at(id);
+		std::size_t offset = pos.offset;
+		for (std::size_t i = pos.generation; i < shifts.size(); ++i)
+			offset = shifts[i].apply(offset);
+
+		return first_ + offset;
+	}
+
+	/**
+	 * @brief move to a new text, which differs from the current one only in a region
+	 * @details Text in [region_first, region_last) has been replaced by text which is
+	 * @p size_difference characters longer. Positions before the region stay, positions
+	 * after it are shifted. Positions inside the region must not be used anymore.
+	 */
+	void replace_text(iterator_type first, iterator_type last, std::size_t region_first, std::size_t region_last, std::ptrdiff_t size_difference)
+	{
+		first_ = first;
+		last_ = last;
+		if (rebuilt_size == 0)
+			rebuilt_size = positions.size();
+
+		shifts.push_back(shift{region_first, region_last, size_difference});
+
+		if (shifts.size() >= max_pending_shifts)
+			apply_shifts();
+	}
+
+	bool should_rebuild() const noexcept
+	{
+		return rebuilt_size != 0 && positions.size() > 2 * rebuilt_size;
+	}
+
+	/**
+	 * @brief drop all positions except ones of the given nodes
+	 * @details @p visit_nodes is called with a function that should be called
+	 * with every (x3::position_tagged&) node which is still in use. Nodes get
+	 * new IDs; positions of any other nodes are lost.
+	 */
+	template <typename VisitNodes>
+	void keep_only(VisitNodes visit_nodes)
+	{
+		std::vector<position> kept;
+		const auto keep = [&](int id) {
+			kept.push_back(position{static_cast<std::size_t>(position_at(id) - first_), 0});
+			return static_cast<int>(kept.size() - 1);
+		};
+		const auto keep_node = [&](x3::position_tagged& node) {
+			// not all nodes are annotated
+			if (node.id_first < 0)
+				return;
+
+			node.id_first = keep(node.id_first);
+			node.id_last = keep(node.id_last);
+		};
+		visit_nodes(keep_node);
+
+		positions = std::move(kept);
+		shifts.clear();
+		rebuilt_size = positions.size();
+	}
+
+	std::size_t size() const noexcept { return positions.size(); }
+
+	iterator_type first() const { return first_; }
+	iterator_type last() const { return last_; }
+
+private:
+	static constexpr std::size_t max_pending_shifts = 64;
+
+	struct position
+	{
+		std::size_t offset;
+		// number of shifts that had been recorded before this position
+		std::size_t generation;
+	};
+
+	struct shift
+	{
+		std::size_t apply(std::size_t offset) const noexcept
+		{
+			if (offset <= region_first)
+				return offset;
+			else if (offset >= region_last)
+				return offset + size_difference;
+			else
+				return region_first;
+		}
+
+		std::size_t region_first;
+		std::size_t region_last;
+		std::ptrdiff_t size_difference;
+	};
+
+	int add_position(iterator_type it)
+	{
+		positions.push_back(position{static_cast<std::size_t>(it - first_), shifts.size()});
+		return static_cast<int>(positions.size() - 1);
+	}
+
+	void apply_shifts()
+	{
+		for (position& pos : positions) {
+			for (std::size_t i = pos.generation; i < shifts.size(); ++i)
+				pos.offset = shifts[i].apply(pos.offset);
+
+			pos.generation = 0;
+		}
+
+		shifts.clear();
+	}
+
+	std::vector<position> positions;
+	std::vector<shift> shifts;
+	// number of positions after the last rebuild, 0 if there were no edits yet
+	std::size_t rebuilt_size = 0;
+	iterator_type first_;
+	iterator_type last_;
+};
+
+}
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <fs/parser/ast.hpp>
+#include <fs/parser/detail/keyword_table.hpp>
 #include <fs/lang/condition_properties.hpp>
 #include <fs/lang/primitive_types.hpp>
 #include <fs/lang/keywords.hpp>
 
+#include <boost/spirit/home/x3/core/parser.hpp>
+#include <boost/spirit/home/x3/core/skip_over.hpp>
 #include <boost/spirit/home/x3/string/symbols.hpp>
+#include <boost/spirit/home/x3/support/traits/move_to.hpp>
+
+#include <string>
+#include <type_traits>
 
 namespace fs::parser::detail::symbols
 {
@@ -12,91 +20,143 @@ namespace fs::parser::detail::symbols
 // symbols that denote filter's language constants
 namespace x3 = boost::spirit::x3;
 
-// ---- whitespace ----
-
-// (nothing to symbolize)
+/*
+ * Keywords are not matched with x3::symbols (a ternary search tree per keyword group
+ * followed by a not_alnum_or_underscore check). Instead, the whole identifier-shaped
+ * token is scanned once and classified through the compile-time perfect hash from
+ * keyword_table.hpp. Scanning the whole token also implies that the keyword is not
+ * a prefix of a longer identifier, hence no lexeme[] or not_alnum_or_underscore is needed.
+ */
+template <typename Iterator>
+[[nodiscard]] const keyword_info*
+scan_keyword(Iterator& it, const Iterator& last) noexcept
+{
+	static_assert(std::is_same_v<Iterator, const char*>, "keyword scanning requires contiguous input");
 
-// ---- fundamental tokens ----
+	const std::string_view token = scan_identifier_token(it, last);
+	if (token.empty())
+		return nullptr;
 
-// (nothing to symbolize)
+	const keyword_info* info = find_keyword(token);
+	if (info != nullptr)
+		it += token.size();
 
-// ---- literal types ----
+	return info;
+}
 
-struct booleans_ : x3::symbols<bool>
+// parser of a single kind of keywords, synthesizes keyword's payload as Attribute
+template <typename Attribute>
+struct keyword_parser : x3::parser<keyword_parser<Attribute>>
 {
-	booleans_()
+	using attribute_type = Attribute;
+	static bool const has_attribute = !std::is_same_v<Attribute, x3::unused_type>;
+
+	constexpr keyword_parser(keyword_kind kind, const char* name)
+	: kind(kind), name(name) {}
+
+	template <typename Iterator, typename Context, typename RContext, typename Attr>
+	bool parse(
+		Iterator& first,
+		const Iterator& last,
+		const Context& context,
+		RContext& /* rcontext */,
+		Attr& attr) const
 	{
-		add
-			(lang::keywords::true_, true)
-			(lang::keywords::false_, false)
-		;
+		x3::skip_over(first, last, context);
+
+		Iterator it = first;
+		const keyword_info* info = scan_keyword(it, last);
+		if (info == nullptr || info->kind != kind)
+			return false;
+
+		if constexpr (has_attribute)
+			x3::traits::move_to(static_cast<Attribute>(info->payload), attr);
+
+		first = it;
+		return true;
 	}
 
+	keyword_kind kind;
+	const char* name;
 };
-const booleans_ booleans;
 
-struct rarities_ : x3::symbols<lang::rarity>
+/*
+ * parser for all keyword literals at once - literal expressions are attempted for
+ * (almost) every expression so classify the token once instead of attempting
+ * each literal type in sequence
+ */
+struct keyword_literal_parser : x3::parser<keyword_literal_parser>
 {
-	rarities_()
+	using attribute_type = ast::literal_expression;
+	static bool const has_attribute = true;
+
+	template <typename Iterator, typename Context, typename RContext, typename Attr>
+	bool parse(
+		Iterator& first,
+		const Iterator& last,
+		const Context& context,
+		RContext& /* rcontext */,
+		Attr& attr) const
 	{
-		add
-			(lang::keywords::normal, lang::rarity::normal)
-			(lang::keywords::magic,  lang::rarity::magic)
-			(lang::keywords::rare,   lang::rarity::rare)
-			(lang::keywords::unique, lang::rarity::unique)
-		;
+		x3::skip_over(first, last, context);
+
+		Iterator it = first;
+		const keyword_info* info = scan_keyword(it, last);
+		if (info == nullptr)
+			return false;
+
+		switch (info->kind)
+		{
+			case keyword_kind::boolean:
+				assign<ast::boolean_literal>(static_cast<bool>(info->payload), attr);
+				break;
+			case keyword_kind::rarity:
+				assign<ast::rarity_literal>(static_cast<lang::rarity>(info->payload), attr);
+				break;
+			case keyword_kind::shape:
+				assign<ast::shape_literal>(static_cast<lang::shape>(info->payload), attr);
+				break;
+			case keyword_kind::suit:
+				assign<ast::suit_literal>(static_cast<lang::suit>(info->payload), attr);
+				break;
+			case keyword_kind::influence:
+				assign<ast::influence_literal>(static_cast<lang::influence>(info->payload), attr);
+				break;
+			default:
+				return false;
+		}
+
+		first = it;
+		return true;
 	}
-};
-const rarities_ rarities;
 
-struct shapes_ : x3::symbols<lang::shape>
-{
-	shapes_()
+private:
+	template <typename Literal, typename Value, typename Attr>
+	static void assign(Value value, Attr& attr)
 	{
-		add
-			(lang::keywords::circle,   lang::shape::circle)
-			(lang::keywords::diamond,  lang::shape::diamond)
-			(lang::keywords::hexagon,  lang::shape::hexagon)
-			(lang::keywords::square,   lang::shape::square)
-			(lang::keywords::star,     lang::shape::star)
-			(lang::keywords::triangle, lang::shape::triangle)
-		;
+		Literal literal;
+		literal = value;
+		x3::traits::move_to(ast::literal_expression(std::move(literal)), attr);
 	}
 };
-const shapes_ shapes;
 
-struct suits_ : x3::symbols<lang::suit>
-{
-	suits_()
-	{
-		add
-			(lang::keywords::red,    lang::suit::red)
-			(lang::keywords::green,  lang::suit::green)
-			(lang::keywords::blue,   lang::suit::blue)
-			(lang::keywords::white,  lang::suit::white)
-			(lang::keywords::brown,  lang::suit::brown)
-			(lang::keywords::yellow, lang::suit::yellow)
-		;
-	}
+// ---- whitespace ----
 
-};
-const suits_ suits;
+// (nothing to symbolize)
 
-struct influences_ : x3::symbols<lang::influence>
-{
-	influences_()
-	{
-		add
-			(lang::keywords::shaper,   lang::influence::shaper)
-			(lang::keywords::elder,    lang::influence::elder)
-			(lang::keywords::crusader, lang::influence::crusader)
-			(lang::keywords::redeemer, lang::influence::redeemer)
-			(lang::keywords::hunter,   lang::influence::hunter)
-			(lang::keywords::warlord,  lang::influence::warlord)
-		;
-	}
-};
-const influences_ influences;
+// ---- fundamental tokens ----
+
+// (nothing to symbolize)
+
+// ---- literal types ----
+
+constexpr keyword_parser<bool>            booleans  (keyword_kind::boolean,   "boolean literal");
+constexpr keyword_parser<lang::rarity>    rarities  (keyword_kind::rarity,    "rarity literal");
+constexpr keyword_parser<lang::shape>     shapes    (keyword_kind::shape,     "shape literal");
+constexpr keyword_parser<lang::suit>      suits     (keyword_kind::suit,      "suit literal");
+constexpr keyword_parser<lang::influence> influences(keyword_kind::influence, "influence literal");
+
+constexpr keyword_literal_parser keyword_literals;
 
 // ---- expressions ----
 
@@ -104,10 +164,11 @@ const influences_ influences;
 
 // ---- definitions ----
 
-// (nothing to symbolize)
+constexpr keyword_parser<x3::unused_type> import_keyword(keyword_kind::import_directive, lang::keywords::import_);
 
 // ---- rules ----
 
+// not identifier-shaped, hence not in the keyword table
 struct comparison_operators_ : x3::symbols<lang::comparison_type>
 {
 	comparison_operators_()
@@ -123,94 +184,49 @@ struct comparison_operators_ : x3::symbols<lang::comparison_type>
 };
 const comparison_operators_ comparison_operators;
 
-struct comparison_condition_properties_ : x3::symbols<lang::comparison_condition_property>
-{
-	comparison_condition_properties_()
-	{
-		add
-			(lang::keywords::item_level,     lang::comparison_condition_property::item_level)
-			(lang::keywords::drop_level,     lang::comparison_condition_property::drop_level)
-			(lang::keywords::quality,        lang::comparison_condition_property::quality)
-			(lang::keywords::rarity,         lang::comparison_condition_property::rarity)
-			(lang::keywords::sockets,        lang::comparison_condition_property::sockets)
-			(lang::keywords::linked_sockets, lang::comparison_condition_property::links)
-			(lang::keywords::height,         lang::comparison_condition_property::height)
-			(lang::keywords::width,          lang::comparison_condition_property::width)
-			(lang::keywords::stack_size,     lang::comparison_condition_property::stack_size)
-			(lang::keywords::gem_level,      lang::comparison_condition_property::gem_level)
-			(lang::keywords::map_tier,       lang::comparison_condition_property::map_tier)
-		;
-	}
-};
-const comparison_condition_properties_ comparison_condition_properties;
+constexpr keyword_parser<lang::comparison_condition_property> comparison_condition_properties(
+	keyword_kind::comparison_condition_property, "comparison condition property");
+constexpr keyword_parser<lang::array_condition_property> array_condition_properties(
+	keyword_kind::array_condition_property, "array condition property");
+constexpr keyword_parser<lang::boolean_condition_property> boolean_condition_properties(
+	keyword_kind::boolean_condition_property, "boolean condition property");
+constexpr keyword_parser<x3::unused_type> socket_group_keyword(
+	keyword_kind::socket_group_condition, lang::keywords::socket_group);
 
-struct array_condition_properties_ : x3::symbols<lang::array_condition_property>
-{
-	array_condition_properties_()
-	{
-		add
-			(lang::keywords::class_,           lang::array_condition_property::class_)
-			(lang::keywords::base_type,        lang::array_condition_property::base_type)
-			(lang::keywords::has_explicit_mod, lang::array_condition_property::has_explicit_mod)
-			(lang::keywords::has_enchantment,  lang::array_condition_property::has_enchantment)
-			(lang::keywords::prophecy,         lang::array_condition_property::prophecy)
-			(lang::keywords::has_influence,    lang::array_condition_property::has_influence)
-		;
-	}
-};
-const array_condition_properties_ array_condition_properties;
+constexpr keyword_parser<lang::unary_action_type> unary_action_types(
+	keyword_kind::unary_action_type, "unary action");
+constexpr keyword_parser<x3::unused_type> compound_action_keyword(
+	keyword_kind::compound_action, lang::keywords::set);
+
+// ---- filter structure ----
+
+constexpr keyword_parser<bool> visibility_literals(keyword_kind::visibility, "visibility literal");
 
-struct boolean_condition_properties_ : x3::symbols<lang::boolean_condition_property>
+}
+
+namespace boost::spirit::x3
 {
-	boolean_condition_properties_()
-	{
-		add
-			(lang::keywords::identified,        lang::boolean_condition_property::identified)
-			(lang::keywords::corrupted,         lang::boolean_condition_property::corrupted)
-			(lang::keywords::elder_item,        lang::boolean_condition_property::elder_item)
-			(lang::keywords::shaper_item,       lang::boolean_condition_property::shaper_item)
-			(lang::keywords::fractured_item,    lang::boolean_condition_property::fractured_item)
-			(lang::keywords::synthesised_item,  lang::boolean_condition_property::synthesised_item)
-			(lang::keywords::any_enchantment,   lang::boolean_condition_property::any_enchantment)
-			(lang::keywords::shaped_map,        lang::boolean_condition_property::shaped_map)
-			(lang::keywords::elder_map,         lang::boolean_condition_property::elder_map)
-			(lang::keywords::blighted_map,      lang::boolean_condition_property::blighted_map)
-		;
-	}
-};
-const boolean_condition_properties_ boolean_condition_properties;
 
-struct unary_action_types_ : x3::symbols<lang::unary_action_type>
+template <typename Attribute>
+struct get_info<fs::parser::detail::symbols::keyword_parser<Attribute>>
 {
-	unary_action_types_()
+	using result_type = std::string;
+
+	std::string operator()(const fs::parser::detail::symbols::keyword_parser<Attribute>& p) const
 	{
-		add
-			(lang::keywords::set_border_color,           lang::unary_action_type::set_border_color)
-			(lang::keywords::set_text_color,             lang::unary_action_type::set_text_color)
-			(lang::keywords::set_background_color,       lang::unary_action_type::set_background_color)
-			(lang::keywords::set_font_size,              lang::unary_action_type::set_font_size)
-			(lang::keywords::set_alert_sound,            lang::unary_action_type::set_alert_sound)
-			(lang::keywords::play_default_drop_sound,    lang::unary_action_type::play_default_drop_sound)
-			(lang::keywords::set_minimap_icon,           lang::unary_action_type::set_minimap_icon)
-			(lang::keywords::set_beam,                   lang::unary_action_type::set_beam)
-		;
+		return p.name;
 	}
 };
-const unary_action_types_ unary_action_types;
-
-// ---- filter structure ----
 
-struct visibility_literals_ : x3::symbols<bool>
+template <>
+struct get_info<fs::parser::detail::symbols::keyword_literal_parser>
 {
-	visibility_literals_()
+	using result_type = std::string;
+
+	std::string operator()(const fs::parser::detail::symbols::keyword_literal_parser&) const
 	{
-		add
-			(lang::keywords::show, true)
-			(lang::keywords::hide, false)
-		;
+		return "keyword literal";
 	}
-
 };
-const visibility_literals_ visibility_literals;
 
 }
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace fs::parser::detail
+{
+
+/**
+ * @brief find offsets at which the input can be split into independently parsed chunks
+ * @details Used by parse_parallel(). Returned offsets are sorted. For valid input,
+ * each of them splits the input between 2 top-level items (imports, definitions
+ * or statements) - otherwise parsing of some chunk fails and parse_parallel()
+ * falls back to parsing the whole input serially.
+ */
+[[nodiscard]]
+std::vector<std::size_t> find_top_level_boundaries(std::string_view input);
+
+}
@@ -0,0 +1,122 @@
+/**
+ * @file generic AST traversal
+ *
+ * @details Visits every position-tagged AST node, parents before children.
+ * Nodes are passed with their own type (callbacks taking x3::position_tagged
+ * work for all of them). Constness of the visited tree is preserved so the same
+ * traversal can be used both to inspect and to modify node position information.
+ */
+#pragma once
+
+#include <fs/parser/ast.hpp>
+
+#include <boost/variant/apply_visitor.hpp>
+
+#include <type_traits>
+
+namespace fs::parser
+{
+
+template <typename Node, typename F>
+void for_each_node(Node& node, F& f)
+{
+	using node_type = std::remove_const_t<Node>;
+	static_assert(std::is_base_of_v<boost::spirit::x3::position_tagged, node_type>, "all AST nodes should be position-tagged");
+
+	f(node);
+
+	const auto visit = [&f](auto& child) { for_each_node(child, f); };
+
+	if constexpr (
+		std::is_same_v<node_type, ast::literal_expression>
+		|| std::is_same_v<node_type, ast::primary_expression>
+		|| std::is_same_v<node_type, ast::condition>
+		|| std::is_same_v<node_type, ast::action>
+		|| std::is_same_v<node_type, ast::statement>)
+	{
+		boost::apply_visitor(visit, node.var);
+	}
+	else if constexpr (
+		std::is_same_v<node_type, ast::value_expression_list>
+		|| std::is_same_v<node_type, ast::compound_action_expression>)
+	{
+		for (auto& element : node)
+			visit(element);
+	}
+	else if constexpr (
+		std::is_same_v<node_type, ast::function_call>
+		|| std::is_same_v<node_type, ast::price_range_query>)
+	{
+		visit(node.name);
+		visit(node.arguments);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::array_expression>)
+	{
+		visit(node.elements);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::value_expression>)
+	{
+		visit(node.primary_expr);
+		for (auto& postfix_expr : node.postfix_exprs)
+			visit(postfix_expr);
+	}
+	else if constexpr (
+		std::is_same_v<node_type, ast::subscript>
+		|| std::is_same_v<node_type, ast::postfix_expression>)
+	{
+		visit(node.expr);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::import_directive>)
+	{
+		visit(node.path);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::constant_definition>)
+	{
+		visit(node.name);
+		visit(node.value);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::definition>)
+	{
+		visit(node.definition);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::comparison_condition>)
+	{
+		visit(node.comparison_type);
+		visit(node.value);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::array_condition>)
+	{
+		visit(node.exact_match);
+		visit(node.value);
+	}
+	else if constexpr (
+		std::is_same_v<node_type, ast::boolean_condition>
+		|| std::is_same_v<node_type, ast::socket_group_condition>
+		|| std::is_same_v<node_type, ast::unary_action>
+		|| std::is_same_v<node_type, ast::compound_action>)
+	{
+		visit(node.value);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::rule_block>)
+	{
+		for (auto& condition : node.conditions)
+			visit(condition);
+
+		for (auto& statement : node.statements)
+			visit(statement);
+	}
+	else if constexpr (std::is_same_v<node_type, ast::filter_structure>)
+	{
+		for (auto& import : node.imports)
+			visit(import);
+
+		for (auto& definition : node.definitions)
+			visit(definition);
+
+		for (auto& statement : node.statements)
+			visit(statement);
+	}
+	// else: a leaf (identifier, literals, operators, visibility statement) - nothing to descend into
+}
+
+}
@@ -1,16 +1,34 @@
 #include <fs/parser/parser.hpp>
 #include <fs/parser/print_error.hpp>
 #include <fs/parser/detail/grammar.hpp>
+#include <fs/parser/detail/keyword_table.hpp>
+#include <fs/parser/detail/top_level_boundaries.hpp>
+#include <fs/parser/for_each_node.hpp>
 #include <fs/log/logger.hpp>
 #include <fs/log/utility.hpp>
+#include <fs/utility/parallel.hpp>
 
-namespace fs::parser
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+namespace
 {
 
-std::variant<parse_success_data, parse_failure_data> parse(std::string_view input)
+using namespace fs;
+using namespace fs::parser;
+
+struct range_parse_result
+{
+	bool success;
+	ast::ast_type ast;
+	detail::position_cache_type position_cache;
+	error_holder_type errors;
+	const char* stop_position;
+};
+
+range_parse_result parse_range(const char* first, const char* last)
 {
-	const char *const first{input.data()};
-	const char *const last {input.data() + input.size()};
 	detail::position_cache_type position_cache(first, last);
 	error_holder_type error_holder;
 	// note: x3::with<> must match with grammar's context_type, otherwise you will get linker errors
@@ -28,12 +46,439 @@ std::variant<parse_success_data, parse_failure_data> parse(std::string_view inpu
 		skipper(),
 		ast);
 
-	if (it != last || !result)
-		return parse_failure_data{lookup_data(std::move(position_cache)), std::move(error_holder), it};
+	return range_parse_result{it == last && result, std::move(ast), std::move(position_cache), std::move(error_holder), it};
+}
+
+// text range of a top-level definition or statement, as offsets from the beginning of the input
+struct item_range
+{
+	std::size_t first;
+	std::size_t last;
+};
+
+// top-level items are held in separate vectors, in the source they appear in this order
+constexpr int import_kind     = 0;
+constexpr int definition_kind = 1;
+constexpr int statement_kind  = 2;
+
+// kinds of the first and of the last top-level item
+struct item_kinds
+{
+	int first;
+	int last;
+};
+
+std::optional<item_kinds> kinds_of_items(const ast::ast_type& ast)
+{
+	const std::size_t counts[] = { ast.imports.size(), ast.definitions.size(), ast.statements.size() };
+	std::optional<item_kinds> result;
+	for (int kind = import_kind; kind <= statement_kind; ++kind) {
+		if (counts[kind] == 0)
+			continue;
+
+		if (result)
+			result->last = kind;
+		else
+			result = item_kinds{kind, kind};
+	}
+
+	return result;
+}
+
+/*
+ * Top-level items of all kinds as one sequence, in source order. Ranges
+ * are looked up only for items that are asked for - edits should not
+ * cost time proportional to the size of the whole input.
+ */
+class top_level_items
+{
+public:
+	top_level_items(const ast::ast_type& ast, const detail::position_cache_type& position_cache)
+	: ast(ast)
+	, position_cache(position_cache)
+	, kind_first{0, ast.imports.size(), ast.imports.size() + ast.definitions.size()}
+	, num_items(kind_first[statement_kind] + ast.statements.size())
+	{
+	}
+
+	std::size_t size() const noexcept { return num_items; }
+
+	std::size_t first_of_kind(int kind) const noexcept { return kind_first[kind]; }
+	std::size_t last_of_kind(int kind) const noexcept { return kind == statement_kind ? size() : kind_first[kind + 1]; }
+
+	int kind_of(std::size_t index) const noexcept
+	{
+		return index < kind_first[definition_kind] ? import_kind : index < kind_first[statement_kind] ? definition_kind : statement_kind;
+	}
+
+	item_range range_of(std::size_t index) const
+	{
+		const detail::range_type range = position_cache.position_of(item(index));
+		return item_range{
+			static_cast<std::size_t>(range.begin() - position_cache.first()),
+			static_cast<std::size_t>(range.end() - position_cache.first())};
+	}
+
+	// index of the first item in [first, size()) for which predicate is false, predicate must be partitioning
+	template <typename Predicate>
+	std::size_t partition_point(std::size_t first, Predicate predicate) const
+	{
+		std::size_t last = size();
+		while (first < last) {
+			const std::size_t middle = first + (last - first) / 2;
+			if (predicate(range_of(middle)))
+				first = middle + 1;
+			else
+				last = middle;
+		}
+
+		return first;
+	}
+
+private:
+	const x3::position_tagged& item(std::size_t index) const
+	{
+		switch (kind_of(index)) {
+			case import_kind:
+				return ast.imports[index];
+			case definition_kind:
+				return ast.definitions[index - kind_first[definition_kind]];
+			default:
+				return ast.statements[index - kind_first[statement_kind]];
+		}
+	}
+
+	const ast::ast_type& ast;
+	const detail::position_cache_type& position_cache;
+	std::size_t kind_first[3];
+	std::size_t num_items;
+};
+
+void shift_position_ids(ast::ast_type& ast, int offset)
+{
+	auto shift = [offset](x3::position_tagged& node) {
+		// nodes that were never annotated have negative IDs
+		if (node.id_first >= 0)
+			node.id_first += offset;
+
+		if (node.id_last >= 0)
+			node.id_last += offset;
+	};
+	for_each_node(ast, shift);
+}
+
+// append positions of a separately parsed part of the same input, shift IDs of its nodes accordingly
+void append_positions(
+	detail::position_cache_type& destination,
+	const detail::position_cache_type& source,
+	ast::ast_type& source_ast)
+{
+	const int offset = static_cast<int>(destination.size());
+
+	x3::position_tagged placeholder;
+	for (std::size_t i = 0; i + 1 < source.size(); i += 2)
+		destination.annotate(placeholder, source.position_at(static_cast<int>(i)), source.position_at(static_cast<int>(i + 1)));
+
+	shift_position_ids(source_ast, offset);
+}
+
+constexpr bool is_identifier_start(char c) noexcept
+{
+	return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_';
+}
+
+constexpr bool is_identifier_continuation(char c) noexcept
+{
+	return is_identifier_start(c) || ('0' <= c && c <= '9');
+}
+
+template <typename T>
+void move_all(std::vector<T>& source, std::vector<T>& destination)
+{
+	destination.insert(destination.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+}
+
+}
+
+namespace fs::parser::detail
+{
+
+/*
+ * Find offsets at which the input can be split without changing the parse:
+ * - after a top-level '}' not followed by '[' (which would be a subscript)
+ * - at the beginning of a top-level line of the form "identifier =" (a definition),
+ *   unless the identifier is a keyword
+ * No top-level item can continue with such text. Strings and comments are skipped.
+ * Anything unusual (eg unbalanced brackets) does not have to be handled precisely
+ * here - the parse of some chunk will fail and the whole input will be parsed serially.
+ */
+std::vector<std::size_t> find_top_level_boundaries(std::string_view input)
+{
+	std::vector<std::size_t> result;
+	int depth = 0;
+	bool line_beginning = true;
+	std::size_t pending_brace_boundary = 0; // 0 - none
+
+	for (std::size_t i = 0; i < input.size(); ++i) {
+		const char c = input[i];
+
+		if (c == '\n') {
+			line_beginning = true;
+			continue;
+		}
+
+		if (c == ' ' || c == '\t' || c == '\r')
+			continue;
+
+		if (c == '#') {
+			while (i + 1 < input.size() && input[i + 1] != '\n')
+				++i;
+
+			continue;
+		}
+
+		if (pending_brace_boundary != 0) {
+			if (c != '[')
+				result.push_back(pending_brace_boundary);
+
+			pending_brace_boundary = 0;
+		}
+
+		if (depth == 0 && line_beginning && i != 0 && is_identifier_start(c)) {
+			std::size_t j = i;
+			while (j < input.size() && is_identifier_continuation(input[j]))
+				++j;
+
+			const std::size_t end_of_identifier = j;
+
+			while (j < input.size() && (input[j] == ' ' || input[j] == '\t'))
+				++j;
+
+			// conditions such as "Quality = 20" have the same shape - never split before
+			// a keyword, at worst a chunk is bigger than necessary
+			const bool is_keyword = find_keyword(input.substr(i, end_of_identifier - i)) != nullptr;
+			if (!is_keyword && j + 1 < input.size() && input[j] == '=' && input[j + 1] != '=')
+				result.push_back(i);
+		}
+
+		line_beginning = false;
+
+		if (c == '"') {
+			while (i + 1 < input.size() && input[i + 1] != '"' && input[i + 1] != '\n')
+				++i;
+
+			if (i + 1 < input.size() && input[i + 1] == '"')
+				++i;
+		}
+		else if (c == '(' || c == '[' || c == '{') {
+			++depth;
+		}
+		else if (c == ')' || c == ']' || c == '}') {
+			if (depth > 0)
+				--depth;
+
+			if (depth == 0 && c == '}')
+				pending_brace_boundary = i + 1;
+		}
+	}
+
+	if (pending_brace_boundary != 0 && pending_brace_boundary != input.size())
+		result.push_back(pending_brace_boundary);
+
+	return result;
+}
+
+}
+
+namespace fs::parser
+{
+
+std::variant<parse_success_data, parse_failure_data> parse(std::string_view input)
+{
+	range_parse_result result = parse_range(input.data(), input.data() + input.size());
+
+	if (!result.success)
+		return parse_failure_data{lookup_data(std::move(result.position_cache)), std::move(result.errors), result.stop_position};
+
+	return parse_success_data{std::move(result.ast), lookup_data(std::move(result.position_cache))};
+}
+
+std::variant<parse_success_data, parse_failure_data>
+parse_parallel(std::string_view input, unsigned num_threads, std::size_t min_chunk_size)
+{
+	num_threads = utility::resolve_thread_count(num_threads);
+	if (num_threads <= 1 || input.size() < 2 * min_chunk_size)
+		return parse(input);
+
+	// aim for a few chunks per thread so that uneven chunks balance out
+	const std::size_t target_chunk_size = std::max(min_chunk_size, input.size() / (4 * num_threads));
+	std::vector<std::size_t> chunk_offsets = {0};
+	for (std::size_t boundary : detail::find_top_level_boundaries(input)) {
+		if (boundary - chunk_offsets.back() >= target_chunk_size && input.size() - boundary >= min_chunk_size)
+			chunk_offsets.push_back(boundary);
+	}
+	chunk_offsets.push_back(input.size());
+
+	const std::size_t num_chunks = chunk_offsets.size() - 1;
+	if (num_chunks < 2)
+		return parse(input);
+
+	const char* const first = input.data();
+	const char* const last = input.data() + input.size();
+	std::vector<std::optional<range_parse_result>> chunks(num_chunks);
+	utility::parallel_for(num_chunks, num_threads, [&](std::size_t i) {
+		chunks[i] = parse_range(first + chunk_offsets[i], first + chunk_offsets[i + 1]);
+	});
+
+	int last_kind = import_kind;
+	for (const std::optional<range_parse_result>& chunk : chunks) {
+		if (!chunk->success)
+			return parse(input);
+
+		if (const std::optional<item_kinds> kinds = kinds_of_items(chunk->ast); kinds) {
+			if (kinds->first < last_kind)
+				return parse(input);
+
+			last_kind = kinds->last;
+		}
+	}
+
+	detail::position_cache_type position_cache(first, last);
+	ast::ast_type ast;
+	const range_parse_result* first_nonempty_chunk = nullptr;
+	for (std::optional<range_parse_result>& chunk : chunks) {
+		append_positions(position_cache, chunk->position_cache, chunk->ast);
+		move_all(chunk->ast.imports, ast.imports);
+		move_all(chunk->ast.definitions, ast.definitions);
+		move_all(chunk->ast.statements, ast.statements);
+
+		if (first_nonempty_chunk == nullptr && kinds_of_items(chunk->ast))
+			first_nonempty_chunk = &*chunk;
+	}
+
+	// whole filter structure spans from the first (skipped whitespace) token to the end of input
+	if (first_nonempty_chunk == nullptr)
+		first_nonempty_chunk = &*chunks.back();
+
+	const detail::iterator_type structure_first = position_cache.position_at(first_nonempty_chunk->ast.id_first);
+	position_cache.annotate(ast, structure_first, last);
 
 	return parse_success_data{std::move(ast), lookup_data(std::move(position_cache))};
 }
 
+std::variant<parse_success_data, parse_failure_data>
+parse_incremental(std::string_view input, text_edit edit, parse_success_data previous)
+{
+	const detail::position_cache_type& old_position_cache = previous.lookup_data.get_position_cache();
+	const std::size_t old_size = old_position_cache.last() - old_position_cache.first();
+
+	if (edit.offset + edit.removed_length > old_size
+		|| old_size - edit.removed_length + edit.inserted_length != input.size())
+	{
+		return parse(input);
+	}
+
+	const std::ptrdiff_t size_difference =
+		static_cast<std::ptrdiff_t>(edit.inserted_length) - static_cast<std::ptrdiff_t>(edit.removed_length);
+	const std::size_t edit_first = edit.offset;
+	const std::size_t edit_last  = edit.offset + edit.removed_length;
+
+	/*
+	 * Determine which top-level items [reparse_first, reparse_last) have to be parsed again:
+	 * - all items that overlap or touch the edit
+	 * - the item right before them: it might continue into the edited text
+	 *   (eg inserting "[0]" after a definition turns it into a subscript)
+	 * - all items until the next one that starts at the beginning of a line: an edit
+	 *   can start a comment which would swallow the rest of the line
+	 * Items are in source order, so they are found by binary search.
+	 */
+	ast::ast_type& old_ast = previous.ast;
+	const top_level_items items(old_ast, old_position_cache);
+
+	std::size_t reparse_first = items.partition_point(0, [&](item_range item) { return item.last < edit_first; });
+	if (reparse_first > 0)
+		--reparse_first;
+
+	std::size_t reparse_last = items.partition_point(reparse_first, [&](item_range item) { return item.first <= edit_last; });
+
+	const auto starts_at_line_beginning = [&](item_range item) {
+		const std::size_t first_in_new_input = item.first + size_difference;
+		return first_in_new_input == 0 || input[first_in_new_input - 1] == '\n';
+	};
+	while (reparse_last < items.size() && !starts_at_line_beginning(items.range_of(reparse_last)))
+		++reparse_last;
+
+	const std::size_t region_first = reparse_first == 0 ? 0u : items.range_of(reparse_first).first;
+	const std::size_t region_last  = reparse_last == items.size() ? old_size : items.range_of(reparse_last).first;
+
+	const char* const new_first = input.data();
+	const char* const new_last  = input.data() + input.size();
+	range_parse_result region = parse_range(new_first + region_first, new_first + region_last + size_difference);
+	if (!region.success)
+		return parse(input);
+
+	/*
+	 * Imports must precede definitions which must precede statements - if they
+	 * would not, the whole input has an error which is best reported by a full parse.
+	 */
+	int last_kind = reparse_first > 0 ? items.kind_of(reparse_first - 1) : import_kind;
+	if (const std::optional<item_kinds> kinds = kinds_of_items(region.ast); kinds) {
+		if (kinds->first < last_kind)
+			return parse(input);
+
+		last_kind = kinds->last;
+	}
+
+	if (reparse_last < items.size() && items.kind_of(reparse_last) < last_kind)
+		return parse(input);
+
+	/*
+	 * Stitch the AST in place: items of the region replace discarded items, reused
+	 * items keep their IDs. The position cache moves to the new input (positions
+	 * after the region are shifted lazily), positions of the region are appended
+	 * and IDs of region nodes are shifted accordingly. Positions inside the region
+	 * belong only to discarded nodes.
+	 */
+	const auto splice = [&](int kind, auto member) {
+		// amount of reused items of this kind in [first, last) range of all items
+		const auto count_reused = [&](std::size_t first, std::size_t last) {
+			const std::size_t overlap_first = std::max(first, items.first_of_kind(kind));
+			const std::size_t overlap_last  = std::min(last, items.last_of_kind(kind));
+			return overlap_first < overlap_last ? overlap_last - overlap_first : 0u;
+		};
+		const std::size_t prefix = count_reused(0, reparse_first);
+		const std::size_t suffix = count_reused(reparse_last, items.size());
+
+		auto& old_items = old_ast.*member;
+		auto& region_items = region.ast.*member;
+		old_items.erase(old_items.begin() + prefix, old_items.end() - suffix);
+		old_items.insert(
+			old_items.begin() + prefix,
+			std::make_move_iterator(region_items.begin()),
+			std::make_move_iterator(region_items.end()));
+	};
+
+	detail::position_cache_type position_cache = std::move(previous.lookup_data).get_position_cache();
+	position_cache.replace_text(new_first, new_last, region_first, region_last, size_difference);
+	append_positions(position_cache, region.position_cache, region.ast);
+
+	// whole filter structure spans from the first (skipped whitespace) token to the end of input
+	const detail::iterator_type structure_first = region_first == 0
+		? position_cache.position_at(region.ast.id_first)
+		: position_cache.position_at(old_ast.id_first);
+
+	splice(import_kind, &ast::ast_type::imports);
+	splice(definition_kind, &ast::ast_type::definitions);
+	splice(statement_kind, &ast::ast_type::statements);
+	position_cache.annotate(old_ast, structure_first, new_last);
+
+	// positions of replaced items are dead - do not let them pile up over many edits
+	if (position_cache.should_rebuild())
+		position_cache.keep_only([&](auto& keep_node) { for_each_node(old_ast, keep_node); });
+
+	return parse_success_data{std::move(old_ast), lookup_data(std::move(position_cache))};
+}
+
 void print_parse_errors(const parse_failure_data& parse_data, log::logger& logger)
 {
 	if (parse_data.errors.empty())
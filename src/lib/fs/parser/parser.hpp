@@ -8,6 +8,7 @@
 #include <string_view>
 #include <variant>
 #include <utility>
+#include <cstddef>
 #include <cassert>
 
 namespace fs::parser
@@ -42,6 +43,18 @@ public:
 		return fs::log::make_string_view(range.begin(), range.end());
 	}
 
+	[[nodiscard]]
+	const detail::position_cache_type& get_position_cache() const &
+	{
+		return position_cache;
+	}
+
+	[[nodiscard]]
+	detail::position_cache_type get_position_cache() &&
+	{
+		return std::move(position_cache);
+	}
+
 private:
 	[[nodiscard]]
 	detail::range_type range_of(const x3::position_tagged& ast) const
@@ -52,7 +65,7 @@ private:
 	[[nodiscard]]
 	detail::range_type get_range_of_whole_content() const
 	{
-		assert(!position_cache.get_positions().empty());
+		assert(position_cache.size() != 0);
 		return detail::range_type(position_cache.first(), position_cache.last());
 	}
 
@@ -75,6 +88,45 @@ struct parse_failure_data
 [[nodiscard]]
 std::variant<parse_success_data, parse_failure_data> parse(std::string_view input);
 
+/**
+ * @brief parse @p input, splitting it into top-level chunks which are parsed concurrently
+ * @details A fast pre-scan (tracking bracket depth, skipping strings and comments) finds
+ * places where a top-level item can not continue: after a closing top-level brace and
+ * before a top-level definition. Chunks are parsed concurrently and stitched in source
+ * order. If any chunk fails (or a definition would follow a statement) the whole input
+ * is parsed serially, so the result - including errors - is always the same as of parse().
+ * @param num_threads number of threads to use, 0 means all hardware threads
+ * @param min_chunk_size inputs smaller than 2 chunks are parsed serially
+ */
+[[nodiscard]]
+std::variant<parse_success_data, parse_failure_data>
+parse_parallel(std::string_view input, unsigned num_threads = 0, std::size_t min_chunk_size = 16 * 1024);
+
+/**
+ * @brief description of a change of parser's input
+ * @details the text in range [offset, offset + removed_length) of the previous
+ * input has been replaced by inserted_length characters
+ */
+struct text_edit
+{
+	std::size_t offset;
+	std::size_t removed_length;
+	std::size_t inserted_length;
+};
+
+/**
+ * @brief parse @p input which differs from the previously parsed input only by @p edit
+ * @details Top-level definitions and statements which are not affected by the edit
+ * are taken from @p previous, only the region around the edit is parsed again.
+ * The result is the same as the result of parse(input) - when the region can not
+ * be parsed on its own (any error or a definition after a statement) the whole
+ * input is parsed again so that errors are reported exactly as by parse().
+ * @note The input from which @p previous has been created must still be alive.
+ */
+[[nodiscard]]
+std::variant<parse_success_data, parse_failure_data>
+parse_incremental(std::string_view input, text_edit edit, parse_success_data previous);
+
 void print_parse_errors(const parse_failure_data& parse_data, log::logger& logger);
 
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <utility>
+
+namespace fs::utility
+{
+
+/*
+ * reference-counted value that is copied only when modified
+ *
+ * Copying only increments the reference count. edit() gives mutable
+ * access and makes a private copy of the value first if it is shared
+ * with any other instance - so modifications are never visible through
+ * other copies.
+ *
+ * Thread safety: the same as of std::shared_ptr. Different copies can be
+ * used (also edited) from different threads, eg by parallel_for workers,
+ * but edit() of an instance must not run concurrently with any other use
+ * of the same instance, copying it included. Under this rule use_count()
+ * is exact where edit() relies on it: a count of 1 means no other copy
+ * exists and none can appear until edit() returns. A stale count greater
+ * than 1 (a copy has just been released by another thread) only causes
+ * an unnecessary clone.
+ */
+template <typename T>
+class copy_on_write
+{
+public:
+	copy_on_write()
+	: ptr(std::make_shared<T>())
+	{
+	}
+
+	copy_on_write(T value)
+	: ptr(std::make_shared<T>(std::move(value)))
+	{
+	}
+
+	const T& get() const noexcept { return *ptr; }
+	const T& operator*() const noexcept { return *ptr; }
+	const T* operator->() const noexcept { return ptr.get(); }
+
+	T& edit()
+	{
+		if (ptr.use_count() != 1)
+			ptr = std::make_shared<T>(*ptr);
+		else // other copies could have just been released by other threads
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+		// fails if this instance has been copied concurrently, see thread safety above
+		assert(ptr.use_count() == 1);
+		return *ptr;
+	}
+
+	bool shares_value_with(const copy_on_write& other) const noexcept
+	{
+		return ptr == other.ptr;
+	}
+
+private:
+	std::shared_ptr<T> ptr;
+};
+
+}
@@ -0,0 +1,36 @@
+#include <fs/utility/hash.hpp>
+
+#include <openssl/evp.h>
+
+#include <memory>
+#include <stdexcept>
+
+namespace fs::utility
+{
+
+std::string sha256_hex(std::string_view data)
+{
+	const std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(EVP_MD_CTX_new(), &EVP_MD_CTX_free);
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int digest_size = 0;
+
+	if (context == nullptr
+		|| EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr) != 1
+		|| EVP_DigestUpdate(context.get(), data.data(), data.size()) != 1
+		|| EVP_DigestFinal_ex(context.get(), digest, &digest_size) != 1)
+	{
+		throw std::runtime_error("failed to compute SHA-256 digest");
+	}
+
+	constexpr char hex_digits[] = "0123456789abcdef";
+	std::string result;
+	result.reserve(digest_size * 2);
+	for (unsigned int i = 0; i < digest_size; ++i) {
+		result += hex_digits[digest[i] >> 4];
+		result += hex_digits[digest[i] & 0x0f];
+	}
+
+	return result;
+}
+
+}
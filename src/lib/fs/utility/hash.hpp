@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace fs::utility
+{
+
+// SHA-256 digest of the data, as a lowercase hexadecimal string
+[[nodiscard]]
+std::string sha256_hex(std::string_view data);
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace fs::utility
+{
+
+/*
+ * reference-counted, read-only value
+ *
+ * Copying only increments the reference count - the value is never
+ * modified after construction so all copies can safely share it
+ * (also between threads). To "modify" it, copy the value out and
+ * construct a new immutable object.
+ */
+template <typename T>
+class immutable
+{
+public:
+	immutable()
+	: ptr(std::make_shared<const T>())
+	{
+	}
+
+	immutable(T value)
+	: ptr(std::make_shared<const T>(std::move(value)))
+	{
+	}
+
+	const T& get() const noexcept { return *ptr; }
+	const T& operator*() const noexcept { return *ptr; }
+	const T* operator->() const noexcept { return ptr.get(); }
+
+	bool shares_value_with(const immutable& other) const noexcept
+	{
+		return ptr == other.ptr;
+	}
+
+private:
+	std::shared_ptr<const T> ptr;
+};
+
+template <typename T>
+bool operator==(const immutable<T>& lhs, const immutable<T>& rhs)
+{
+	return lhs.shares_value_with(rhs) || *lhs == *rhs;
+}
+
+template <typename T>
+bool operator!=(const immutable<T>& lhs, const immutable<T>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+
+namespace fs::utility
+{
+
+/**
+ * @class hash-consing of shared values
+ *
+ * @details Maps every value to a canonical instance: the first added one
+ * which compares equal. After interning, equal values share one instance
+ * so they can be compared by address. Hashes are computed once per
+ * interned value.
+ *
+ * @tparam Handle shared handle to a value (eg std::shared_ptr or
+ * utility::copy_on_write), dereferenced with operator*
+ * @tparam Hash function object computing hash of the pointed value
+ *
+ * Thread safety: none, use one pool per thread or lock externally.
+ */
+template <typename Handle, typename Hash>
+class intern_pool
+{
+public:
+	explicit intern_pool(Hash hash = Hash())
+	: hash(std::move(hash))
+	{
+	}
+
+	// returns canonical handle to a value equal to *value
+	Handle intern(const Handle& value)
+	{
+		const std::size_t h = hash(*value);
+		const auto [first, last] = values.equal_range(h);
+		for (auto it = first; it != last; ++it)
+			if (&*it->second == &*value || *it->second == *value)
+				return it->second;
+
+		values.emplace(h, value);
+		return value;
+	}
+
+	// number of distinct values
+	std::size_t size() const noexcept { return values.size(); }
+
+private:
+	Hash hash;
+	std::unordered_multimap<std::size_t, Handle> values;
+};
+
+}
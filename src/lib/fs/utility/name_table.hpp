@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace fs::utility
+{
+
+/**
+ * @class compile-time perfect hash map from names to values
+ *
+ * @details The table is built by a constexpr constructor: it searches for a hash
+ * seed for which every name lands in a different slot, so a lookup is 1 hash of
+ * the searched name and at most 1 string comparison. Intended for small sets of
+ * built-in names (functions, queries etc) mapped to handlers - build it as a
+ * static constexpr object so that the search happens during compilation.
+ *
+ * @tparam T type of values, must be a literal type (eg a function pointer)
+ * @tparam N number of entries
+ */
+template <typename T, std::size_t N>
+class name_table
+{
+public:
+	using entry = std::pair<std::string_view, T>;
+
+	constexpr explicit name_table(const std::array<entry, N>& entries)
+	{
+		for (std::uint32_t candidate = 0;; ++candidate) {
+			if (try_seed(entries, candidate)) {
+				seed = candidate;
+				return;
+			}
+		}
+	}
+
+	// returns nullptr if there is no such name
+	constexpr const T* find(std::string_view name) const noexcept
+	{
+		const slot& s = slots[index_of(name, seed)];
+		if (!s.used || s.name != name)
+			return nullptr;
+
+		return &s.value;
+	}
+
+private:
+	// enough free slots that a collision-free seed is found quickly
+	static constexpr std::size_t num_slots = [] {
+		std::size_t n = 1;
+		while (n < 4 * N)
+			n *= 2;
+		return n;
+	}();
+
+	struct slot
+	{
+		std::string_view name;
+		T value{};
+		bool used = false;
+	};
+
+	// FNV-1a
+	static constexpr std::size_t index_of(std::string_view name, std::uint32_t seed) noexcept
+	{
+		std::uint32_t hash = 2166136261u ^ seed;
+		for (char c : name) {
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 16777619u;
+		}
+
+		return hash & (num_slots - 1);
+	}
+
+	constexpr bool try_seed(const std::array<entry, N>& entries, std::uint32_t candidate)
+	{
+		slots = {};
+		for (const entry& e : entries) {
+			slot& s = slots[index_of(e.first, candidate)];
+			if (s.used)
+				return false;
+
+			s = slot{e.first, e.second, true};
+		}
+
+		return true;
+	}
+
+	std::array<slot, num_slots> slots{};
+	std::uint32_t seed = 0;
+};
+
+}
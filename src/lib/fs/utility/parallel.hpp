@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace fs::utility
+{
+
+/**
+ * @brief number of threads to use for a requested thread count
+ * @param requested requested number of threads, 0 means all hardware threads
+ */
+inline unsigned resolve_thread_count(unsigned requested) noexcept
+{
+	if (requested != 0)
+		return requested;
+
+	const unsigned hardware = std::thread::hardware_concurrency();
+	return hardware == 0 ? 1 : hardware;
+}
+
+/**
+ * @brief call f(i) for each i in [0, count) using up to num_threads threads
+ *
+ * @details
+ * Indexes are handed out dynamically so that uneven work items balance out.
+ * The calling thread also does the work. With 1 thread (or 1 item) no extra
+ * threads are started.
+ *
+ * Exception safety: if any call throws, remaining indexes may be skipped and
+ * the first caught exception is rethrown after all threads finish.
+ */
+template <typename F>
+void parallel_for(std::size_t count, unsigned num_threads, F f)
+{
+	if (num_threads <= 1 || count <= 1) {
+		for (std::size_t i = 0; i < count; ++i)
+			f(i);
+
+		return;
+	}
+
+	std::atomic<std::size_t> next_index = 0;
+	const auto work = [&]() {
+		for (std::size_t i = next_index++; i < count; i = next_index++)
+			f(i);
+	};
+
+	const std::size_t num_workers = std::min<std::size_t>(num_threads, count) - 1;
+	std::vector<std::future<void>> workers;
+	workers.reserve(num_workers);
+	for (std::size_t i = 0; i < num_workers; ++i)
+		workers.push_back(std::async(std::launch::async, work));
+
+	std::exception_ptr exception;
+	try {
+		work();
+	}
+	catch (...) {
+		exception = std::current_exception();
+		next_index = count;
+	}
+
+	for (std::future<void>& worker : workers) {
+		try {
+			worker.get();
+		}
+		catch (...) {
+			if (!exception)
+				exception = std::current_exception();
+		}
+	}
+
+	if (exception)
+		std::rethrow_exception(exception);
+}
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace fs::utility
+{
+
+/**
+ * @class append-only text output
+ *
+ * @details A replacement for std::ostringstream in hot output paths: no
+ * locale, no virtual calls per token and numbers are formatted with
+ * std::to_chars. Reserve the expected size upfront to avoid reallocations.
+ */
+class string_builder
+{
+public:
+	string_builder() = default;
+
+	explicit string_builder(std::size_t expected_size)
+	{
+		reserve(expected_size);
+	}
+
+	void reserve(std::size_t expected_size) { buffer.reserve(expected_size); }
+	// keeps the capacity
+	void clear() noexcept { buffer.clear(); }
+
+	string_builder& operator<<(char c)
+	{
+		buffer.push_back(c);
+		return *this;
+	}
+
+	string_builder& operator<<(std::string_view str)
+	{
+		buffer.append(str);
+		return *this;
+	}
+
+	string_builder& operator<<(const char* str)
+	{
+		return *this << std::string_view(str);
+	}
+
+	string_builder& operator<<(int n)
+	{
+		std::array<char, 12> digits; // "-2147483648"
+		const std::to_chars_result result = std::to_chars(digits.data(), digits.data() + digits.size(), n);
+		buffer.append(digits.data(), result.ptr);
+		return *this;
+	}
+
+	std::size_t size() const noexcept { return buffer.size(); }
+	const std::string& str() const & noexcept { return buffer; }
+	std::string str() && noexcept { return std::move(buffer); }
+
+private:
+	std::string buffer;
+};
+
+}
@@ -0,0 +1,141 @@
+#include <fs/utility/substring_patterns.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace
+{
+
+constexpr int no_node = -1;
+
+/*
+ * Aho-Corasick automaton over sorted unique patterns. Inserting sorted
+ * patterns adds children of every node in increasing order of characters,
+ * so transitions can be binary searched without any extra sorting.
+ */
+class pattern_automaton
+{
+public:
+	explicit pattern_automaton(const std::vector<std::string>& sorted_patterns)
+	{
+		nodes.emplace_back();
+		for (const std::string& pattern : sorted_patterns)
+			insert(pattern);
+
+		build_links();
+	}
+
+	// whether pattern contains any other pattern of the automaton
+	bool contains_other_pattern(const std::string& pattern) const
+	{
+		int state = 0;
+		for (std::size_t i = 0; i < pattern.size(); ++i) {
+			state = next_state(state, static_cast<unsigned char>(pattern[i]));
+
+			// any pattern ending before the end of this one is a different pattern
+			if (i + 1 < pattern.size() && nodes[state].output != no_node)
+				return true;
+		}
+
+		// here state is the node of the pattern itself, look only at its proper suffixes
+		return state != 0 && nodes[nodes[state].fail].output != no_node;
+	}
+
+private:
+	struct node
+	{
+		std::vector<std::pair<unsigned char, int>> children;
+		int fail = 0;
+		// nearest node (this or through fail links) which ends a pattern
+		int output = no_node;
+		bool is_terminal = false;
+	};
+
+	int child(int parent, unsigned char c) const
+	{
+		const auto& children = nodes[parent].children;
+		const auto it = std::lower_bound(children.begin(), children.end(), c,
+			[](const std::pair<unsigned char, int>& edge, unsigned char ch) { return edge.first < ch; });
+
+		if (it == children.end() || it->first != c)
+			return no_node;
+
+		return it->second;
+	}
+
+	void insert(const std::string& pattern)
+	{
+		int current = 0;
+		for (char ch : pattern) {
+			const auto c = static_cast<unsigned char>(ch);
+			int next = child(current, c);
+			if (next == no_node) {
+				next = static_cast<int>(nodes.size());
+				// patterns are sorted, so a new child is always the last one
+				nodes[current].children.emplace_back(c, next);
+				nodes.emplace_back();
+			}
+
+			current = next;
+		}
+
+		nodes[current].is_terminal = true;
+	}
+
+	// breadth-first, so fail links always point to already processed nodes
+	void build_links()
+	{
+		std::vector<int> queue;
+		queue.push_back(0);
+		nodes[0].output = nodes[0].is_terminal ? 0 : no_node;
+
+		for (std::size_t front = 0; front < queue.size(); ++front) {
+			const int current = queue[front];
+
+			for (const auto& [c, next] : nodes[current].children) {
+				nodes[next].fail = current == 0 ? 0 : next_state(nodes[current].fail, c);
+				nodes[next].output = nodes[next].is_terminal ? next : nodes[nodes[next].fail].output;
+				queue.push_back(next);
+			}
+		}
+	}
+
+	int next_state(int state, unsigned char c) const
+	{
+		while (true) {
+			if (const int next = child(state, c); next != no_node)
+				return next;
+
+			if (state == 0)
+				return 0;
+
+			state = nodes[state].fail;
+		}
+	}
+
+	std::vector<node> nodes;
+};
+
+}
+
+namespace fs::utility
+{
+
+void minimize_substring_patterns(std::vector<std::string>& patterns)
+{
+	std::sort(patterns.begin(), patterns.end());
+	patterns.erase(std::unique(patterns.begin(), patterns.end()), patterns.end());
+
+	if (patterns.size() < 2)
+		return;
+
+	const pattern_automaton automaton(patterns);
+	patterns.erase(
+		std::remove_if(patterns.begin(), patterns.end(), [&](const std::string& pattern) {
+			return automaton.contains_other_pattern(pattern);
+		}),
+		patterns.end());
+}
+
+}
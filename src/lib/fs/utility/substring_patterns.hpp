@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace fs::utility
+{
+
+/**
+ * @brief minimal equivalent list of substring patterns
+ *
+ * @details For patterns that match any text containing them: sorts the
+ * list, removes duplicates and every pattern which contains another
+ * pattern of the list (whatever contains "Sapphire Ring" also contains
+ * "Ring"). The result matches exactly the same texts.
+ *
+ * Complexity: O(n log n) comparisons for sorting plus linear in the total
+ * length of patterns (times log of alphabet size) - all patterns are
+ * searched at once with an Aho-Corasick automaton.
+ */
+void minimize_substring_patterns(std::vector<std::string>& patterns);
+
+}
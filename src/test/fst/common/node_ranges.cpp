@@ -0,0 +1,38 @@
+#include <fst/common/node_ranges.hpp>
+
+#include <fs/parser/for_each_node.hpp>
+
+#include <string_view>
+
+namespace fst
+{
+
+bool operator==(node_range lhs, node_range rhs)
+{
+	return lhs.offset == rhs.offset && lhs.length == rhs.length;
+}
+
+std::ostream& operator<<(std::ostream& os, node_range range)
+{
+	return os << "(" << range.offset << ", " << range.length << ")";
+}
+
+std::vector<node_range> ranges_of_all_nodes(const fs::parser::parse_success_data& parse_data)
+{
+	const char* const input_first = parse_data.lookup_data.get_view_of_whole_content().data();
+	std::vector<node_range> result;
+	auto collect = [&](const boost::spirit::x3::position_tagged& node) {
+		// some nodes are not annotated by the grammar
+		if (node.id_first < 0) {
+			result.push_back(node_range{-1, -1});
+			return;
+		}
+
+		const std::string_view view = parse_data.lookup_data.position_of(node);
+		result.push_back(node_range{view.data() - input_first, static_cast<std::ptrdiff_t>(view.size())});
+	};
+	fs::parser::for_each_node(parse_data.ast, collect);
+	return result;
+}
+
+}
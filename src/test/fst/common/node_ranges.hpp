@@ -0,0 +1,26 @@
+#pragma once
+
+#include <fs/parser/parser.hpp>
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace fst
+{
+
+struct node_range
+{
+	std::ptrdiff_t offset; // from the beginning of the input, -1 if the node has not been annotated
+	std::ptrdiff_t length;
+};
+
+bool operator==(node_range lhs, node_range rhs);
+std::ostream& operator<<(std::ostream& os, node_range range);
+
+// ranges of all AST nodes, in traversal order - captures both the structure
+// and the text the nodes were parsed from; can be used to compare parse results
+[[nodiscard]]
+std::vector<node_range> ranges_of_all_nodes(const fs::parser::parse_success_data& parse_data);
+
+}
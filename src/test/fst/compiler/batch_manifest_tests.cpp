@@ -0,0 +1,152 @@
+#include <fs/generator/batch_manifest.hpp>
+#include <fs/generator/output_sink.hpp>
+#include <fs/log/buffered_logger.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem/path.hpp>
+
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ut = boost::unit_test;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+
+using fs::generator::batch_manifest;
+using fs::generator::output_status;
+
+const bfs::path manifest_directory = "batch/dir";
+
+std::optional<batch_manifest> parse(std::string_view content, std::string& log)
+{
+	fs::log::buffered_logger logger;
+	std::optional<batch_manifest> result = fs::generator::parse_batch_manifest(content, manifest_directory, logger);
+	log = logger.flush_out();
+	return result;
+}
+
+// the status of a batch of outputs, as reported for all of them
+output_status combine_all(std::initializer_list<output_status> statuses)
+{
+	output_status result = output_status::unchanged;
+	for (output_status status : statuses)
+		result = combine(result, status);
+
+	return result;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(batch_manifest_suite)
+
+	BOOST_AUTO_TEST_CASE(valid_manifest, * ut::description("test that data sources and jobs are read with paths relative to the manifest"))
+	{
+		std::string log;
+		const std::optional<batch_manifest> manifest = parse(R"({
+			"data": {
+				"sc":  { "download": "poe.ninja", "league": "Metamorph" },
+				"hc":  { "download": "poe.watch", "league": "Hardcore Metamorph" },
+				"old": { "read": "saved_data" },
+				"ssf": { "empty": true }
+			},
+			"jobs": [
+				{ "template": "filter.fs", "data": "sc", "output": "out/sc.filter" },
+				{ "template": "other/filter.fs", "data": "ssf", "output": "ssf.filter" }
+			]
+		})", log);
+		BOOST_TEST_REQUIRE(manifest.has_value(), log);
+
+		BOOST_TEST_REQUIRE(manifest->data_sources.size() == 4u);
+		BOOST_TEST(manifest->data_sources.at("sc").download_league_name_ninja.value_or("") == "Metamorph");
+		BOOST_TEST(!manifest->data_sources.at("sc").download_league_name_watch);
+		BOOST_TEST(manifest->data_sources.at("hc").download_league_name_watch.value_or("") == "Hardcore Metamorph");
+		BOOST_TEST(manifest->data_sources.at("old").data_read_dir.value_or("") == (manifest_directory / "saved_data").generic_string());
+		BOOST_TEST(manifest->data_sources.at("ssf").empty);
+
+		BOOST_TEST_REQUIRE(manifest->jobs.size() == 2u);
+		BOOST_TEST(manifest->jobs[0].template_path == manifest_directory / "filter.fs");
+		BOOST_TEST(manifest->jobs[0].data_name == "sc");
+		BOOST_TEST(manifest->jobs[0].output_path == manifest_directory / "out/sc.filter");
+		BOOST_TEST(manifest->jobs[1].template_path == manifest_directory / "other/filter.fs");
+		BOOST_TEST(manifest->jobs[1].data_name == "ssf");
+		BOOST_TEST(manifest->jobs[1].output_path == manifest_directory / "ssf.filter");
+	}
+
+	BOOST_AUTO_TEST_CASE(data_source_without_way_of_obtaining_data)
+	{
+		std::string log;
+		const std::optional<batch_manifest> manifest = parse(R"({
+			"data": { "sc": { "league": "Metamorph" } },
+			"jobs": []
+		})", log);
+		BOOST_TEST(!manifest.has_value());
+		BOOST_TEST(log.find("exactly 1 of: download, read, empty") != std::string::npos, log);
+	}
+
+	BOOST_AUTO_TEST_CASE(data_source_with_multiple_ways_of_obtaining_data)
+	{
+		std::string log;
+		const std::optional<batch_manifest> manifest = parse(R"({
+			"data": { "sc": { "download": "poe.ninja", "league": "Metamorph", "read": "saved_data" } },
+			"jobs": []
+		})", log);
+		BOOST_TEST(!manifest.has_value());
+		BOOST_TEST(log.find("exactly 1 of: download, read, empty") != std::string::npos, log);
+	}
+
+	BOOST_AUTO_TEST_CASE(unknown_api)
+	{
+		std::string log;
+		const std::optional<batch_manifest> manifest = parse(R"({
+			"data": { "sc": { "download": "example.com", "league": "Metamorph" } },
+			"jobs": []
+		})", log);
+		BOOST_TEST(!manifest.has_value());
+		BOOST_TEST(log.find("unknown API") != std::string::npos, log);
+	}
+
+	BOOST_AUTO_TEST_CASE(undefined_data_source)
+	{
+		std::string log;
+		const std::optional<batch_manifest> manifest = parse(R"({
+			"data": { "sc": { "empty": true } },
+			"jobs": [
+				{ "template": "filter.fs", "data": "sc", "output": "sc.filter" },
+				{ "template": "filter.fs", "data": "hc", "output": "hc.filter" }
+			]
+		})", log);
+		BOOST_TEST(!manifest.has_value());
+		BOOST_TEST(log.find("job 2 uses undefined data source hc") != std::string::npos, log);
+	}
+
+	BOOST_AUTO_TEST_CASE(missing_key_and_invalid_json)
+	{
+		std::string log;
+		BOOST_TEST(!parse(R"({ "data": {} })", log).has_value());
+		BOOST_TEST(log.find("invalid batch manifest") != std::string::npos, log);
+
+		BOOST_TEST(!parse(R"({ "data": {}, "jobs": [ { "template": "filter.fs", "data": "sc" } ] })", log).has_value());
+		BOOST_TEST(log.find("invalid batch manifest") != std::string::npos, log);
+
+		BOOST_TEST(!parse(R"({ "data": )", log).has_value());
+		BOOST_TEST(log.find("invalid batch manifest") != std::string::npos, log);
+	}
+
+	BOOST_AUTO_TEST_CASE(combined_status, * ut::description("test that a batch fails if any output failed and is unchanged only if all outputs were"))
+	{
+		BOOST_TEST((combine_all({}) == output_status::unchanged));
+		BOOST_TEST((combine_all({output_status::unchanged, output_status::unchanged}) == output_status::unchanged));
+		BOOST_TEST((combine_all({output_status::unchanged, output_status::written}) == output_status::written));
+		BOOST_TEST((combine_all({output_status::written, output_status::unchanged}) == output_status::written));
+		BOOST_TEST((combine_all({output_status::written, output_status::failed, output_status::unchanged}) == output_status::failed));
+		BOOST_TEST((combine_all({output_status::failed, output_status::written}) == output_status::failed));
+		BOOST_TEST((combine_all({output_status::unchanged, output_status::failed}) == output_status::failed));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 #include <fst/common/test_fixtures.hpp>
 #include <fst/common/string_operations.hpp>
 
+#include <fs/compiler/build_filter_blocks.hpp>
 #include <fs/compiler/print_error.hpp>
 #include <fs/compiler/resolve_symbols.hpp>
 #include <fs/log/buffered_logger.hpp>
@@ -148,6 +149,62 @@ xyz = non_existent_obj
 			BOOST_TEST(compare_ranges(expected_place_of_name, reported_place_of_name, input));
 		}
 
+		BOOST_AUTO_TEST_CASE(errors_in_order_of_definitions,
+			* ut::description("test that evaluating definitions in parallel reports the same error as evaluating them in order"))
+		{
+			const std::string input_str = minimal_input() + R"(
+a = 1
+b = a
+c = missing_name
+d = b
+a = 2
+)";
+			const std::string_view input = input_str;
+			const fs::parser::parse_success_data parse_data = parse(input);
+
+			for (unsigned num_threads : {1u, 4u}) {
+				fs::compiler::symbol_references references;
+				const std::variant<fs::lang::symbol_table, fs::compiler::compile_error> symbols_or_error =
+					fs::compiler::resolve_symbols(parse_data.ast.definitions, {}, {}, references, num_threads);
+				BOOST_TEST_REQUIRE(std::holds_alternative<fs::compiler::compile_error>(symbols_or_error));
+				const auto& error_desc = expect_error_of_type<errors::no_such_name>(
+					std::get<fs::compiler::compile_error>(symbols_or_error), parse_data.lookup_data);
+
+				const std::string_view expected_place_of_name = search(input, "missing_name");
+				const std::string_view reported_place_of_name = parse_data.lookup_data.position_of(error_desc.place_of_name);
+				BOOST_TEST(compare_ranges(expected_place_of_name, reported_place_of_name, input));
+			}
+		}
+
+		BOOST_AUTO_TEST_CASE(first_error_in_parallel_blocks,
+			* ut::description("test that compiling top-level blocks in parallel reports the first error in source order"))
+		{
+			const std::string input_str = minimal_input() + R"(
+Quality > 0 { Show }
+Quality > first_missing { Show }
+Quality > 2 { SetFontSize second_missing Show }
+SetTextColor third_missing
+Quality > 4 { SetFontSize fourth_missing Show }
+)";
+			const std::string_view input = input_str;
+			const fs::parser::parse_success_data parse_data = parse(input);
+			const fs::lang::symbol_table symbols;
+
+			for (unsigned num_threads : {1u, 4u}) {
+				fs::compiler::symbol_references references;
+				fs::compiler::resolve_references(parse_data.ast.statements, symbols, references);
+				std::variant<std::vector<fs::lang::filter_block>, fs::compiler::compile_error> result =
+					fs::compiler::build_filter_blocks(parse_data.ast.statements, symbols, references, {}, num_threads);
+				BOOST_TEST_REQUIRE(std::holds_alternative<fs::compiler::compile_error>(result));
+				const auto& error_desc = expect_error_of_type<errors::no_such_name>(
+					std::get<fs::compiler::compile_error>(result), parse_data.lookup_data);
+
+				const std::string_view expected_place_of_name = search(input, "first_missing");
+				const std::string_view reported_place_of_name = parse_data.lookup_data.position_of(error_desc.place_of_name);
+				BOOST_TEST(compare_ranges(expected_place_of_name, reported_place_of_name, input));
+			}
+		}
+
 		BOOST_AUTO_TEST_CASE(no_such_function)
 		{
 			const std::string input_str = minimal_input() + R"(
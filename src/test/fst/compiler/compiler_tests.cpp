@@ -4,7 +4,10 @@
 
 #include <fs/compiler/build_filter_blocks.hpp>
 #include <fs/compiler/resolve_symbols.hpp>
+#include <fs/compiler/symbol_references.hpp>
+#include <fs/compiler/query_cache.hpp>
 #include <fs/compiler/print_error.hpp>
+#include <fs/compiler/unreachable_blocks.hpp>
 #include <fs/lang/position_tag.hpp>
 #include <fs/log/buffered_logger.hpp>
 #include <fs/utility/visitor.hpp>
@@ -234,6 +237,353 @@ elem = [1, 2, 3][1]
 				lang::integer{2}, search(input, "elem"), search(input, "[1]"));
 		}
 
+		BOOST_AUTO_TEST_CASE(shared_values, * ut::description("test that referencing a name does not copy arrays and compound actions"))
+		{
+			const std::string input_str = minimal_input() + R"(
+arr = ["Orb", "Shard"]
+arr_ref = arr
+style = { SetFontSize 40 }
+style_ref = style
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const parser::lookup_data& lookup_data = parse_data.lookup_data;
+			const lang::symbol_table symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, lookup_data);
+
+			const lang::object& arr = symbols.at("arr").object_instance;
+			const lang::object& arr_ref = symbols.at("arr_ref").object_instance;
+			BOOST_TEST_REQUIRE(arr_ref.is_array());
+			BOOST_TEST(std::get<lang::array_object>(arr_ref.value).shares_elements_with(std::get<lang::array_object>(arr.value)));
+			// origins are not shared
+			BOOST_TEST(compare_ranges(search(input, "arr_ref = arr").substr(10), lookup_data.position_of(arr_ref.value_origin), input));
+
+			const lang::object& style = symbols.at("style").object_instance;
+			const lang::object& style_ref = symbols.at("style_ref").object_instance;
+			BOOST_TEST_REQUIRE(style_ref.is_compound_action());
+			BOOST_TEST(std::get<lang::action_set_object>(style_ref.value).shares_value_with(std::get<lang::action_set_object>(style.value)));
+		}
+
+		BOOST_AUTO_TEST_CASE(query_cache, * ut::description("test that repeated price queries are evaluated once"))
+		{
+			const std::string input_str = minimal_input() + R"(
+a = $divination(5, _)
+b = $divination(5, _)
+c = $divination(6, _)
+d = $uniques_eq_unambiguous(5, _)
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			lang::item_price_data ipd;
+			ipd.divination_cards.push_back(lang::divination_card{lang::price_data{5, false}, "Humility", 9});
+			ipd.divination_cards.push_back(lang::divination_card{lang::price_data{10, false}, "A Dab of Ink", 9});
+
+			compiler::symbol_references references;
+			compiler::query_cache queries;
+			std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = compiler::resolve_symbols(
+				parse_data.ast.definitions, ipd, lang::symbol_table{}, references, 1, &queries);
+			BOOST_TEST_REQUIRE(std::holds_alternative<lang::symbol_table>(symbols_or_error));
+			const auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+
+			BOOST_TEST(queries.get_statistics().hits == 1u);
+			BOOST_TEST(queries.get_statistics().misses == 3u);
+
+			const lang::object& a = symbols.at("a").object_instance;
+			const lang::object& b = symbols.at("b").object_instance;
+			const lang::object& c = symbols.at("c").object_instance;
+			BOOST_TEST_REQUIRE(a.is_array());
+			BOOST_TEST_REQUIRE(b.is_array());
+			BOOST_TEST_REQUIRE(c.is_array());
+			BOOST_TEST(std::get<lang::array_object>(a.value).size() == 2u);
+			BOOST_TEST(std::get<lang::array_object>(c.value).size() == 1u);
+			// different places share the same array
+			BOOST_TEST(std::get<lang::array_object>(b.value).shares_elements_with(std::get<lang::array_object>(a.value)));
+			// each use has its own origin
+			const std::string_view query_b = search(input, "b = $divination(5, _)").substr(4);
+			BOOST_TEST(compare_ranges(query_b, parse_data.lookup_data.position_of(b.value_origin), input));
+			// elements have none, diagnostics use the origin of the array
+			for (const lang::object& element : std::get<lang::array_object>(b.value))
+				BOOST_TEST(element.value_origin.id_first < 0);
+		}
+
+		BOOST_AUTO_TEST_CASE(lazy_definitions, * ut::description("test that only definitions used by statements are evaluated"))
+		{
+			const std::string input_str = minimal_input() + R"(
+a = $divination(0, _)
+b = a
+c = $divination(5, _)
+d = c
+SetFontSize 40
+BaseType b
+{
+	Show
+}
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+
+			compiler::symbol_references references;
+			compiler::query_cache queries;
+			std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = compiler::resolve_symbols_used_by(
+				parse_data.ast.definitions, parse_data.ast.statements, lang::item_price_data{}, lang::symbol_table{}, references, 1, &queries);
+			BOOST_TEST_REQUIRE(std::holds_alternative<lang::symbol_table>(symbols_or_error));
+			const auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+
+			BOOST_TEST(symbols.size() == 4u);
+			BOOST_TEST(symbols.at("a").object_instance.is_array());
+			BOOST_TEST(symbols.at("b").object_instance.is_array());
+			BOOST_TEST(std::holds_alternative<lang::none>(symbols.at("c").object_instance.value));
+			BOOST_TEST(std::holds_alternative<lang::none>(symbols.at("d").object_instance.value));
+			BOOST_TEST(queries.get_statistics().misses == 1u);
+			// references of statements are resolved too
+			BOOST_TEST(references.use_count(symbols.id_of("b")) == 1);
+			const std::vector<lang::symbol_id> unused = compiler::find_unused_symbols(symbols, references);
+			BOOST_TEST_REQUIRE(unused.size() == 1u);
+			BOOST_TEST(symbols[unused[0]].first == "d");
+		}
+
+		BOOST_AUTO_TEST_CASE(symbol_references, * ut::description("test that identifiers are resolved to IDs and unused names are found"))
+		{
+			const std::string input_str = minimal_input() + R"(
+a = 1
+RGB = 2
+unused = a
+b = RGB(a, a, 3)
+SetTextColor b
+Show
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const parser::lookup_data& lookup_data = parse_data.lookup_data;
+
+			compiler::symbol_references references;
+			std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = compiler::resolve_symbols(
+				parse_data.ast.definitions, lang::item_price_data{}, lang::symbol_table{}, references);
+			BOOST_TEST_REQUIRE(std::holds_alternative<lang::symbol_table>(symbols_or_error));
+			const auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+			compiler::resolve_references(parse_data.ast.statements, symbols, references);
+			(void) expect_success_when_building_filter(parse_data.ast.statements, lookup_data, symbols);
+
+			// IDs follow order of definitions
+			BOOST_TEST(symbols.id_of("a") == 0);
+			BOOST_TEST(symbols.id_of("b") == 3);
+			BOOST_TEST(symbols.id_of("nothing") == lang::invalid_symbol_id);
+			BOOST_TEST(symbols[3].first == "b");
+
+			BOOST_TEST(references.use_count(symbols.id_of("a")) == 3);
+			BOOST_TEST(references.use_count(symbols.id_of("b")) == 1);
+			// function names are not references
+			const std::vector<lang::symbol_id> unused = compiler::find_unused_symbols(symbols, references);
+			BOOST_TEST_REQUIRE(unused.size() == 2u);
+			BOOST_TEST(symbols[unused[0]].first == "RGB");
+			BOOST_TEST(symbols[unused[1]].first == "unused");
+			BOOST_TEST(compiler::find_unused_symbols(symbols, references, 2).size() == 1u);
+		}
+
+		BOOST_AUTO_TEST_CASE(parallel_definitions, * ut::description("test that definitions evaluated in parallel keep their order and values"))
+		{
+			const std::string input_str = minimal_input() + R"(
+a = 1
+b = [a, 2]
+c = 3
+d = [c, a]
+e = d[0]
+f = c
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const lang::symbol_table expected_symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, parse_data.lookup_data);
+
+			compiler::symbol_references references;
+			std::variant<lang::symbol_table, compiler::compile_error> symbols_or_error = compiler::resolve_symbols(
+				parse_data.ast.definitions, lang::item_price_data{}, lang::symbol_table{}, references, 4);
+			BOOST_TEST_REQUIRE(std::holds_alternative<lang::symbol_table>(symbols_or_error));
+			const auto& symbols = std::get<lang::symbol_table>(symbols_or_error);
+
+			BOOST_TEST_REQUIRE(symbols.size() == expected_symbols.size());
+			for (lang::symbol_id id = 0; id < static_cast<lang::symbol_id>(symbols.size()); ++id) {
+				BOOST_TEST(symbols[id].first == expected_symbols[id].first);
+				BOOST_TEST((symbols[id].second.object_instance == expected_symbols[id].second.object_instance));
+			}
+
+			BOOST_TEST(symbols.id_of("f") == 5);
+			BOOST_TEST((symbols.at("e").object_instance == symbols.at("c").object_instance));
+		}
+
+		BOOST_AUTO_TEST_CASE(scalar_actions, * ut::description("test that scalar values are evaluated through names, promotions and constructor overloads"))
+		{
+			const std::string input_str = minimal_input() + R"(
+red = 255
+size = 40
+icon_size = 1
+beam = Beam(Yellow, True)
+ItemLevel Level(icon_size) {
+	SetTextColor RGB(red, 0, 0, red)
+	SetBorderColor RGB(red, red, 0)
+	SetFontSize size
+	SetMinimapIcon MinimapIcon(icon_size, Red, Circle)
+	SetBeam beam
+	Show
+	SetFontSize FontSize(size)
+	SetBeam Blue
+	Show
+}
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const lang::symbol_table symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, parse_data.lookup_data);
+			const std::vector<lang::filter_block> blocks =
+				expect_success_when_building_filter(parse_data.ast.statements, parse_data.lookup_data, symbols);
+			BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 2);
+
+			const lang::action_set& first = *blocks[0].actions;
+			BOOST_TEST_REQUIRE(first.text_color.has_value());
+			BOOST_TEST((*first.text_color == lang::color(255, 0, 0, 255)));
+			BOOST_TEST_REQUIRE(first.border_color.has_value());
+			BOOST_TEST((*first.border_color == lang::color(255, 255, 0)));
+			BOOST_TEST_REQUIRE(first.font_size.has_value());
+			BOOST_TEST(first.font_size->value == 40);
+			BOOST_TEST_REQUIRE(first.minimap_icon.has_value());
+			BOOST_TEST((*first.minimap_icon == lang::minimap_icon(1, lang::suit::red, lang::shape::circle)));
+			BOOST_TEST_REQUIRE(first.beam_effect.has_value());
+			BOOST_TEST((*first.beam_effect == lang::beam_effect(lang::suit::yellow, lang::boolean{true})));
+			BOOST_TEST(blocks[0].conditions->item_level.includes(1));
+
+			const lang::action_set& second = *blocks[1].actions;
+			BOOST_TEST_REQUIRE(second.font_size.has_value());
+			BOOST_TEST(second.font_size->value == 40);
+			BOOST_TEST_REQUIRE(second.beam_effect.has_value());
+			BOOST_TEST((*second.beam_effect == lang::beam_effect(lang::suit::blue)));
+		}
+
+		BOOST_AUTO_TEST_CASE(shared_block_sets, * ut::description("test that blocks share unchanged conditions and actions"))
+		{
+			const std::string input_str = minimal_input() + R"(
+ItemLevel 10
+{
+	SetFontSize 40
+	Show
+	Hide
+	SetBeam Green
+	Show
+	Quality 20
+	{
+		Show
+	}
+}
+Show
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const lang::symbol_table symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, parse_data.lookup_data);
+			const std::vector<lang::filter_block> blocks =
+				expect_success_when_building_filter(parse_data.ast.statements, parse_data.lookup_data, symbols);
+			BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 5);
+
+			BOOST_TEST(blocks[0].conditions.shares_value_with(blocks[1].conditions));
+			BOOST_TEST(blocks[0].actions.shares_value_with(blocks[1].actions));
+			BOOST_TEST(blocks[0].conditions.shares_value_with(blocks[2].conditions));
+			BOOST_TEST(!blocks[0].actions.shares_value_with(blocks[2].actions));
+			BOOST_TEST(!blocks[2].conditions.shares_value_with(blocks[3].conditions));
+			BOOST_TEST(blocks[2].actions.shares_value_with(blocks[3].actions));
+
+			// later modifications must not leak into already emitted blocks
+			BOOST_TEST(!blocks[0].actions->beam_effect.has_value());
+			BOOST_TEST(blocks[2].actions->beam_effect.has_value());
+			BOOST_TEST(!blocks[2].conditions->quality.has_anything());
+			BOOST_TEST(blocks[3].conditions->quality.is_exact());
+			BOOST_TEST(blocks[3].conditions->item_level.includes(10));
+			BOOST_TEST(!blocks[4].actions->font_size.has_value());
+			BOOST_TEST(!blocks[4].conditions->item_level.has_anything());
+		}
+
+		BOOST_AUTO_TEST_CASE(interned_block_values, * ut::description("test that equal actions and string lists of unrelated blocks are deduplicated"))
+		{
+			const std::string input_str = minimal_input() + R"(
+ItemLevel 10 BaseType ["Vaal Regalia", "Sorcerer Boots"] {
+	SetFontSize 42
+	Show
+}
+Quality 20 BaseType ["Vaal Regalia", "Sorcerer Boots"] {
+	SetFontSize 42
+	Show
+}
+BaseType "Vaal Regalia" {
+	SetFontSize 40
+	Show
+}
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const lang::symbol_table symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, parse_data.lookup_data);
+			const std::vector<lang::filter_block> blocks =
+				expect_success_when_building_filter(parse_data.ast.statements, parse_data.lookup_data, symbols);
+			BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 3);
+
+			BOOST_TEST(blocks[0].actions.shares_value_with(blocks[1].actions));
+			BOOST_TEST(!blocks[0].actions.shares_value_with(blocks[2].actions));
+
+			BOOST_TEST(!blocks[0].conditions.shares_value_with(blocks[1].conditions));
+			BOOST_TEST_REQUIRE(blocks[0].conditions->base_type.strings != nullptr);
+			BOOST_TEST(blocks[0].conditions->base_type.strings == blocks[1].conditions->base_type.strings);
+			BOOST_TEST(blocks[0].conditions->base_type.strings != blocks[2].conditions->base_type.strings);
+			BOOST_TEST(blocks[1].conditions->quality.is_exact());
+			BOOST_TEST(blocks[0].conditions->item_level.includes(10));
+		}
+
+		BOOST_AUTO_TEST_CASE(unreachable_blocks, * ut::description("test that blocks shadowed by earlier blocks are found"))
+		{
+			const std::string input_str = minimal_input() + R"(
+Quality > 10 BaseType ["Ring", "Amulet"] {
+	Show
+	Hide
+}
+Quality >= 15 Corrupted True BaseType ["Gold Ring", "Onyx Amulet"] {
+	Show
+}
+Quality >= 10 BaseType "Ring" {
+	Show
+}
+BaseType == ["Gold Ring", "Ruby Ring"] {
+	Show
+}
+BaseType == ["Gold Ring"] {
+	Show
+}
+Hide
+Show
+)";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const lang::symbol_table symbols = expect_success_when_resolving_symbols(parse_data.ast.definitions, parse_data.lookup_data);
+			std::vector<lang::filter_block> blocks =
+				expect_success_when_building_filter(parse_data.ast.statements, parse_data.lookup_data, symbols);
+			BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 8);
+
+			const std::vector<compiler::unreachable_block> unreachable = compiler::find_unreachable_blocks(blocks);
+			BOOST_TEST_REQUIRE(static_cast<int>(unreachable.size()) == 4);
+			// same scope
+			BOOST_TEST(unreachable[0].index == 1u);
+			BOOST_TEST(unreachable[0].shadowed_by == 0u);
+			// tighter range, extra condition and substrings
+			BOOST_TEST(unreachable[1].index == 2u);
+			BOOST_TEST(unreachable[1].shadowed_by == 0u);
+			// exact list which is a subset of an earlier exact list
+			BOOST_TEST(unreachable[2].index == 5u);
+			BOOST_TEST(unreachable[2].shadowed_by == 4u);
+			// everything after a block without conditions
+			BOOST_TEST(unreachable[3].index == 7u);
+			BOOST_TEST(unreachable[3].shadowed_by == 6u);
+
+			const std::string_view origin = parse_data.lookup_data.position_of(blocks[7].origin);
+			BOOST_TEST(origin == "Show");
+
+			compiler::remove_unreachable_blocks(blocks, unreachable);
+			BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 4);
+			BOOST_TEST(blocks[0].show);
+			BOOST_TEST(blocks[1].conditions->quality.lower_bound->inclusive);
+			BOOST_TEST(!blocks[3].show);
+		}
+
 		BOOST_AUTO_TEST_CASE(promotions)
 		{
 			const std::string input_str = minimal_input() + R"(
@@ -259,7 +609,7 @@ Show
 			const lang::filter_block& b0 = blocks[0];
 			BOOST_TEST(b0.show == false);
 
-			const lang::condition_set& b0_cond = b0.conditions;
+			const lang::condition_set& b0_cond = *b0.conditions;
 			BOOST_TEST(b0_cond.item_level.is_exact());
 			BOOST_TEST(b0_cond.item_level.includes(10));
 			if (b0_cond.socket_group.has_value())
@@ -276,7 +626,7 @@ Show
 				BOOST_ERROR("block 0 has no socket group but it should have");
 			}
 
-			const lang::action_set& b0_act = b0.actions;
+			const lang::action_set& b0_act = *b0.actions;
 			if (b0_act.beam_effect.has_value())
 			{
 				BOOST_TEST((*b0_act.beam_effect).color == lang::suit::green);
@@ -290,7 +640,7 @@ Show
 			const lang::filter_block& b1 = blocks[1];
 			BOOST_TEST(b1.show == true);
 
-			const lang::action_set& b1_act = b1.actions;
+			const lang::action_set& b1_act = *b1.actions;
 			if (b1_act.alert_sound.has_value())
 			{
 				if (std::holds_alternative<lang::custom_alert_sound>((*b1_act.alert_sound).sound))
@@ -354,7 +704,7 @@ Show
 				BOOST_TEST_REQUIRE(static_cast<int>(blocks.size()) == 1);
 				const lang::filter_block& block = blocks[0];
 				BOOST_TEST(block.show == true);
-				const std::optional<lang::alert_sound>& maybe_alert_sound = block.actions.alert_sound;
+				const std::optional<lang::alert_sound>& maybe_alert_sound = block.actions->alert_sound;
 				BOOST_TEST_REQUIRE(maybe_alert_sound.has_value());
 				const lang::alert_sound& alert_sound = *maybe_alert_sound;
 				test_alert_sound(expected_value, alert_sound);
@@ -1,25 +1,34 @@
 #include <fst/common/test_fixtures.hpp>
 #include <fst/common/string_operations.hpp>
 
+#include <fs/generator/generator.hpp>
 #include <fs/generator/generate_filter.hpp>
+#include <fs/generator/output_sink.hpp>
 #include <fs/log/buffered_logger.hpp>
 #include <fs/lang/item_price_data.hpp>
+#include <fs/lang/item_price_metadata.hpp>
+#include <fs/utility/file.hpp>
 
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <boost/filesystem/operations.hpp>
+
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <vector>
 
 namespace ut = boost::unit_test;
 namespace tt = boost::test_tools;
 
 std::string generate_filter(
 	std::string_view input,
-	const fs::lang::item_price_data& ipd = {})
+	const fs::lang::item_price_data& ipd = {},
+	fs::generator::options options = {})
 {
 	fs::log::buffered_logger logger;
-	std::optional<std::string> filter = fs::generator::generate_filter_without_preamble(input, ipd, fs::generator::options{}, logger);
+	std::optional<std::string> filter = fs::generator::generate_filter_without_preamble(input, ipd, options, logger);
 	const auto log_data = logger.flush_out();
 	BOOST_TEST_REQUIRE(filter.has_value(), "filter generation failed:\n" << log_data);
 	return *filter;
@@ -403,6 +412,393 @@ Hide
 Show
 	SetBackgroundColor 0 0 0
 
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+		}
+
+		BOOST_AUTO_TEST_CASE(parallel_top_level_blocks,
+			* ut::description("test that top-level blocks compiled on multiple threads see preceding top-level actions"))
+		{
+			fs::generator::options options;
+			options.num_threads = 4;
+			const std::string actual_filter = generate_filter(minimal_input() + R"(
+SetFontSize 30
+Quality > 0 { Show }
+Quality > 1 {
+	SetFontSize 31
+	Show
+}
+SetFontSize 32
+Hide
+Quality > 2 { Show }
+Show
+)", {}, options);
+			const std::string_view expected_filter =
+R"(Show
+	Quality > 0
+	SetFontSize 30
+
+Show
+	Quality > 1
+	SetFontSize 31
+
+Hide
+	SetFontSize 32
+
+Show
+	Quality > 2
+	SetFontSize 32
+
+Show
+	SetFontSize 32
+
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+		}
+
+		BOOST_AUTO_TEST_CASE(query_categories, * ut::description("test that each query reads its own category of items"))
+		{
+			fs::lang::item_price_data ipd;
+			ipd.essences.push_back(fs::lang::elementary_item{fs::lang::price_data{1, false}, "Deafening Essence of Greed"});
+			ipd.prophecies.push_back(fs::lang::elementary_item{fs::lang::price_data{1, false}, "The Queen's Sacrifice"});
+			ipd.unique_maps.add_item("Underground River Map", fs::lang::elementary_item{fs::lang::price_data{1, false}, "Caer Blaidd, Wolfpack's Den"});
+			const std::string actual_filter = generate_filter(minimal_input() + R"(
+BaseType $essences(0, _) { Show }
+BaseType $prophecies(0, _) { Show }
+BaseType $uniques_map_unambiguous(0, _) { Show }
+)", ipd);
+			const std::string_view expected_filter =
+R"(Show
+	BaseType "Deafening Essence of Greed"
+
+Show
+	BaseType "The Queen's Sacrifice"
+
+Show
+	BaseType "Underground River Map"
+
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+		}
+
+		BOOST_AUTO_TEST_CASE(oils_and_incubators_queries,
+			* ut::description("test that $oils and $incubators return oils and incubators, not prophecies"))
+		{
+			fs::lang::item_price_data ipd;
+			ipd.oils.push_back(fs::lang::elementary_item{fs::lang::price_data{1, false}, "Golden Oil"});
+			ipd.incubators.push_back(fs::lang::elementary_item{fs::lang::price_data{1, false}, "Gemcutter's Incubator"});
+			ipd.prophecies.push_back(fs::lang::elementary_item{fs::lang::price_data{1, false}, "The Queen's Sacrifice"});
+			const std::string actual_filter = generate_filter(minimal_input() + R"(
+BaseType $oils(0, _) { Show }
+BaseType $incubators(0, _) { Show }
+)", ipd);
+			const std::string_view expected_filter =
+R"(Show
+	BaseType "Golden Oil"
+
+Show
+	BaseType "Gemcutter's Incubator"
+
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+		}
+
+		BOOST_AUTO_TEST_CASE(unused_definitions,
+			* ut::description("test that unused definitions are evaluated only in strict mode"))
+		{
+			const std::string input = minimal_input() + R"(
+broken = RGB(1, 2)
+also_broken = [broken, broken]
+used = 10
+Quality > used { Show }
+)";
+			const std::string actual_filter = generate_filter(input);
+			const std::string_view expected_filter =
+R"(Show
+	Quality > 10
+
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+
+			fs::generator::options options;
+			options.strict = true;
+			fs::log::buffered_logger logger;
+			const std::optional<std::string> strict_filter =
+				fs::generator::generate_filter_without_preamble(input, {}, options, logger);
+			BOOST_TEST(!strict_filter.has_value());
+		}
+
+		BOOST_AUTO_TEST_CASE(unused_definition_warnings,
+			* ut::description("test that unused definitions are reported only when requested"))
+		{
+			const std::string input = minimal_input() + R"(
+unused = 1
+used = 10
+Quality > used { Show }
+)";
+			const auto generation_log = [&](const fs::generator::options& options) {
+				fs::log::buffered_logger logger;
+				BOOST_TEST(fs::generator::generate_filter_without_preamble(input, {}, options, logger).has_value());
+				return logger.flush_out();
+			};
+
+			fs::generator::options options;
+			BOOST_TEST(generation_log(options).find("unused definition") == std::string::npos);
+
+			options.warn_unused_definitions = true;
+			const std::string log = generation_log(options);
+			BOOST_TEST(log.find("unused definition") != std::string::npos);
+			BOOST_TEST(log.find("unused = 1") != std::string::npos);
+		}
+
+		BOOST_AUTO_TEST_CASE(parallel_text_generation, * ut::description("test that text generated on multiple threads is the same as on 1 thread"))
+		{
+			// more blocks than fit in a single chunk, with invalid (skipped) ones in between
+			std::string input = minimal_input() + "empty = []\n";
+			for (int i = 0; i < 1000; ++i) {
+				input += "Quality " + std::to_string(i % 20) + " ItemLevel " + std::to_string(i);
+				input += i % 7 == 0 ? " BaseType empty {\n" : " {\n";
+				input += "\tSetFontSize " + std::to_string(20 + i % 20) + "\n\tShow\n}\n";
+			}
+
+			fs::generator::options options;
+			options.num_threads = 1;
+			const std::string expected_filter = generate_filter(input, {}, options);
+
+			for (unsigned num_threads : {2u, 3u, 8u}) {
+				options.num_threads = num_threads;
+				BOOST_TEST(generate_filter(input, {}, options) == expected_filter);
+
+				fs::generator::string_sink output;
+				fs::log::buffered_logger logger;
+				BOOST_TEST_REQUIRE(fs::generator::generate_filter(input, {}, fs::lang::item_price_metadata{}, options, output, logger));
+				BOOST_TEST_REQUIRE(output.str().size() >= expected_filter.size());
+				BOOST_TEST(output.str().compare(output.str().size() - expected_filter.size(), expected_filter.size(), expected_filter) == 0);
+			}
+		}
+
+		BOOST_AUTO_TEST_CASE(streamed_output, * ut::description("test that a filter streamed to a file has the preamble followed by all blocks"))
+		{
+			namespace bfs = boost::filesystem;
+
+			std::string input = minimal_input();
+			for (int i = 0; i < 100; ++i)
+				input += "Quality " + std::to_string(i) + R"( BaseType ["Vaal Regalia", "Sorcerer Boots"] { SetFontSize 40 Show }
+)";
+			const std::string blocks = generate_filter(input);
+
+			const bfs::path path = bfs::temp_directory_path() / bfs::unique_path("fs_output_test_%%%%-%%%%-%%%%.filter");
+			fs::log::buffered_logger logger;
+			// small buffer - both buffered and direct writes happen
+			fs::generator::file_sink output(path, 256);
+			BOOST_TEST_REQUIRE(fs::generator::generate_filter(input, {}, fs::lang::item_price_metadata{}, {}, output, logger));
+			BOOST_TEST_REQUIRE(!output.finish());
+
+			std::error_code ec;
+			const std::string file_content = fs::utility::load_file(path, ec);
+			bfs::remove(path);
+			BOOST_TEST_REQUIRE(!ec);
+
+			BOOST_TEST_REQUIRE(file_content.size() > blocks.size());
+			BOOST_TEST(file_content.compare(0, 2, "# ") == 0);
+			BOOST_TEST(file_content.compare(file_content.size() - blocks.size(), blocks.size(), blocks) == 0);
+
+			fs::generator::string_sink string_output;
+			BOOST_TEST_REQUIRE(fs::generator::generate_filter(input, {}, fs::lang::item_price_metadata{}, {}, string_output, logger));
+			BOOST_TEST(string_output.str().size() == file_content.size());
+		}
+
+		BOOST_AUTO_TEST_CASE(unchanged_output, * ut::description("test that a file with the same filter is not rewritten, regardless of generation info"))
+		{
+			namespace bfs = boost::filesystem;
+
+			const std::string input = minimal_input() + R"(BaseType "Gold Ring" { SetFontSize 40 Show })";
+			const bfs::path path = bfs::temp_directory_path() / bfs::unique_path("fs_output_test_%%%%-%%%%-%%%%.filter");
+			fs::log::buffered_logger logger;
+
+			const auto generate_to_file = [&](const std::string& source, const std::string& league_name) {
+				fs::lang::item_price_metadata metadata;
+				metadata.league_name = league_name;
+				fs::generator::file_sink output(path, fs::generator::write_policy::if_changed);
+				BOOST_TEST_REQUIRE(fs::generator::generate_filter(source, {}, metadata, {}, output, logger));
+				BOOST_TEST_REQUIRE(!output.finish());
+				return output.unchanged();
+			};
+
+			// no file yet
+			BOOST_TEST(!generate_to_file(input, "Standard"));
+			std::error_code ec;
+			const std::string first_content = fs::utility::load_file(path, ec);
+			BOOST_TEST_REQUIRE(!ec);
+			BOOST_TEST(fs::generator::remove_metadata_preamble(first_content) == generate_filter(input));
+
+			// different generation info only
+			BOOST_TEST(generate_to_file(input, "Hardcore"));
+			BOOST_TEST(fs::utility::load_file(path, ec) == first_content);
+
+			// different blocks
+			BOOST_TEST(!generate_to_file(input + R"(BaseType "Iron Ring" { Hide })", "Hardcore"));
+			BOOST_TEST(fs::utility::load_file(path, ec) != first_content);
+
+			bfs::remove(path);
+		}
+
+		BOOST_AUTO_TEST_CASE(merged_blocks, * ut::description("test that consecutive blocks differing only in one string list are merged"))
+		{
+			fs::generator::options options;
+			options.merge_blocks = true;
+			const std::string actual_filter = generate_filter(minimal_input() + R"(
+empty = []
+Quality > 5 {
+	SetFontSize 40
+	BaseType ["Gold Ring", "Ruby Ring"] { Show }
+	BaseType ["Ruby Ring", "Onyx Amulet"] { Show }
+	BaseType empty { Show }
+	BaseType "Coral Ring" { Show }
+	BaseType "Iron Ring" { SetFontSize 42 Show }
+	Class "Rings" { SetFontSize 42 Show }
+	Class "Amulets" { SetFontSize 42 Show }
+	Class "Belts" { SetFontSize 42 Hide }
+}
+)", {}, options);
+			const std::string_view expected_filter =
+R"(Show
+	Quality > 5
+	BaseType "Gold Ring" "Ruby Ring" "Onyx Amulet" "Coral Ring"
+	SetFontSize 40
+
+Show
+	Quality > 5
+	BaseType "Iron Ring"
+	SetFontSize 42
+
+Show
+	Quality > 5
+	Class "Rings" "Amulets"
+	SetFontSize 42
+
+Hide
+	Quality > 5
+	Class "Belts"
+	SetFontSize 42
+
+)";
+
+			BOOST_TEST(compare_strings(expected_filter, actual_filter));
+		}
+
+		BOOST_AUTO_TEST_CASE(filter_variants, * ut::description("test that each variant is the template with overridden definitions"))
+		{
+			const auto make_template = [](std::string_view definitions) {
+				return minimal_input() + std::string(definitions) + R"(
+big_size = size
+unused = 1
+Quality > min_quality {
+	SetTextColor color
+	SetFontSize big_size
+	Show
+}
+Show
+)";
+			};
+			const std::string input = make_template("min_quality = 10\ncolor = RGB(1, 2, 3)\nsize = 40\n");
+
+			std::vector<fs::generator::string_sink> outputs(5);
+			const std::vector<fs::generator::filter_variant> variants = {
+				{"regular", "", &outputs[0]},
+				{"strict", "min_quality = 15", &outputs[1]},
+				{"colors", "size = 42\ncolor = RGB(9, 9, 9)", &outputs[2]},
+				{"no_such_name", "min_quality_typo = 15", &outputs[3]},
+				{"wrong_type", "color = 5", &outputs[4]}
+			};
+
+			fs::generator::options options;
+			options.num_threads = 2;
+			fs::log::buffered_logger logger;
+			const std::vector<bool> generated =
+				fs::generator::generate_filter_variants(input, {}, fs::lang::item_price_metadata{}, options, variants, logger);
+			BOOST_TEST(generated == (std::vector<bool>{true, true, true, false, false}), tt::per_element());
+
+			const auto expect_output = [&](const fs::generator::string_sink& output, std::string_view definitions) {
+				const std::string expected = generate_filter(make_template(definitions));
+				BOOST_TEST_REQUIRE(output.str().size() > expected.size());
+				BOOST_TEST(output.str().compare(output.str().size() - expected.size(), expected.size(), expected) == 0);
+			};
+			expect_output(outputs[0], "min_quality = 10\ncolor = RGB(1, 2, 3)\nsize = 40\n");
+			expect_output(outputs[1], "min_quality = 15\ncolor = RGB(1, 2, 3)\nsize = 40\n");
+			expect_output(outputs[2], "min_quality = 10\ncolor = RGB(9, 9, 9)\nsize = 42\n");
+			BOOST_TEST(outputs[3].str().empty());
+			BOOST_TEST(outputs[4].str().empty());
+
+			const std::string log = logger.flush_out();
+			BOOST_TEST(log.find("variant no_such_name failed") != std::string::npos);
+			BOOST_TEST(log.find("variant wrong_type failed") != std::string::npos);
+			BOOST_TEST(log.find("variant colors generated") != std::string::npos);
+		}
+
+		BOOST_AUTO_TEST_CASE(variant_using_unused_definitions,
+			* ut::description("test that without strict mode overrides can use definitions which the template does not use"))
+		{
+			const std::string input = minimal_input() + R"(
+color = RGB(1, 2, 3)
+alt_component = 9
+alt_color = RGB(alt_component, alt_component, 0)
+SetTextColor color
+Show
+)";
+			fs::generator::string_sink output;
+			const std::vector<fs::generator::filter_variant> variants = {
+				{"alt", "color = alt_color", &output}
+			};
+
+			fs::generator::options options;
+			options.warn_unused_definitions = true;
+			fs::log::buffered_logger logger;
+			const std::vector<bool> generated =
+				fs::generator::generate_filter_variants(input, {}, fs::lang::item_price_metadata{}, options, variants, logger);
+			const std::string log = logger.flush_out();
+			BOOST_TEST_REQUIRE(generated == std::vector<bool>{true}, tt::per_element());
+
+			const std::string_view expected_filter =
+R"(Show
+	SetTextColor 9 9 0
+
+)";
+			BOOST_TEST_REQUIRE(output.str().size() > expected_filter.size());
+			BOOST_TEST(output.str().compare(output.str().size() - expected_filter.size(), expected_filter.size(), expected_filter) == 0);
+			// used by the override, not unused
+			BOOST_TEST(log.find("unused definition") == std::string::npos, log);
+		}
+
+		BOOST_AUTO_TEST_CASE(minimized_string_lists, * ut::description("test that non-exact string lists lose entries which contain other entries"))
+		{
+			fs::generator::options options;
+			options.minimize_string_lists = true;
+			const std::string actual_filter = generate_filter(minimal_input() + R"(
+rings = ["Two-Stone Ring", "Ring", "Sapphire Ring", "Ring"]
+BaseType rings {
+	Quality > 0 { Show }
+	Class ["Rings", "Rings"] { Hide }
+}
+BaseType == rings { Show }
+)", {}, options);
+			const std::string_view expected_filter =
+R"(Show
+	Quality > 0
+	BaseType "Ring"
+
+Hide
+	Class "Rings"
+	BaseType "Ring"
+
+Show
+	BaseType == "Two-Stone Ring" "Ring" "Sapphire Ring" "Ring"
+
 )";
 
 			BOOST_TEST(compare_strings(expected_filter, actual_filter));
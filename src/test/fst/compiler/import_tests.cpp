@@ -0,0 +1,303 @@
+#include <fst/common/test_fixtures.hpp>
+#include <fst/common/string_operations.hpp>
+
+#include <fs/compiler/resolve_imports.hpp>
+#include <fs/compiler/module_cache.hpp>
+#include <fs/compiler/print_error.hpp>
+#include <fs/generator/filter_cache.hpp>
+#include <fs/generator/generate_filter.hpp>
+#include <fs/generator/generator.hpp>
+#include <fs/lang/item_price_metadata.hpp>
+#include <fs/lang/item_price_data.hpp>
+#include <fs/log/buffered_logger.hpp>
+#include <fs/utility/file.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+namespace bfs = boost::filesystem;
+using namespace fs;
+
+namespace fst
+{
+
+BOOST_FIXTURE_TEST_SUITE(compiler_suite, compiler_fixture)
+
+	class import_fixture : public compiler_fixture
+	{
+	protected:
+		import_fixture()
+		: directory(bfs::temp_directory_path() / bfs::unique_path("fs_import_test_%%%%-%%%%-%%%%"))
+		{
+			bfs::create_directories(directory);
+		}
+
+		~import_fixture()
+		{
+			boost::system::error_code ec;
+			bfs::remove_all(directory, ec);
+		}
+
+		void write_file(const std::string& name, std::string_view content)
+		{
+			BOOST_TEST_REQUIRE(!utility::save_file(directory / name, content));
+		}
+
+		std::variant<lang::symbol_table, compiler::compile_error>
+		resolve_imports(const parser::parse_success_data& parse_data, compiler::module_cache& cache)
+		{
+			return compiler::resolve_imports(parse_data.ast.imports, directory, lang::item_price_data{}, cache);
+		}
+
+		lang::symbol_table
+		expect_success_when_resolving_imports(const parser::parse_success_data& parse_data, compiler::module_cache& cache)
+		{
+			std::variant<lang::symbol_table, compiler::compile_error> result = resolve_imports(parse_data, cache);
+
+			if (std::holds_alternative<compiler::compile_error>(result)) {
+				log::buffered_logger logger;
+				compiler::print_error(std::get<compiler::compile_error>(result), parse_data.lookup_data, logger);
+				const auto log = logger.flush_out();
+				BOOST_FAIL("resolve_imports failed but should not:\n" << log);
+			}
+
+			return std::get<lang::symbol_table>(std::move(result));
+		}
+
+		template <typename T>
+		const T& expect_error_of_type(const std::variant<lang::symbol_table, compiler::compile_error>& result)
+		{
+			BOOST_TEST_REQUIRE(std::holds_alternative<compiler::compile_error>(result));
+			const auto& error = std::get<compiler::compile_error>(result);
+			BOOST_TEST_REQUIRE(std::holds_alternative<T>(error));
+			return std::get<T>(error);
+		}
+
+		bfs::path directory;
+	};
+
+	BOOST_FIXTURE_TEST_SUITE(import_suite, import_fixture)
+
+		BOOST_AUTO_TEST_CASE(imported_definitions)
+		{
+			write_file("colors.fs", "Import \"sizes.fs\"\nred = RGB(255, 0, 0)\nreds = [red, red]\nlarge = size\n");
+			write_file("sizes.fs", "size = FontSize(40)\n");
+
+			const std::string input_str = minimal_input() + "Import \"colors.fs\"\ncolor = red\n";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			compiler::module_cache cache;
+			const lang::symbol_table symbols = expect_success_when_resolving_imports(parse_data, cache);
+
+			// only own definitions of imported file are visible
+			BOOST_TEST(symbols.size() == 3u);
+			BOOST_TEST(symbols.count("size") == 0u);
+
+			const auto it = symbols.find("reds");
+			BOOST_TEST_REQUIRE((it != symbols.end()));
+			const lang::object& reds = it->second.object_instance;
+			BOOST_TEST_REQUIRE(reds.is_array());
+			const auto& elements = std::get<lang::array_object>(reds.value);
+			BOOST_TEST_REQUIRE(elements.size() == 2u);
+			BOOST_TEST((elements[0].value == lang::object_variant(lang::color(255, 0, 0))));
+
+			// imported objects point to the import
+			const parser::lookup_data& lookup_data = parse_data.lookup_data;
+			const std::string_view import = search(input, "Import \"colors.fs\"");
+			BOOST_TEST(compare_ranges(import, lookup_data.position_of(it->second.name_origin), input));
+			BOOST_TEST(compare_ranges(import, lookup_data.position_of(reds.value_origin), input));
+			BOOST_TEST(compare_ranges(import, lookup_data.position_of(elements[1].value_origin), input));
+
+			const auto large = symbols.find("large");
+			BOOST_TEST_REQUIRE((large != symbols.end()));
+			BOOST_TEST((large->second.object_instance.value == lang::object_variant(lang::font_size(40))));
+		}
+
+		BOOST_AUTO_TEST_CASE(module_cache_reuse)
+		{
+			write_file("colors.fs", "red = RGB(255, 0, 0)\n");
+			const parser::parse_success_data parse_data = parse("Import \"colors.fs\"\nImport \"colors.fs\"\n");
+
+			compiler::module_cache cache;
+			(void) expect_success_when_resolving_imports(parse_data, cache);
+			(void) expect_success_when_resolving_imports(parse_data, cache);
+			BOOST_TEST(cache.get_statistics().misses == 1u);
+			BOOST_TEST(cache.get_statistics().hits == 1u);
+
+			// changed content - must be evaluated again
+			write_file("colors.fs", "red = RGB(200, 0, 0)\n");
+			const lang::symbol_table symbols = expect_success_when_resolving_imports(parse_data, cache);
+			BOOST_TEST(cache.get_statistics().misses == 2u);
+			BOOST_TEST((symbols.at("red").object_instance.value == lang::object_variant(lang::color(200, 0, 0))));
+		}
+
+		BOOST_AUTO_TEST_CASE(module_cache_dependency_changed)
+		{
+			write_file("colors.fs", "Import \"base.fs\"\nred = base\n");
+			write_file("base.fs", "base = RGB(1, 2, 3)\n");
+			const parser::parse_success_data parse_data = parse("Import \"colors.fs\"\n");
+
+			compiler::module_cache cache;
+			(void) expect_success_when_resolving_imports(parse_data, cache);
+			write_file("base.fs", "base = RGB(4, 5, 6)\n");
+			const lang::symbol_table symbols = expect_success_when_resolving_imports(parse_data, cache);
+			BOOST_TEST((symbols.at("red").object_instance.value == lang::object_variant(lang::color(4, 5, 6))));
+		}
+
+		BOOST_AUTO_TEST_CASE(persistent_module_cache)
+		{
+			write_file("style.fs", R"(
+style = {
+	SetTextColor RGB(1, 2, 3, 4)
+	SetFontSize 45
+	SetAlertSound AlertSound(2, 300, True)
+	SetMinimapIcon MinimapIcon(0, Red, Star)
+	SetBeam Beam(Blue, True)
+}
+names = ["Orb", "Shard"]
+sound = AlertSound(Path("pop.wav"))
+group = Group("RGB")
+influence = Shaper
+rarity = Rare
+number = 1.5
+level = Level(10)
+nothing = _
+)");
+			const bfs::path cache_directory = directory / "cache";
+			bfs::create_directories(cache_directory);
+			const parser::parse_success_data parse_data = parse("Import \"style.fs\"\n");
+
+			lang::symbol_table evaluated;
+			{
+				compiler::module_cache cache(cache_directory);
+				evaluated = expect_success_when_resolving_imports(parse_data, cache);
+			}
+
+			compiler::module_cache cache(cache_directory);
+			const lang::symbol_table loaded = expect_success_when_resolving_imports(parse_data, cache);
+			BOOST_TEST(cache.get_statistics().hits == 1u);
+			BOOST_TEST_REQUIRE(loaded.size() == evaluated.size());
+			for (const auto& [name, obj] : evaluated)
+				BOOST_TEST((loaded.at(name).object_instance == obj.object_instance), "object " << name);
+		}
+
+		BOOST_AUTO_TEST_CASE(persistent_filter_cache)
+		{
+			write_file("sizes.fs", "size = 40\n");
+			const std::string input = minimal_input() + "Import \"sizes.fs\"\nSetFontSize size\nShow\n";
+			const bfs::path cache_directory = directory / "filters";
+			bfs::create_directories(cache_directory);
+
+			lang::item_price_data ipd;
+			const auto generate = [&](generator::filter_cache& cache, generator::options options) {
+				options.import_directory = directory.generic_string();
+				options.filter_cache = &cache;
+				log::buffered_logger logger;
+				std::optional<std::string> filter = generator::generate_filter(input, ipd, lang::item_price_metadata{}, options, logger);
+				const auto log = logger.flush_out();
+				BOOST_TEST_REQUIRE(filter.has_value(), "filter generation failed:\n" << log);
+				return std::string(generator::remove_metadata_preamble(*filter));
+			};
+
+			std::string first;
+			{
+				generator::filter_cache cache(cache_directory);
+				first = generate(cache, {});
+				BOOST_TEST(cache.get_statistics().misses == 1u);
+			}
+
+			generator::filter_cache cache(cache_directory);
+			BOOST_TEST(generate(cache, {}) == first);
+			BOOST_TEST(cache.get_statistics().hits == 1u);
+
+			// any change of the output's inputs must result in a new generation
+			generator::options options;
+			options.merge_blocks = true;
+			(void) generate(cache, options);
+			BOOST_TEST(cache.get_statistics().misses == 1u);
+
+			ipd.divination_cards.emplace_back(lang::price_data{10.0, false}, "The Wolf", 5);
+			(void) generate(cache, {});
+			BOOST_TEST(cache.get_statistics().misses == 2u);
+
+			write_file("sizes.fs", "size = 42\n");
+			const std::string changed = generate(cache, {});
+			BOOST_TEST(cache.get_statistics().misses == 3u);
+			BOOST_TEST(changed != first);
+			BOOST_TEST(changed.find("SetFontSize 42") != std::string::npos);
+			BOOST_TEST(generate(cache, {}) == changed);
+			BOOST_TEST(cache.get_statistics().hits == 2u);
+		}
+
+		BOOST_AUTO_TEST_CASE(filter_cache_warnings)
+		{
+			const std::string input = minimal_input() + "unused = 1\nQuality > 0 { Show }\nQuality > 1 { Show }\n";
+			generator::options options;
+			options.warn_unused_definitions = true;
+			generator::filter_cache cache;
+			options.filter_cache = &cache;
+
+			const auto generate = [&]() {
+				log::buffered_logger logger;
+				const std::optional<std::string> filter =
+					generator::generate_filter(input, {}, lang::item_price_metadata{}, options, logger);
+				const std::string log = logger.flush_out();
+				BOOST_TEST_REQUIRE(filter.has_value(), "filter generation failed:\n" << log);
+				return std::pair(std::string(generator::remove_metadata_preamble(*filter)), log);
+			};
+
+			const auto [first_filter, first_log] = generate();
+			const auto [second_filter, second_log] = generate();
+			BOOST_TEST(cache.get_statistics().hits == 1u);
+			BOOST_TEST(second_filter == first_filter);
+
+			for (const std::string& log : {first_log, second_log}) {
+				BOOST_TEST(log.find("WARN: ") != std::string::npos, log);
+				BOOST_TEST(log.find("unused definition") != std::string::npos, log);
+				BOOST_TEST(log.find("unreachable block") != std::string::npos, log);
+			}
+		}
+
+		BOOST_AUTO_TEST_CASE(import_errors)
+		{
+			write_file("a.fs", "Import \"b.fs\"\n");
+			write_file("b.fs", "Import \"a.fs\"\n");
+			write_file("statements.fs", "x = 1\nShow\n");
+			write_file("x1.fs", "x = 1\n");
+			write_file("x2.fs", "x = 2\n");
+
+			compiler::module_cache cache;
+			const auto expect_failed_import = [&](const std::string& input, std::string_view expected_description) {
+				const parser::parse_success_data parse_data = parse(input);
+				const auto result = resolve_imports(parse_data, cache);
+				const auto& error = expect_error_of_type<compiler::errors::failed_import>(result);
+				BOOST_TEST(error.description.find(expected_description) != std::string::npos, error.description);
+			};
+
+			expect_failed_import("Import \"a.fs\"\n", "import cycle");
+			expect_failed_import("Import \"statements.fs\"\n", "only imports and definitions");
+			expect_failed_import("Import \"missing.fs\"\n", "failed to load file");
+
+			const std::string input_str = "Import \"x1.fs\"\nImport \"x2.fs\"\n";
+			const std::string_view input = input_str;
+			const parser::parse_success_data parse_data = parse(input);
+			const auto result = resolve_imports(parse_data, cache);
+			const auto& error = expect_error_of_type<compiler::errors::name_already_exists>(result);
+			const parser::lookup_data& lookup_data = parse_data.lookup_data;
+			BOOST_TEST(compare_ranges(search(input, "Import \"x2.fs\""), lookup_data.position_of(error.place_of_duplicated_name), input));
+			BOOST_TEST(compare_ranges(search(input, "Import \"x1.fs\""), lookup_data.position_of(error.place_of_original_name), input));
+		}
+
+	BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -0,0 +1,199 @@
+#include <fst/common/test_fixtures.hpp>
+#include <fst/common/node_ranges.hpp>
+
+#include <fs/parser/parser.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+using namespace fs;
+
+namespace fst
+{
+
+BOOST_AUTO_TEST_SUITE(parser_suite)
+
+	class incremental_parser_fixture : public parser_fixture
+	{
+	protected:
+		/*
+		 * Replace [offset, offset + length) of old_input with replacement and compare
+		 * incremental parse with a full parse of the new input. AST nodes are compared
+		 * by their position - it captures both structure and the text they were parsed from.
+		 */
+		parser::parse_success_data
+		expect_same_as_full_reparse(
+			const std::string& old_input,
+			std::size_t offset,
+			std::size_t length,
+			const std::string& replacement)
+		{
+			new_input = old_input;
+			new_input.replace(offset, length, replacement);
+
+			parser::parse_success_data previous = parse(old_input);
+			std::variant<parser::parse_success_data, parser::parse_failure_data> result =
+				parser::parse_incremental(new_input, parser::text_edit{offset, length, replacement.size()}, std::move(previous));
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_success_data>(result));
+			auto& incremental = std::get<parser::parse_success_data>(result);
+
+			const parser::parse_success_data full = parse(new_input);
+			BOOST_TEST(incremental.ast.imports.size() == full.ast.imports.size());
+			BOOST_TEST(incremental.ast.definitions.size() == full.ast.definitions.size());
+			BOOST_TEST(incremental.ast.statements.size() == full.ast.statements.size());
+			BOOST_TEST(incremental.lookup_data.get_view_of_whole_content().data() == new_input.data());
+
+			const std::vector<node_range> expected = ranges_of_all_nodes(full);
+			const std::vector<node_range> actual = ranges_of_all_nodes(incremental);
+			BOOST_TEST(actual == expected, boost::test_tools::per_element());
+
+			return std::move(incremental);
+		}
+
+		std::string new_input;
+	};
+
+	BOOST_FIXTURE_TEST_SUITE(incremental_parser_suite, incremental_parser_fixture)
+
+		const std::string input = minimal_input() + R"(
+n1 = 1
+n2 = [1, 2, 3]
+color = RGB(1, 2, 3)
+
+SetTextColor color
+
+Class "Currency" {
+	SetBorderColor color
+
+	BaseType "Orb" {
+		Show
+	}
+}
+
+Rarity Rare {
+	Hide
+}
+
+Show
+)";
+
+		BOOST_AUTO_TEST_CASE(edit_inside_definition)
+		{
+			const std::size_t offset = input.find("[1, 2, 3]") + 1;
+			expect_same_as_full_reparse(input, offset, 1, "100, 200");
+		}
+
+		BOOST_AUTO_TEST_CASE(edit_inside_nested_block)
+		{
+			const std::size_t offset = input.find("Show");
+			const parser::parse_success_data result = expect_same_as_full_reparse(input, offset, 4, "Hide");
+
+			// items away from the edit have not been parsed again - their IDs are preserved,
+			// parsed items have their positions appended after all previous positions
+			const parser::parse_success_data original = parse(input);
+			const auto num_original_positions = static_cast<int>(original.lookup_data.get_position_cache().size());
+			BOOST_TEST(result.ast.definitions[0].id_first == original.ast.definitions[0].id_first);
+			BOOST_TEST(result.ast.statements[1].id_first >= num_original_positions);
+			BOOST_TEST(result.ast.statements[2].id_first == original.ast.statements[2].id_first);
+		}
+
+		BOOST_AUTO_TEST_CASE(insert_new_items)
+		{
+			const std::size_t offset = input.find("SetTextColor");
+			expect_same_as_full_reparse(input, offset, 0, "n3 = 3\nn4 = n3\n\nSetFontSize 40\n");
+		}
+
+		BOOST_AUTO_TEST_CASE(remove_items)
+		{
+			const std::size_t first = input.find("Rarity");
+			const std::size_t last = input.rfind("Show");
+			expect_same_as_full_reparse(input, first, last - first, "");
+		}
+
+		BOOST_AUTO_TEST_CASE(edit_extends_previous_item)
+		{
+			const std::size_t offset = input.find("\ncolor = ");
+			expect_same_as_full_reparse(input, offset, 0, "[0]");
+		}
+
+		BOOST_AUTO_TEST_CASE(edit_starts_comment)
+		{
+			const std::string one_line_input = "n1 = 1 n2 = 2 n3 = 3\nShow Hide Show\n";
+			expect_same_as_full_reparse(one_line_input, one_line_input.find("n2"), 0, "#");
+			expect_same_as_full_reparse(one_line_input, one_line_input.find("Hide"), 0, "# ");
+		}
+
+		BOOST_AUTO_TEST_CASE(insert_imports)
+		{
+			const std::string input_with_import = "Import \"a.fs\"\n" + input;
+			expect_same_as_full_reparse(input, 0, 0, "Import \"a.fs\"\n");
+			expect_same_as_full_reparse(input_with_import, input_with_import.find("n1"), 0, "Import \"b.fs\"\n");
+			expect_same_as_full_reparse(input_with_import, 0, input_with_import.find("n1"), "");
+		}
+
+		BOOST_AUTO_TEST_CASE(edit_at_boundaries)
+		{
+			expect_same_as_full_reparse(input, 0, 0, "# comment\nn0 = 0\n");
+			expect_same_as_full_reparse(input, input.size(), 0, "Hide\n");
+			expect_same_as_full_reparse(input, 0, input.size(), "Show");
+		}
+
+		BOOST_AUTO_TEST_CASE(successive_edits, * boost::unit_test::description("test that positions stay correct and the position cache stays bounded after many edits, each based on the previous result"))
+		{
+			std::string current_input = input;
+			parser::parse_success_data current = parse(current_input);
+			const std::size_t num_full_parse_positions = current.lookup_data.get_position_cache().size();
+
+			// more edits than the position cache keeps as pending shifts
+			for (int i = 0; i < 150; ++i) {
+				// alternately grow and shrink items both before and after other edits
+				const std::string_view target = i % 3 == 0 ? "n1 = " : i % 3 == 1 ? "Rarity Rare" : "SetBorderColor";
+				const std::size_t offset = current_input.find(target) + target.size();
+				const std::string replacement = i % 2 == 0 ? " " : "";
+				const std::size_t removed = i % 2 == 0 ? 0 : (current_input[offset] == ' ' && current_input[offset + 1] == ' ' ? 1 : 0);
+
+				std::string next_input = current_input;
+				next_input.replace(offset, removed, replacement);
+
+				auto result = parser::parse_incremental(next_input, parser::text_edit{offset, removed, replacement.size()}, std::move(current));
+				BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_success_data>(result));
+				current = std::get<parser::parse_success_data>(std::move(result));
+				current_input = std::move(next_input);
+
+				// positions of replaced items must not pile up
+				BOOST_TEST(current.lookup_data.get_position_cache().size() <= 2 * num_full_parse_positions);
+			}
+
+			const parser::parse_success_data full = parse(current_input);
+			BOOST_TEST(current.lookup_data.get_view_of_whole_content().data() == current_input.data());
+			BOOST_TEST(ranges_of_all_nodes(current) == ranges_of_all_nodes(full), boost::test_tools::per_element());
+		}
+
+		BOOST_AUTO_TEST_CASE(edit_resulting_in_error)
+		{
+			const std::size_t offset = input.find("Class");
+			parser::parse_success_data previous = parse(input);
+			std::string broken_input = input;
+			broken_input.insert(offset, "n3 = 3\n");
+
+			// a definition after a statement - must be reported exactly as by a full parse
+			auto result = parser::parse_incremental(broken_input, parser::text_edit{offset, 0, 7}, std::move(previous));
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_failure_data>(result));
+
+			auto full_result = parser::parse(broken_input);
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_failure_data>(full_result));
+			BOOST_TEST(
+				std::get<parser::parse_failure_data>(result).parser_stop_position ==
+				std::get<parser::parse_failure_data>(full_result).parser_stop_position);
+		}
+
+	BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
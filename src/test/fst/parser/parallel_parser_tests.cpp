@@ -0,0 +1,167 @@
+#include <fst/common/test_fixtures.hpp>
+#include <fst/common/node_ranges.hpp>
+
+#include <fs/parser/parser.hpp>
+#include <fs/parser/detail/top_level_boundaries.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+using namespace fs;
+
+namespace fst
+{
+
+BOOST_AUTO_TEST_SUITE(parser_suite)
+
+	class parallel_parser_fixture : public parser_fixture
+	{
+	protected:
+		// tiny chunks so that even short inputs are split into many chunks
+		static constexpr unsigned num_threads = 4;
+		static constexpr std::size_t min_chunk_size = 1;
+
+		void expect_same_as_serial_parse(const std::string& input)
+		{
+			const parser::parse_success_data serial = parse(input);
+			std::variant<parser::parse_success_data, parser::parse_failure_data> result =
+				parser::parse_parallel(input, num_threads, min_chunk_size);
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_success_data>(result));
+			const auto& parallel = std::get<parser::parse_success_data>(result);
+
+			BOOST_TEST(parallel.ast.imports.size() == serial.ast.imports.size());
+			BOOST_TEST(parallel.ast.definitions.size() == serial.ast.definitions.size());
+			BOOST_TEST(parallel.ast.statements.size() == serial.ast.statements.size());
+
+			const std::vector<node_range> expected = ranges_of_all_nodes(serial);
+			const std::vector<node_range> actual = ranges_of_all_nodes(parallel);
+			BOOST_TEST(actual == expected, boost::test_tools::per_element());
+		}
+
+		void expect_same_failure_as_serial_parse(const std::string& input)
+		{
+			const auto serial_result = parser::parse(input);
+			const auto parallel_result = parser::parse_parallel(input, num_threads, min_chunk_size);
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_failure_data>(serial_result));
+			BOOST_TEST_REQUIRE(std::holds_alternative<parser::parse_failure_data>(parallel_result));
+
+			const auto& serial = std::get<parser::parse_failure_data>(serial_result);
+			const auto& parallel = std::get<parser::parse_failure_data>(parallel_result);
+			BOOST_TEST(parallel.parser_stop_position == serial.parser_stop_position);
+			BOOST_TEST_REQUIRE(parallel.errors.size() == serial.errors.size());
+
+			for (std::size_t i = 0; i < serial.errors.size(); ++i) {
+				BOOST_TEST(parallel.errors[i].error_place == serial.errors[i].error_place);
+				BOOST_TEST(parallel.errors[i].backtracking_place == serial.errors[i].backtracking_place);
+				BOOST_TEST(parallel.errors[i].what_was_expected == serial.errors[i].what_was_expected);
+			}
+		}
+	};
+
+	BOOST_FIXTURE_TEST_SUITE(parallel_parser_suite, parallel_parser_fixture)
+
+		const std::string input = minimal_input() + R"(
+# comment with braces { } and "quotes
+n1 = 1
+n2 = [1, 2, 3]
+action = {
+	SetFontSize 42 # } not a brace
+}
+str = "{ not a brace"
+color = RGB(1, 2, 3)
+
+SetTextColor color
+
+Class "Currency" {
+	SetBorderColor color
+
+	BaseType "Orb" {
+		Show
+	}
+}
+Rarity Rare { Hide } Quality > 10 {
+	Set action
+	Hide
+}
+
+{
+	Show
+}
+
+Show
+)";
+
+		BOOST_AUTO_TEST_CASE(same_as_serial)
+		{
+			expect_same_as_serial_parse(input);
+		}
+
+		BOOST_AUTO_TEST_CASE(brace_followed_by_subscript)
+		{
+			expect_same_as_serial_parse("a = [{ SetFontSize 1 }]\nb = { SetFontSize 2 }\n[0]\nc = 1\nSet b\n");
+		}
+
+		BOOST_AUTO_TEST_CASE(only_definitions_or_statements)
+		{
+			expect_same_as_serial_parse("a = 1\nb = 2\nc = 3\n");
+			expect_same_as_serial_parse("{ Show }\n{ Hide }\nShow\n");
+			expect_same_as_serial_parse("# only a comment\n");
+			expect_same_as_serial_parse("Import \"a.fs\"\nImport \"b.fs\"\na = 1\nb = 2\nShow\n");
+		}
+
+		BOOST_AUTO_TEST_CASE(multiline_conditions, * boost::unit_test::description("test that conditions like \"Quality = 20\" are not mistaken for definitions"))
+		{
+			const std::string multiline_input = input + R"(
+Class "Currency"
+Quality = 20
+Rarity = Rare
+{
+	Show
+}
+
+BaseType "Orb"
+StackSize = 10 {
+	Hide
+}
+)";
+			expect_same_as_serial_parse(multiline_input);
+
+			// no chunk may fail - otherwise parse_parallel would silently fall back to a serial parse
+			const std::string_view whole_input = multiline_input;
+			std::size_t chunk_first = 0;
+			std::vector<std::size_t> boundaries = parser::detail::find_top_level_boundaries(whole_input);
+			boundaries.push_back(whole_input.size());
+			for (std::size_t boundary : boundaries) {
+				BOOST_TEST_INFO("chunk: " << whole_input.substr(chunk_first, boundary - chunk_first));
+				BOOST_TEST(std::holds_alternative<parser::parse_success_data>(
+					parser::parse(whole_input.substr(chunk_first, boundary - chunk_first))));
+				chunk_first = boundary;
+			}
+
+			for (std::string_view condition : {"Quality", "Rarity", "StackSize"}) {
+				const std::size_t offset = whole_input.find(std::string(condition) + " = ");
+				BOOST_TEST(std::count(boundaries.begin(), boundaries.end(), offset) == 0);
+			}
+		}
+
+		BOOST_AUTO_TEST_CASE(error_in_chunk)
+		{
+			expect_same_failure_as_serial_parse(input + "Class \"x\" { Show ]\n{ Hide }\n");
+		}
+
+		BOOST_AUTO_TEST_CASE(definition_after_statement)
+		{
+			expect_same_failure_as_serial_parse(input + "n3 = 3\n");
+		}
+
+	BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
@@ -138,6 +138,79 @@ Identifiedd = Corruptedd
 		test_identifier_definition(defs[8], "Identifiedd", "Corruptedd");
 	}
 
+	BOOST_AUTO_TEST_CASE(keyword_literals)
+	{
+		const std::string input = minimal_input() + R"(
+# test that keywords are recognized only as whole tokens
+b1 = True
+b2 = False
+rarity = Rare
+shape = Hexagon
+suit = Yellow
+influence = Shaper
+not_a_keyword1 = ShaperItem
+not_a_keyword2 = Rare_
+not_a_keyword3 = Hexagon2
+)";
+
+		namespace lang = fs::lang;
+		namespace pa = fs::parser::ast;
+		const pa::ast_type ast = parse(input).ast;
+
+		const std::vector<pa::definition>& defs = ast.definitions;
+		BOOST_TEST_REQUIRE(static_cast<int>(defs.size()) == 9);
+
+		test_literal_definition<pa::boolean_literal>(defs[0], "b1", true);
+		test_literal_definition<pa::boolean_literal>(defs[1], "b2", false);
+
+		const auto literal_of = [](const pa::definition& def) -> const pa::literal_expression& {
+			BOOST_TEST_REQUIRE(holds_alternative<pa::literal_expression>(def.definition.value.primary_expr.var));
+			return boost::get<pa::literal_expression>(def.definition.value.primary_expr.var);
+		};
+
+		const pa::literal_expression& rarity = literal_of(defs[2]);
+		BOOST_TEST_REQUIRE(holds_alternative<pa::rarity_literal>(rarity.var));
+		BOOST_TEST((boost::get<pa::rarity_literal>(rarity.var).value == lang::rarity::rare));
+
+		const pa::literal_expression& shape = literal_of(defs[3]);
+		BOOST_TEST_REQUIRE(holds_alternative<pa::shape_literal>(shape.var));
+		BOOST_TEST((boost::get<pa::shape_literal>(shape.var).value == lang::shape::hexagon));
+
+		const pa::literal_expression& suit = literal_of(defs[4]);
+		BOOST_TEST_REQUIRE(holds_alternative<pa::suit_literal>(suit.var));
+		BOOST_TEST((boost::get<pa::suit_literal>(suit.var).value == lang::suit::yellow));
+
+		const pa::literal_expression& influence = literal_of(defs[5]);
+		BOOST_TEST_REQUIRE(holds_alternative<pa::influence_literal>(influence.var));
+		BOOST_TEST((boost::get<pa::influence_literal>(influence.var).value == lang::influence::shaper));
+
+		test_identifier_definition(defs[6], "not_a_keyword1", "ShaperItem");
+		test_identifier_definition(defs[7], "not_a_keyword2", "Rare_");
+		test_identifier_definition(defs[8], "not_a_keyword3", "Hexagon2");
+	}
+
+	BOOST_AUTO_TEST_CASE(import_directives)
+	{
+		const std::string input = minimal_input() + R"(
+Import "colors.fs"
+Import "../common/sounds.fs"
+Importance = 1
+)";
+
+		namespace pa = fs::parser::ast;
+		const pa::ast_type ast = parse(input).ast;
+
+		BOOST_TEST_REQUIRE(static_cast<int>(ast.imports.size()) == 2);
+		test_literal(ast.imports[0].path, "colors.fs");
+		test_literal(ast.imports[1].path, "../common/sounds.fs");
+
+		BOOST_TEST_REQUIRE(static_cast<int>(ast.definitions.size()) == 1);
+		BOOST_TEST(ast.definitions[0].definition.name.value == "Importance");
+
+		// imports must precede definitions
+		BOOST_TEST(std::holds_alternative<fs::parser::parse_failure_data>(fs::parser::parse("a = 1\nImport \"b.fs\"\n")));
+	}
+
 	BOOST_AUTO_TEST_CASE(empty_string)
 	{
 		const std::string input = minimal_input() + "\n"
@@ -0,0 +1,54 @@
+#include <fs/utility/copy_on_write.hpp>
+#include <fs/utility/parallel.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace ut = boost::unit_test;
+
+BOOST_AUTO_TEST_SUITE(copy_on_write_suite)
+
+	using fs::utility::copy_on_write;
+
+	BOOST_AUTO_TEST_CASE(edit_clones_shared_value)
+	{
+		copy_on_write<std::vector<int>> original(std::vector<int>{1, 2, 3});
+		copy_on_write<std::vector<int>> copy = original;
+		BOOST_TEST(copy.shares_value_with(original));
+
+		copy.edit().push_back(4);
+		BOOST_TEST(!copy.shares_value_with(original));
+		BOOST_TEST(original->size() == 3u);
+		BOOST_TEST(copy->size() == 4u);
+
+		// the only owner is edited in place
+		const std::vector<int>* const address = &*copy;
+		copy.edit().push_back(5);
+		BOOST_TEST(&*copy == address);
+	}
+
+	BOOST_AUTO_TEST_CASE(parallel_edits, * ut::description("test that copies of one value can be edited on different threads"))
+	{
+		const copy_on_write<std::vector<int>> original(std::vector<int>{0});
+
+		// each copy is made before the parallel section and then used only by one worker
+		std::vector<copy_on_write<std::vector<int>>> copies(64, original);
+		fs::utility::parallel_for(copies.size(), 8, [&](std::size_t i) {
+			copy_on_write<std::vector<int>> local = copies[i];
+			for (int j = 0; j < 100; ++j)
+				local.edit().push_back(static_cast<int>(i));
+
+			copies[i] = std::move(local);
+		});
+
+		BOOST_TEST(original->size() == 1u);
+		for (std::size_t i = 0; i < copies.size(); ++i) {
+			BOOST_TEST_REQUIRE(copies[i]->size() == 101u);
+			BOOST_TEST(copies[i]->back() == static_cast<int>(i));
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
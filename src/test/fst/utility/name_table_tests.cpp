@@ -0,0 +1,53 @@
+#include <fs/utility/name_table.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+
+using table_type = fs::utility::name_table<int, 5>;
+
+constexpr table_type table(std::array<table_type::entry, 5>{{
+	{"RGB", 1},
+	{"Level", 2},
+	{"FontSize", 3},
+	{"uniques_eq_ambiguous", 4},
+	{"uniques_eq_unambiguous", 5}
+}});
+
+// the table must be usable at compile time
+static_assert(table.find("Level") != nullptr && *table.find("Level") == 2);
+static_assert(table.find("Lev") == nullptr);
+
+}
+
+BOOST_AUTO_TEST_SUITE(name_table_suite)
+
+	BOOST_AUTO_TEST_CASE(find)
+	{
+		const std::array<std::pair<std::string_view, int>, 5> expected = {{
+			{"RGB", 1},
+			{"Level", 2},
+			{"FontSize", 3},
+			{"uniques_eq_ambiguous", 4},
+			{"uniques_eq_unambiguous", 5}
+		}};
+
+		for (const auto& [name, value] : expected) {
+			const int* const result = table.find(name);
+			BOOST_TEST_REQUIRE(result != nullptr, "name " << name << " not found");
+			BOOST_TEST(*result == value);
+		}
+
+		BOOST_TEST(table.find("") == nullptr);
+		BOOST_TEST(table.find("rgb") == nullptr);
+		BOOST_TEST(table.find("RGBA") == nullptr);
+		BOOST_TEST(table.find("uniques_eq") == nullptr);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
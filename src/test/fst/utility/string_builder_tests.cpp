@@ -0,0 +1,29 @@
+#include <fs/utility/string_builder.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <string>
+#include <string_view>
+
+BOOST_AUTO_TEST_SUITE(string_builder_suite)
+
+	BOOST_AUTO_TEST_CASE(appends_tokens)
+	{
+		fs::utility::string_builder output(64);
+		output << "Show" << '\n' << '\t' << std::string("BaseType") << " \"" << std::string_view("Orb") << '"' << '\n';
+		BOOST_TEST(output.str() == "Show\n\tBaseType \"Orb\"\n");
+		BOOST_TEST(output.size() == output.str().size());
+	}
+
+	BOOST_AUTO_TEST_CASE(formats_integers)
+	{
+		fs::utility::string_builder output;
+		output << 0 << ' ' << 255 << ' ' << -5 << ' '
+			<< std::numeric_limits<int>::max() << ' ' << std::numeric_limits<int>::min();
+
+		BOOST_TEST(std::move(output).str() == "0 255 -5 2147483647 -2147483648");
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+#include <fs/utility/substring_patterns.hpp>
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// reference implementation: quadratic
+bool contains_other(const std::vector<std::string>& patterns, const std::string& pattern)
+{
+	return std::any_of(patterns.begin(), patterns.end(), [&](const std::string& other) {
+		return other != pattern && pattern.find(other) != std::string::npos;
+	});
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(substring_patterns_suite)
+
+	BOOST_AUTO_TEST_CASE(removes_duplicates_and_superstrings)
+	{
+		std::vector<std::string> patterns = {
+			"Sapphire Ring", "Ring", "Vaal Regalia", "Ring", "Two-Stone Ring", "Regal", "Onyx Amulet", "Amulet of Ring"
+		};
+		fs::utility::minimize_substring_patterns(patterns);
+		BOOST_TEST(patterns == (std::vector<std::string>{"Onyx Amulet", "Regal", "Ring"}), boost::test_tools::per_element());
+	}
+
+	BOOST_AUTO_TEST_CASE(keeps_unrelated_patterns)
+	{
+		std::vector<std::string> patterns = {"ab", "ba", "abc", "bca", "c"};
+		fs::utility::minimize_substring_patterns(patterns);
+		BOOST_TEST(patterns == (std::vector<std::string>{"ab", "ba", "c"}), boost::test_tools::per_element());
+
+		std::vector<std::string> single = {"x", "x"};
+		fs::utility::minimize_substring_patterns(single);
+		BOOST_TEST(single == std::vector<std::string>{"x"}, boost::test_tools::per_element());
+	}
+
+	BOOST_AUTO_TEST_CASE(empty_pattern_matches_everything)
+	{
+		std::vector<std::string> patterns = {"Ring", "", "Amulet"};
+		fs::utility::minimize_substring_patterns(patterns);
+		BOOST_TEST(patterns == std::vector<std::string>{""}, boost::test_tools::per_element());
+	}
+
+	BOOST_AUTO_TEST_CASE(same_result_as_quadratic_search)
+	{
+		// all strings of length 1-4 over a 3-letter alphabet, in a scrambled order
+		std::vector<std::string> all;
+		for (std::size_t length = 1; length <= 4; ++length) {
+			std::string str(length, 'a');
+			while (true) {
+				all.push_back(str);
+				std::size_t i = 0;
+				while (i < length && str[i] == 'c')
+					str[i++] = 'a';
+
+				if (i == length)
+					break;
+
+				++str[i];
+			}
+		}
+
+		for (std::size_t step = 3; step < 40; step += 7) {
+			std::vector<std::string> patterns;
+			for (std::size_t i = 0; i < all.size(); i += step)
+				patterns.push_back(all[(i * 31) % all.size()]);
+
+			std::vector<std::string> expected;
+			for (const std::string& pattern : patterns)
+				if (!contains_other(patterns, pattern))
+					expected.push_back(pattern);
+
+			std::sort(expected.begin(), expected.end());
+			expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+			fs::utility::minimize_substring_patterns(patterns);
+			BOOST_TEST(patterns == expected, boost::test_tools::per_element());
+		}
+	}
+
+BOOST_AUTO_TEST_SUITE_END()